@@ -3,4 +3,6 @@
 #include "Arcorox.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogArcorox);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Arcorox, "Arcorox" );
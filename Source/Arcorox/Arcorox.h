@@ -3,6 +3,11 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("Arcorox"), STATGROUP_Arcorox, STATCAT_Advanced);
+
+DECLARE_LOG_CATEGORY_EXTERN(LogArcorox, Log, All);
 
 #define EPS_Metal EPhysicalSurface::SurfaceType1
 #define EPS_Stone EPhysicalSurface::SurfaceType2
@@ -0,0 +1,184 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Audio/CombatAudioSubsystem.h"
+#include "Components/AudioComponent.h"
+#include "Sound/SoundBase.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sounds Requested"), STAT_SoundsRequested, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sounds Played"), STAT_SoundsPlayed, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sounds Merged"), STAT_SoundsMerged, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sounds Throttled"), STAT_SoundsThrottled, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sounds Voice Limited"), STAT_SoundsVoiceLimited, STATGROUP_Arcorox);
+
+static FCombatSoundCategorySettings MakeCategory(int32 MaxVoices, float Priority, float MinInterval, float MergeRadius, bool bStealOldest)
+{
+	FCombatSoundCategorySettings Category;
+	Category.MaxVoices = MaxVoices;
+	Category.Priority = Priority;
+	Category.MinInterval = MinInterval;
+	Category.MergeRadius = MergeRadius;
+	Category.bStealOldest = bStealOldest;
+	return Category;
+}
+
+static void LogCombatAudio(UWorld* World)
+{
+	if (UCombatAudioSubsystem* CombatAudio = World ? World->GetSubsystem<UCombatAudioSubsystem>() : nullptr) CombatAudio->LogAudioReport();
+}
+
+static FAutoConsoleCommandWithWorld LogCombatAudioCommand(
+	TEXT("arcorox.Audio.Report"),
+	TEXT("Logs requested versus played combat sounds and the active voices per category."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&LogCombatAudio));
+
+UCombatAudioSubsystem::UCombatAudioSubsystem() :
+	MaxVoicesTotal(24),
+	FrameSoundsFrame(0),
+	NumRequested(0),
+	NumPlayed(0)
+{
+	//Defaults indexed by ECombatSoundCategory, overridable from the [/Script/Arcorox.CombatAudioSubsystem] section of DefaultGame.ini
+	Categories.Add(MakeCategory(6, 1.f, 0.f, 0.f, true));
+	Categories.Add(MakeCategory(8, 0.5f, 0.f, 200.f, false));
+	Categories.Add(MakeCategory(4, 0.8f, 0.f, 200.f, false));
+	Categories.Add(MakeCategory(4, 2.f, 0.f, 500.f, true));
+	Categories.Add(MakeCategory(2, 0.3f, 0.2f, 0.f, false));
+	Categories.Add(MakeCategory(2, 0.3f, 0.2f, 0.f, false));
+
+	Voices.SetNum(static_cast<int32>(ECombatSoundCategory::ECSC_MAX));
+	LastPlayTimes.Init(-BIG_NUMBER, static_cast<int32>(ECombatSoundCategory::ECSC_MAX));
+}
+
+void UCombatAudioSubsystem::Deinitialize()
+{
+	for (TArray<FCombatVoice>& CategoryVoices : Voices) CategoryVoices.Empty();
+	FrameSounds.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatAudioSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UCombatAudioSubsystem::PlayCombatSoundAtLocation(const UObject* WorldContextObject, ECombatSoundCategory Category, USoundBase* Sound, const FVector& Location)
+{
+	if (Sound == nullptr || WorldContextObject == nullptr) return false;
+	UWorld* World = WorldContextObject->GetWorld();
+	UCombatAudioSubsystem* CombatAudio = World ? World->GetSubsystem<UCombatAudioSubsystem>() : nullptr;
+	if (CombatAudio) return CombatAudio->PlayCombatSound(Category, Sound, Location, false);
+	UGameplayStatics::PlaySoundAtLocation(WorldContextObject, Sound, Location);
+	return true;
+}
+
+bool UCombatAudioSubsystem::PlayCombatSound2D(const UObject* WorldContextObject, ECombatSoundCategory Category, USoundBase* Sound, bool bIgnoreThrottle)
+{
+	if (Sound == nullptr || WorldContextObject == nullptr) return false;
+	UWorld* World = WorldContextObject->GetWorld();
+	UCombatAudioSubsystem* CombatAudio = World ? World->GetSubsystem<UCombatAudioSubsystem>() : nullptr;
+	if (CombatAudio) return CombatAudio->PlayCombatSound(Category, Sound, FVector::ZeroVector, true, bIgnoreThrottle);
+	UGameplayStatics::PlaySound2D(WorldContextObject, Sound);
+	return true;
+}
+
+bool UCombatAudioSubsystem::PlayCombatSound(ECombatSoundCategory Category, USoundBase* Sound, const FVector& Location, bool b2D, bool bIgnoreThrottle)
+{
+	const int32 CategoryIndex = static_cast<int32>(Category);
+	if (Sound == nullptr || !Voices.IsValidIndex(CategoryIndex)) return false;
+	NumRequested++;
+	INC_DWORD_STAT(STAT_SoundsRequested);
+	const FCombatSoundCategorySettings Settings{ Categories.IsValidIndex(CategoryIndex) ? Categories[CategoryIndex] : FCombatSoundCategorySettings() };
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	//Identical cues from the same frame, like a crowd taking one shotgun blast, play once
+	if (FrameSoundsFrame != GFrameCounter)
+	{
+		FrameSounds.Reset();
+		FrameSoundsFrame = GFrameCounter;
+	}
+	const float MergeRadiusSquared = FMath::Square(Settings.MergeRadius);
+	for (const FFrameSound& FrameSound : FrameSounds)
+	{
+		if (FrameSound.Sound != Sound || FVector::DistSquared(FrameSound.Location, Location) > MergeRadiusSquared) continue;
+		INC_DWORD_STAT(STAT_SoundsMerged);
+		return false;
+	}
+
+	if (!bIgnoreThrottle && Settings.MinInterval > 0.f && Now - LastPlayTimes[CategoryIndex] < Settings.MinInterval)
+	{
+		INC_DWORD_STAT(STAT_SoundsThrottled);
+		return false;
+	}
+
+	int32 NumVoices = 0;
+	for (int32 i = 0; i < Voices.Num(); i++)
+	{
+		PruneVoices(i);
+		NumVoices += Voices[i].Num();
+	}
+	TArray<FCombatVoice>& CategoryVoices = Voices[CategoryIndex];
+	if (CategoryVoices.Num() >= Settings.MaxVoices)
+	{
+		if (!Settings.bStealOldest || CategoryVoices.Num() == 0)
+		{
+			INC_DWORD_STAT(STAT_SoundsVoiceLimited);
+			return false;
+		}
+		if (UAudioComponent* Oldest = CategoryVoices[0].Component.Get()) Oldest->Stop();
+		CategoryVoices.RemoveAt(0, 1, false);
+		NumVoices--;
+	}
+	if (NumVoices >= MaxVoicesTotal && !StealVoice(Settings.Priority))
+	{
+		INC_DWORD_STAT(STAT_SoundsVoiceLimited);
+		return false;
+	}
+
+	UAudioComponent* Component = b2D ? UGameplayStatics::SpawnSound2D(this, Sound) : UGameplayStatics::SpawnSoundAtLocation(this, Sound, Location);
+	if (Component == nullptr) return false;
+	CategoryVoices.Add(FCombatVoice{ Component, Now });
+	LastPlayTimes[CategoryIndex] = Now;
+	FrameSounds.Add(FFrameSound{ Sound, Location });
+	NumPlayed++;
+	INC_DWORD_STAT(STAT_SoundsPlayed);
+	return true;
+}
+
+void UCombatAudioSubsystem::PruneVoices(int32 CategoryIndex)
+{
+	Voices[CategoryIndex].RemoveAll([](const FCombatVoice& Voice) { return !Voice.Component.IsValid() || !Voice.Component->IsPlaying(); });
+}
+
+bool UCombatAudioSubsystem::StealVoice(float Priority)
+{
+	int32 VictimCategory = INDEX_NONE;
+	float VictimPriority = Priority;
+	for (int32 i = 0; i < Voices.Num(); i++)
+	{
+		const float CategoryPriority = Categories.IsValidIndex(i) ? Categories[i].Priority : 0.f;
+		if (Voices[i].Num() == 0 || CategoryPriority >= VictimPriority) continue;
+		VictimCategory = i;
+		VictimPriority = CategoryPriority;
+	}
+	if (VictimCategory == INDEX_NONE) return false;
+	if (UAudioComponent* Oldest = Voices[VictimCategory][0].Component.Get()) Oldest->Stop();
+	Voices[VictimCategory].RemoveAt(0);
+	return true;
+}
+
+void UCombatAudioSubsystem::LogAudioReport() const
+{
+	const UEnum* CategoryEnum = StaticEnum<ECombatSoundCategory>();
+	UE_LOG(LogArcorox, Display, TEXT("Combat sounds requested: %llu, played: %llu"), NumRequested, NumPlayed);
+	for (int32 i = 0; i < Voices.Num(); i++)
+	{
+		const int32 MaxVoices = Categories.IsValidIndex(i) ? Categories[i].MaxVoices : 0;
+		UE_LOG(LogArcorox, Display, TEXT("  %s: %d / %d voices"), *CategoryEnum->GetDisplayNameTextByIndex(i).ToString(), Voices[i].Num(), MaxVoices);
+	}
+}
@@ -6,6 +6,20 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Items/Weapon.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Player Anim Game Thread"), STAT_PlayerAnimGameThread, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<bool> CVarAnimThreadSafeUpdate(
+	TEXT("arcorox.Anim.ThreadSafeUpdate"),
+	true,
+	TEXT("Derive player and enemy animation properties in the thread safe update on worker threads (1) or on the game thread (0)."));
+
+//Curves are keyed by name, constructing the names once keeps the lookup off the name table
+static const FName TurningCurveName(TEXT("Turning"));
+static const FName RotationCurveName(TEXT("Rotation"));
 
 UArcoroxAnimInstance::UArcoroxAnimInstance() :
 	Speed(0.f),
@@ -29,7 +43,8 @@ UArcoroxAnimInstance::UArcoroxAnimInstance() :
 	RecoilScale(1.f),
 	bTurningInPlace(false),
 	EquippedWeaponType(EWeaponType::EWT_SubmachineGun),
-	bShouldUseFABRIK(true)
+	bShouldUseFABRIK(true),
+	bUpdatedOnGameThread(false)
 {
 
 }
@@ -49,30 +64,55 @@ void UArcoroxAnimInstance::NativeUpdateAnimation(float DeltaTime)
 {
 	Super::NativeUpdateAnimation(DeltaTime);
 
-	if (ArcoroxCharacter && ArcoroxCharacterMovement)
+	SCOPE_CYCLE_COUNTER(STAT_PlayerAnimGameThread);
+	Snapshot.bValid = ArcoroxCharacter && ArcoroxCharacterMovement;
+	if (Snapshot.bValid) ArcoroxCharacter->FillAnimSnapshot(Snapshot);
+	bUpdatedOnGameThread = !IsThreadSafeUpdateEnabled();
+	if (bUpdatedOnGameThread) UpdateFromSnapshot(DeltaTime);
+}
+
+void UArcoroxAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaTime)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaTime);
+
+	if (!bUpdatedOnGameThread) UpdateFromSnapshot(DeltaTime);
+}
+
+bool UArcoroxAnimInstance::IsThreadSafeUpdateEnabled()
+{
+	return CVarAnimThreadSafeUpdate.GetValueOnAnyThread();
+}
+
+float UArcoroxAnimInstance::GetCurveValueAnyThread(const FName& CurveName) const
+{
+	const float* Value = GetProxyOnAnyThread<FAnimInstanceProxy>().GetAnimationCurves(EAnimCurveType::AttributeCurve).Find(CurveName);
+	return Value ? *Value : 0.f;
+}
+
+void UArcoroxAnimInstance::UpdateFromSnapshot(float DeltaTime)
+{
+	if (Snapshot.bValid)
 	{
-		Speed = UKismetMathLibrary::VSizeXY(ArcoroxCharacterMovement->Velocity);
-		bIsFalling = ArcoroxCharacterMovement->IsFalling();
-		bIsAccelerating = ArcoroxCharacterMovement->GetCurrentAcceleration().Size() > 0.f;
-		bCrouching = ArcoroxCharacter->IsCrouching();
-		ECombatState CombatState = ArcoroxCharacter->GetCombatState();
-		bShouldUseFABRIK = CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_Firing;
-
-		FRotator AimRotation = ArcoroxCharacter->GetBaseAimRotation();
-		FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX(ArcoroxCharacter->GetVelocity());
-		MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, AimRotation).Yaw;
-		if (ArcoroxCharacter->GetVelocity().Size() > 0) LastMovementOffsetYaw = MovementOffsetYaw;
-
-		bReloading = CombatState == ECombatState::ECS_Reloading;
-		bAiming = ArcoroxCharacter->IsAiming();
-		bEquipping = CombatState == ECombatState::ECS_Equipping;
+		Speed = UKismetMathLibrary::VSizeXY(Snapshot.Velocity);
+		bIsFalling = Snapshot.bFalling;
+		bIsAccelerating = Snapshot.Acceleration.Size() > 0.f;
+		bCrouching = Snapshot.bCrouching;
+		bShouldUseFABRIK = Snapshot.bShouldUseFABRIK;
+
+		FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX(Snapshot.Velocity);
+		MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, Snapshot.AimRotation).Yaw;
+		if (Snapshot.Velocity.Size() > 0) LastMovementOffsetYaw = MovementOffsetYaw;
+
+		bReloading = Snapshot.bReloading;
+		bAiming = Snapshot.bAiming;
+		bEquipping = Snapshot.bEquipping;
 
 		if (bReloading) OffsetState = EOffsetState::EOS_Reloading;
 		else if (bIsFalling) OffsetState = EOffsetState::EOS_InAir;
 		else if (bAiming) OffsetState = EOffsetState::EOS_Aiming;
 		else OffsetState = EOffsetState::EOS_Hip;
 
-		if (ArcoroxCharacter->GetEquippedWeapon()) EquippedWeaponType = ArcoroxCharacter->GetEquippedWeapon()->GetWeaponType();
+		if (Snapshot.bHasWeapon) EquippedWeaponType = Snapshot.EquippedWeaponType;
 	}
 	TurnInPlace();
 	Lean(DeltaTime);
@@ -80,12 +120,12 @@ void UArcoroxAnimInstance::NativeUpdateAnimation(float DeltaTime)
 
 void UArcoroxAnimInstance::TurnInPlace()
 {
-	if (ArcoroxCharacter == nullptr || ArcoroxCharacterMovement == nullptr) return;
-	Pitch = ArcoroxCharacter->GetBaseAimRotation().Pitch;
+	if (!Snapshot.bValid) return;
+	Pitch = Snapshot.AimRotation.Pitch;
 	if (Speed > 0 || bIsFalling)
 	{
 		RootYawOffset = 0.f;
-		TIPCharacterRotationYaw = ArcoroxCharacter->GetActorRotation().Yaw;
+		TIPCharacterRotationYaw = Snapshot.ActorRotation.Yaw;
 		TIPCharacterRotationYawLastFrame = TIPCharacterRotationYaw;
 		RotationCurveLastFrame = 0.f;
 		RotationCurve = 0.f;
@@ -93,16 +133,16 @@ void UArcoroxAnimInstance::TurnInPlace()
 	else
 	{
 		TIPCharacterRotationYawLastFrame = TIPCharacterRotationYaw;
-		TIPCharacterRotationYaw = ArcoroxCharacter->GetActorRotation().Yaw;
+		TIPCharacterRotationYaw = Snapshot.ActorRotation.Yaw;
 		const float TIPDeltaYaw{ TIPCharacterRotationYaw - TIPCharacterRotationYawLastFrame };
 		//Clamp RootYawOffset between [-180, 180]
 		RootYawOffset = UKismetMathLibrary::NormalizeAxis(RootYawOffset - TIPDeltaYaw);
-		const float Turning{ GetCurveValue(TEXT("Turning")) };
+		const float Turning{ GetCurveValueAnyThread(TurningCurveName) };
 		if (Turning > 0)
 		{
 			bTurningInPlace = true;
 			RotationCurveLastFrame = RotationCurve;
-			RotationCurve = GetCurveValue(TEXT("Rotation"));
+			RotationCurve = GetCurveValueAnyThread(RotationCurveName);
 			const float DeltaRotation{ RotationCurve - RotationCurveLastFrame };
 			//RootYawOffset > 0  Turning Left, otherwise  Turning Right
 			RootYawOffset > 0 ? RootYawOffset -= DeltaRotation : RootYawOffset += DeltaRotation;
@@ -120,9 +160,9 @@ void UArcoroxAnimInstance::TurnInPlace()
 
 void UArcoroxAnimInstance::Lean(float DeltaTime)
 {
-	if (ArcoroxCharacter == nullptr || ArcoroxCharacterMovement == nullptr) return;
+	if (!Snapshot.bValid) return;
 	CharacterRotationLastFrame = CharacterRotation;
-	CharacterRotation = ArcoroxCharacter->GetActorRotation();
+	CharacterRotation = Snapshot.ActorRotation;
 	const FRotator DeltaRotation{ UKismetMathLibrary::NormalizedDeltaRotator(CharacterRotation, CharacterRotationLastFrame) };
 	const float Target = DeltaRotation.Yaw / DeltaTime;
 	const float Interpolation{ FMath::FInterpTo<float>(DeltaYaw, Target, DeltaTime, 1.f) };
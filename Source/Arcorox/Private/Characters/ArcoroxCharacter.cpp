@@ -2,6 +2,7 @@
 
 
 #include "Characters/ArcoroxCharacter.h"
+#include "Characters/ArcoroxAnimInstance.h"
 #include "Items/Item.h"
 #include "Items/Weapon.h"
 #include "Items/Ammo.h"
@@ -21,6 +22,18 @@
 #include "Enemy/Enemy.h"
 #include "Enemy/EnemyController.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "Combat/HitscanSubsystem.h"
+#include "Combat/CombatDamageSubsystem.h"
+#include "Combat/ProjectileSubsystem.h"
+#include "Explosive/Explosive.h"
+#include "Items/LootIndexSubsystem.h"
+#include "Items/PickupPoolSubsystem.h"
+#include "HUD/ArcoroxHUD.h"
+#include "Effects/CombatFXSubsystem.h"
+#include "Audio/CombatAudioSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Crosshair Query"), STAT_CrosshairQuery, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair Traces"), STAT_CrosshairTraces, STATGROUP_Arcorox);
 
 AArcoroxCharacter::AArcoroxCharacter() :
 	//Is Aiming
@@ -46,7 +59,9 @@ AArcoroxCharacter::AArcoroxCharacter() :
 	//Automatic weapon fire
 	bShouldFire(true),
 	bFireButtonPressed(false),
-	bShouldTraceForItems(false),
+	//Item focus
+	ItemFocusRadius(250.f),
+	ItemFocusConeAngle(10.f),
 	//Camera interp location variables
 	CameraInterpDistance(200.f),
 	CameraInterpElevation(50.f),
@@ -66,11 +81,6 @@ AArcoroxCharacter::AArcoroxCharacter() :
 	//Ground friction
 	DefaultGroundFriction(2.f),
 	CrouchingGroundFriction(100.f),
-	//Sound timer properties
-	bShouldPlayPickupSound(true),
-	bShouldPlayEquipSound(true),
-	PickupSoundTime(0.2f),
-	EquipSoundTime(0.2f),
 	//Highlight Icon animation property
 	HighlightedInventorySlot(-1),
 	//Health
@@ -211,19 +221,26 @@ float AArcoroxCharacter::TakeDamage(float DamageAmount, FDamageEvent const& Dama
 		Health = 0.f;
 		Die();
 		AEnemyController* EnemyController = Cast<AEnemyController>(EventInstigator);
-		if (EnemyController && EnemyController->GetBlackboardComponent())
-		{
-			EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("PlayerDead"), true);
-		}
+		if (EnemyController) EnemyController->SetPlayerDead(true);
 	}
 	else Health -= DamageAmount;
 	return DamageAmount;
 }
 
-void AArcoroxCharacter::IncrementOverlappedItemCount(int8 Amount)
+void AArcoroxCharacter::FillAnimSnapshot(FArcoroxAnimSnapshot& OutSnapshot) const
 {
-	OverlappedItemCount += Amount;
-	bShouldTraceForItems = OverlappedItemCount > 0;
+	OutSnapshot.Velocity = GetCharacterMovement()->Velocity;
+	OutSnapshot.Acceleration = GetCharacterMovement()->GetCurrentAcceleration();
+	OutSnapshot.bFalling = GetCharacterMovement()->IsFalling();
+	OutSnapshot.AimRotation = GetBaseAimRotation();
+	OutSnapshot.ActorRotation = GetActorRotation();
+	OutSnapshot.bCrouching = bCrouching;
+	OutSnapshot.bAiming = bAiming;
+	OutSnapshot.bReloading = CombatState == ECombatState::ECS_Reloading;
+	OutSnapshot.bEquipping = CombatState == ECombatState::ECS_Equipping;
+	OutSnapshot.bShouldUseFABRIK = CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_Firing;
+	OutSnapshot.bHasWeapon = EquippedWeapon != nullptr;
+	if (EquippedWeapon) OutSnapshot.EquippedWeaponType = EquippedWeapon->GetWeaponType();
 }
 
 void AArcoroxCharacter::GetPickupItem(AItem* Item)
@@ -260,18 +277,6 @@ void AArcoroxCharacter::DecrementInterpLocationItemCount(int32 Index)
 	if (InterpLocations.Num() >= Index) InterpLocations[Index].ItemCount--;
 }
 
-void AArcoroxCharacter::StartPickupSoundTimer()
-{
-	bShouldPlayPickupSound = false;
-	GetWorldTimerManager().SetTimer(PickupSoundTimer, this, &AArcoroxCharacter::ResetPickupSoundTimer, PickupSoundTime);
-}
-
-void AArcoroxCharacter::StartEquipSoundTimer()
-{
-	bShouldPlayEquipSound = false;
-	GetWorldTimerManager().SetTimer(EquipSoundTimer, this, &AArcoroxCharacter::ResetEquipSoundTimer, EquipSoundTime);
-}
-
 float AArcoroxCharacter::GetCrosshairSpreadMultiplier() const
 {
 	return CrosshairSpreadMultiplier;
@@ -279,12 +284,12 @@ float AArcoroxCharacter::GetCrosshairSpreadMultiplier() const
 
 void AArcoroxCharacter::PlayMeleeImpactSound()
 {
-	if (MeleeImpactSound) UGameplayStatics::PlaySoundAtLocation(this, MeleeImpactSound, GetActorLocation());
+	UCombatAudioSubsystem::PlayCombatSoundAtLocation(this, ECombatSoundCategory::ECSC_Melee, MeleeImpactSound, GetActorLocation());
 }
 
 void AArcoroxCharacter::SpawnBloodParticles(const FTransform& SocketTransform)
 {
-	if (BloodParticles) UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BloodParticles, SocketTransform);
+	UCombatFXSubsystem::SpawnEffectAt(this, ECombatFXType::ECFX_Blood, BloodParticles, SocketTransform);
 }
 
 void AArcoroxCharacter::Stun(const FHitResult& HitResult)
@@ -463,67 +468,67 @@ void AArcoroxCharacter::FiveKeyPressed()
 	ExchangeInventoryItems(EquippedWeapon->GetInventorySlotIndex(), 5);
 }
 
-bool AArcoroxCharacter::GetBeamEndLocation(const FVector& BarrelSocketLocation, FHitResult& OutHit)
-{
-	FVector OutBeamLocation;
-	//Check for crosshair trace hit
-	FHitResult CrosshairHitResult;
-	if (CrosshairLineTrace(CrosshairHitResult, OutBeamLocation))
-	{
-		OutBeamLocation = CrosshairHitResult.Location;
-	}
-	//Perform line trace from weapon barrel
-	const FVector WeaponTraceStart{ BarrelSocketLocation };
-	const FVector StartToEnd{ OutBeamLocation - BarrelSocketLocation };
-	const FVector WeaponTraceEnd{ BarrelSocketLocation + StartToEnd * 1.25f };
-	GetWorld()->LineTraceSingleByChannel(OutHit, WeaponTraceStart, WeaponTraceEnd, ECollisionChannel::ECC_Visibility);
-	if (!OutHit.bBlockingHit) //No object between weapon barrel and beam end point?
-	{
-		OutHit.Location = OutBeamLocation;
-		return false;
-	}
-	return true;
-}
-
 void AArcoroxCharacter::SendBullet()
 {
 	const USkeletalMeshSocket* BarrelSocket = EquippedWeapon->GetItemMesh()->GetSocketByName("BarrelSocket");
 	if (BarrelSocket)
 	{
 		const FTransform SocketTransform = BarrelSocket->GetSocketTransform(EquippedWeapon->GetItemMesh());
-		FHitResult BeamHitResult;
 		SpawnMuzzleFlash(SocketTransform);
-		if (GetBeamEndLocation(SocketTransform.GetLocation(), BeamHitResult))
+		UHitscanSubsystem* HitscanSubsystem = GetWorld()->GetSubsystem<UHitscanSubsystem>();
+		const FCrosshairQuery& Query = GetCrosshairQuery();
+		if (HitscanSubsystem && Query.bValid)
 		{
-			if (BeamHitResult.GetActor())
-			{
-				//Does the hit Actor implement the HitInterface
-				IHitInterface* HitInterface = Cast<IHitInterface>(BeamHitResult.GetActor());
-				if (HitInterface) HitInterface->Hit_Implementation(BeamHitResult);
-				else
-				{
-					SpawnImpactParticles(BeamHitResult.Location);
-					SpawnBeamParticles(SocketTransform, BeamHitResult.Location);
-				}
-				//Is the hit Actor an Enemy
-				AEnemy* Enemy = Cast<AEnemy>(BeamHitResult.GetActor());
-				if (Enemy)
-				{
-					float Damage = EquippedWeapon->GetDamage();
-					bool bHeadshot = false;
-					if (BeamHitResult.BoneName.ToString().Equals(Enemy->GetHeadBone()))
-					{
-						bHeadshot = true;
-						Damage *= EquippedWeapon->GetHeadshotMultiplier();
-					}
-					UGameplayStatics::ApplyDamage(BeamHitResult.GetActor(), Damage, GetController(), this, UDamageType::StaticClass());
-					Enemy->ShowHitDamage(Damage, BeamHitResult.Location, bHeadshot);
-				}
-			}
+			//Projectile weapons fall back to hitscan when the projectile limit is reached
+			UProjectileSubsystem* ProjectileSubsystem = EquippedWeapon->FiresProjectiles() ? GetWorld()->GetSubsystem<UProjectileSubsystem>() : nullptr;
+			if (ProjectileSubsystem && ProjectileSubsystem->FireProjectile(this, SocketTransform, Query.HitLocation, EquippedWeapon->GetDamage(), EquippedWeapon->GetHitZoneMultipliers(), EquippedWeapon->GetWeaponArchetype())) return;
+			FHitscanShot Shot;
+			Shot.Shooter = this;
+			Shot.SocketTransform = SocketTransform;
+			Shot.BeamEnd = Query.HitLocation;
+			Shot.Damage = EquippedWeapon->GetDamage();
+			Shot.ZoneMultipliers = EquippedWeapon->GetHitZoneMultipliers();
+			HitscanSubsystem->QueueShot(Shot);
 		}
 	}
 }
 
+void AArcoroxCharacter::ApplyBulletHit(const FTransform& SocketTransform, const FHitResult& BeamHitResult, float Damage, const FHitZoneMultipliers& ZoneMultipliers)
+{
+	AActor* HitActor = BeamHitResult.GetActor();
+	if (HitActor == nullptr) return;
+	//Enemies are most of the hits at high fire volume, checked first so they skip the interface cast
+	AEnemy* Enemy = Cast<AEnemy>(HitActor);
+	if (Enemy == nullptr)
+	{
+		//Does the hit Actor implement the HitInterface
+		IHitInterface* HitInterface = Cast<IHitInterface>(HitActor);
+		//Credits the blast and any chain it sets off to the shooter
+		if (AExplosive* Explosive = Cast<AExplosive>(HitActor)) Explosive->SetInstigator(this);
+		if (HitInterface) HitInterface->Hit_Implementation(BeamHitResult);
+		else
+		{
+			SpawnImpactParticles(BeamHitResult.Location);
+			SpawnBeamParticles(SocketTransform, BeamHitResult.Location);
+		}
+		return;
+	}
+
+	Enemy->Hit_Implementation(BeamHitResult);
+	EHitZone HitZone;
+	Damage *= Enemy->GetHitZoneMultiplier(BeamHitResult.BoneName, ZoneMultipliers, HitZone);
+	const bool bHeadshot = HitZone == EHitZone::EHZ_Head;
+	UCombatDamageSubsystem* CombatDamage = Enemy->UsesBatchedDamage() ? GetWorld()->GetSubsystem<UCombatDamageSubsystem>() : nullptr;
+	if (CombatDamage == nullptr || !CombatDamage->QueuePointDamage(Enemy->GetHealthSlot(), Damage, this, BeamHitResult.Location))
+	{
+		UGameplayStatics::ApplyDamage(Enemy, Damage, GetController(), this, UDamageType::StaticClass());
+	}
+	APlayerController* PlayerController = Cast<APlayerController>(GetController());
+	AArcoroxHUD* ArcoroxHUD = PlayerController ? PlayerController->GetHUD<AArcoroxHUD>() : nullptr;
+	//Enemy Blueprints still show their own damage numbers until the HUD has a damage number class
+	if (ArcoroxHUD == nullptr || !ArcoroxHUD->AddDamageNumber(Damage, BeamHitResult.Location, bHeadshot)) Enemy->ShowHitDamage(Damage, BeamHitResult.Location, bHeadshot);
+}
+
 void AArcoroxCharacter::ExchangeInventoryItems(int32 CurrentSlotIndex, int32 TargetSlotIndex)
 {
 	const bool CannotExchangeItems = ((CombatState != ECombatState::ECS_Unoccupied && CombatState != ECombatState::ECS_Equipping) || EquippedWeapon == nullptr || CurrentSlotIndex == TargetSlotIndex || TargetSlotIndex >= Inventory.Num());
@@ -538,30 +543,44 @@ void AArcoroxCharacter::ExchangeInventoryItems(int32 CurrentSlotIndex, int32 Tar
 	PlayEquipMontage();
 }
 
-bool AArcoroxCharacter::CrosshairLineTrace(FHitResult& OutHit, FVector& OutHitLocation)
+bool AArcoroxCharacter::GetCrosshairRay(FVector& OutStart, FVector& OutDirection)
 {
 	//Get size of viewport
 	FVector2D ViewportSize;
 	if (GEngine && GEngine->GameViewport) GEngine->GameViewport->GetViewportSize(ViewportSize);
 	//Get screen space location of crosshairs
 	FVector2D CrosshairLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
-	FVector CrosshairWorldPosition, CrosshairWorldDirection;
 	//Get crosshairs world position and direction
-	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0), CrosshairLocation, CrosshairWorldPosition, CrosshairWorldDirection);
-	if (bScreenToWorld) //was deprojection successful
-	{
-		//Trace outward from crosshair location
-		const FVector Start{ CrosshairWorldPosition };
-		const FVector End{ Start + CrosshairWorldDirection * 50000 };
-		OutHitLocation = End;
-		GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECollisionChannel::ECC_Visibility);
-		if (OutHit.bBlockingHit)
-		{
-			OutHitLocation = OutHit.Location;
-			return true;
-		}
-	}
-	return false;
+	return UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0), CrosshairLocation, OutStart, OutDirection);
+}
+
+const FCrosshairQuery& AArcoroxCharacter::GetCrosshairQuery()
+{
+	//Reuse the query from this frame, or the one refreshed after last frame's camera update
+	const bool bComputedThisFrame = CrosshairQuery.FrameNumber == GFrameCounter;
+	const bool bComputedAfterLastCameraUpdate = CrosshairQuery.bAfterCameraUpdate && CrosshairQuery.FrameNumber + 1 == GFrameCounter;
+	if (!bComputedThisFrame && !bComputedAfterLastCameraUpdate) UpdateCrosshairQuery(false);
+	return CrosshairQuery;
+}
+
+void AArcoroxCharacter::UpdateCrosshairQuery(bool bAfterCameraUpdate)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CrosshairQuery);
+	INC_DWORD_STAT(STAT_CrosshairTraces);
+	CrosshairQuery.FrameNumber = GFrameCounter;
+	CrosshairQuery.bAfterCameraUpdate = bAfterCameraUpdate;
+	CrosshairQuery.HitResult = FHitResult();
+	CrosshairQuery.bValid = GetCrosshairRay(CrosshairQuery.Start, CrosshairQuery.Direction);
+	if (!CrosshairQuery.bValid) return;
+	//Trace outward from crosshair location
+	const FVector End{ CrosshairQuery.Start + CrosshairQuery.Direction * 50000 };
+	GetWorld()->LineTraceSingleByChannel(CrosshairQuery.HitResult, CrosshairQuery.Start, End, ECollisionChannel::ECC_Visibility);
+	CrosshairQuery.HitLocation = CrosshairQuery.HitResult.bBlockingHit ? FVector(CrosshairQuery.HitResult.Location) : End;
+}
+
+bool AArcoroxCharacter::NeedsCrosshairQuery() const
+{
+	return bFireButtonPressed;
 }
 
 void AArcoroxCharacter::CalculateCrosshairSpread(float DeltaTime)
@@ -586,47 +605,31 @@ void AArcoroxCharacter::CalculateCrosshairSpread(float DeltaTime)
 
 void AArcoroxCharacter::ItemTrace()
 {
-	if (bShouldTraceForItems)
+	ULootIndexSubsystem* LootIndex = GetWorld()->GetSubsystem<ULootIndexSubsystem>();
+	if (LootIndex == nullptr || GetCamera() == nullptr) return;
+	//Cone query along the crosshairs against pickups near the character
+	TraceHitItem = LootIndex->FindFocusItem(GetActorLocation(), ItemFocusRadius, GetCamera()->GetComponentLocation(), GetCamera()->GetForwardVector(), ItemFocusConeAngle, this);
+	const AWeapon* TraceHitWeapon = Cast<AWeapon>(TraceHitItem);
+	if (TraceHitWeapon)
 	{
-		FHitResult ItemTraceResult;
-		FVector HitLocation;
-		if (CrosshairLineTrace(ItemTraceResult, HitLocation))
-		{
-			TraceHitItem = Cast<AItem>(ItemTraceResult.GetActor());
-			const AWeapon* TraceHitWeapon = Cast<AWeapon>(TraceHitItem);
-			if (TraceHitWeapon)
-			{
-				if (HighlightedInventorySlot == -1) HighlightInventorySlot();
-			}
-			else
-			{
-				if (HighlightedInventorySlot != -1) UnhighlightInventorySlot();
-			}
-			if (TraceHitItem && TraceHitItem->GetItemState() == EItemState::EIS_EquipInterpolating) TraceHitItem = nullptr;
-			if (TraceHitItem)
-			{
-				TraceHitItem->ShowPickupWidget();
-				TraceHitItem->EnableCustomDepth();
-				TraceHitItem->SetCharacterInventoryFull(Inventory.Num() >= InventoryCapacity);
-			}
-			
-			if (TraceHitItemLastFrame)
-			{
-				if (TraceHitItem != TraceHitItemLastFrame)
-				{
-					TraceHitItemLastFrame->HidePickupWidget();
-					TraceHitItemLastFrame->DisableCustomDepth();
-				}
-			}
-			TraceHitItemLastFrame = TraceHitItem;
-		}
+		if (HighlightedInventorySlot == -1) HighlightInventorySlot();
+	}
+	else
+	{
+		if (HighlightedInventorySlot != -1) UnhighlightInventorySlot();
+	}
+	if (TraceHitItem)
+	{
+		TraceHitItem->ShowPickupWidget();
+		TraceHitItem->EnableCustomDepth();
+		TraceHitItem->SetCharacterInventoryFull(Inventory.Num() >= InventoryCapacity);
 	}
-	else if (TraceHitItemLastFrame)
+	if (TraceHitItemLastFrame && TraceHitItem != TraceHitItemLastFrame)
 	{
 		TraceHitItemLastFrame->HidePickupWidget();
 		TraceHitItemLastFrame->DisableCustomDepth();
-		TraceHitItemLastFrame = nullptr;
 	}
+	TraceHitItemLastFrame = TraceHitItem;
 }
 
 void AArcoroxCharacter::StartCrosshairShootTimer()
@@ -645,8 +648,10 @@ void AArcoroxCharacter::StartAutoFireTimer()
 AWeapon* AArcoroxCharacter::SpawnDefaultWeapon()
 {
 	UWorld* World = GetWorld();
-	if (World && DefaultWeaponClass) return World->SpawnActor<AWeapon>(DefaultWeaponClass);
-	return nullptr;
+	if (World == nullptr || DefaultWeaponClass == nullptr) return nullptr;
+	UPickupPoolSubsystem* PickupPool = World->GetSubsystem<UPickupPoolSubsystem>();
+	if (PickupPool) return Cast<AWeapon>(PickupPool->AcquirePickup(DefaultWeaponClass, GetActorTransform()));
+	return World->SpawnActor<AWeapon>(DefaultWeaponClass);
 }
 
 void AArcoroxCharacter::EquipWeapon(AWeapon* Weapon, bool bSwapping)
@@ -673,6 +678,7 @@ void AArcoroxCharacter::DropWeapon()
 		EquippedWeapon->GetItemMesh()->DetachFromComponent(DetachmentTransformRules);
 		EquippedWeapon->SetItemState(EItemState::EIS_Falling);
 		EquippedWeapon->ThrowWeapon();
+		if (UPickupPoolSubsystem* PickupPool = GetWorld()->GetSubsystem<UPickupPoolSubsystem>()) PickupPool->TrackLivePickup(EquippedWeapon);
 	}
 }
 
@@ -690,6 +696,18 @@ void AArcoroxCharacter::SwapWeapon(AWeapon* Weapon)
 	TraceHitItemLastFrame = nullptr;
 }
 
+#if !UE_BUILD_SHIPPING
+void AArcoroxCharacter::FillInventory()
+{
+	while (Inventory.Num() < InventoryCapacity)
+	{
+		AWeapon* Weapon = SpawnDefaultWeapon();
+		if (Weapon == nullptr) return;
+		GetPickupItem(Weapon);
+	}
+}
+#endif
+
 int32 AArcoroxCharacter::GetEmptyInventorySlot() const
 {
 	if (Inventory.Num() >= InventoryCapacity) return -1;
@@ -772,7 +790,9 @@ void AArcoroxCharacter::PickupAmmo(AAmmo* Ammo)
 	{
 		if (!WeaponHasAmmo()) ReloadWeapon();
 	}
-	Ammo->Destroy();
+	UPickupPoolSubsystem* PickupPool = GetWorld()->GetSubsystem<UPickupPoolSubsystem>();
+	if (PickupPool) PickupPool->ReleasePickup(Ammo);
+	else Ammo->Destroy();
 }
 
 void AArcoroxCharacter::InitializeInterpLocations()
@@ -898,26 +918,23 @@ void AArcoroxCharacter::EndStun()
 
 void AArcoroxCharacter::PlayFireSound()
 {
-	if (EquippedWeapon->GetFireSound()) UGameplayStatics::PlaySound2D(this, EquippedWeapon->GetFireSound());
+	UCombatAudioSubsystem::PlayCombatSound2D(this, ECombatSoundCategory::ECSC_WeaponFire, EquippedWeapon->GetFireSound());
 }
 
 void AArcoroxCharacter::SpawnMuzzleFlash(const FTransform& SocketTransform)
 {
-	if (EquippedWeapon->GetMuzzleFlash()) UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), EquippedWeapon->GetMuzzleFlash(), SocketTransform);
+	UCombatFXSubsystem::SpawnEffectAt(this, ECombatFXType::ECFX_MuzzleFlash, EquippedWeapon->GetMuzzleFlash(), SocketTransform);
 }
 
 void AArcoroxCharacter::SpawnImpactParticles(const FVector& BeamEnd)
 {
-	if (ImpactParticles) UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, BeamEnd);
+	UCombatFXSubsystem::SpawnEffectAt(this, ECombatFXType::ECFX_Impact, ImpactParticles, FTransform(BeamEnd));
 }
 
 void AArcoroxCharacter::SpawnBeamParticles(const FTransform& SocketTransform, const FVector& BeamEnd)
 {
-	if (BeamParticles)
-	{
-		UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BeamParticles, SocketTransform);
-		if (Beam) Beam->SetVectorParameter(FName("Target"), BeamEnd);
-	}
+	UParticleSystemComponent* Beam = UCombatFXSubsystem::SpawnEffectAt(this, ECombatFXType::ECFX_Beam, BeamParticles, SocketTransform);
+	if (Beam) Beam->SetVectorParameter(FName("Target"), BeamEnd);
 }
 
 void AArcoroxCharacter::PlayMontageSection(UAnimMontage* Montage, const FName& SectionName)
@@ -990,13 +1007,3 @@ void AArcoroxCharacter::SetLookScale()
 	if (bAiming) LookScale = AimingLookScale;
 	else LookScale = HipLookScale;
 }
-
-void AArcoroxCharacter::ResetPickupSoundTimer()
-{
-	bShouldPlayPickupSound = true;
-}
-
-void AArcoroxCharacter::ResetEquipSoundTimer()
-{
-	bShouldPlayEquipSound = true;
-}
@@ -0,0 +1,268 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/CombatDamageSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Resolve"), STAT_DamageResolve, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Damage Notify"), STAT_DamageNotify, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Hits Queued"), STAT_DamageHitsQueued, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Notifications"), STAT_DamageNotifications, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<bool> CVarDamageBatched(
+	TEXT("arcorox.Damage.Batched"),
+	true,
+	TEXT("Queue enemy damage and resolve it once per frame over the health table (1) or apply each hit through TakeDamage immediately (0)."));
+
+static void RunDamageBenchmarkCommand(const TArray<FString>& Args, UWorld* World)
+{
+	UCombatDamageSubsystem* Damage = World ? World->GetSubsystem<UCombatDamageSubsystem>() : nullptr;
+	double UnbatchedUs, BatchedUs;
+	if (Damage) Damage->RunBenchmark(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000, UnbatchedUs, BatchedUs);
+}
+
+static void LogDamageCommand(UWorld* World)
+{
+	if (UCombatDamageSubsystem* Damage = World ? World->GetSubsystem<UCombatDamageSubsystem>() : nullptr) Damage->LogDamageReport();
+}
+
+static FAutoConsoleCommandWithWorldAndArgs RunDamageBenchmarkConsoleCommand(
+	TEXT("arcorox.Damage.Benchmark"),
+	TEXT("Times hits on the registered enemies through ApplyDamage and through the batched queue. Usage: arcorox.Damage.Benchmark <Hits>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunDamageBenchmarkCommand));
+
+static FAutoConsoleCommandWithWorld LogDamageConsoleCommand(
+	TEXT("arcorox.Damage.Report"),
+	TEXT("Logs health table slots, queued hits and the average cost of the damage pass."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&LogDamageCommand));
+
+void UCombatDamageSubsystem::Deinitialize()
+{
+	Queue.Empty();
+	Enemies.Empty();
+
+	Super::Deinitialize();
+}
+
+void UCombatDamageSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	ResolveDamage();
+}
+
+TStatId UCombatDamageSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatDamageSubsystem, STATGROUP_Tickables);
+}
+
+bool UCombatDamageSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UCombatDamageSubsystem::IsBatchEnabled()
+{
+	return CVarDamageBatched.GetValueOnGameThread();
+}
+
+int32 UCombatDamageSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr) return INDEX_NONE;
+	int32 Slot = FreeSlots.Num() > 0 ? FreeSlots.Pop(false) : INDEX_NONE;
+	if (Slot == INDEX_NONE)
+	{
+		Slot = Health.AddZeroed();
+		MaxHealth.AddZeroed();
+		Dead.Add(false);
+		LastInstigators.AddDefaulted();
+		Enemies.AddDefaulted();
+		Generations.Add(0);
+		Touched.Add(false);
+		PointHits.Add(0);
+		LastHitLocations.Add(FVector::ZeroVector);
+	}
+	Health[Slot] = Enemy->GetHealth();
+	MaxHealth[Slot] = Enemy->GetMaxHealth();
+	Dead[Slot] = Enemy->IsDead();
+	LastInstigators[Slot] = nullptr;
+	Enemies[Slot] = Enemy;
+	return Slot;
+}
+
+void UCombatDamageSubsystem::UnregisterEnemy(int32 Slot)
+{
+	if (!Enemies.IsValidIndex(Slot) || Enemies[Slot].IsExplicitlyNull()) return;
+	Enemies[Slot] = nullptr;
+	LastInstigators[Slot] = nullptr;
+	Dead[Slot] = true;
+	Generations[Slot]++;
+	FreeSlots.Add(Slot);
+}
+
+bool UCombatDamageSubsystem::QueueDamage(int32 Slot, float Amount, AActor* Instigator)
+{
+	return QueueDamageInternal(Slot, Amount, Instigator, FVector::ZeroVector, false);
+}
+
+bool UCombatDamageSubsystem::QueuePointDamage(int32 Slot, float Amount, AActor* Instigator, const FVector& HitLocation)
+{
+	return QueueDamageInternal(Slot, Amount, Instigator, HitLocation, true);
+}
+
+bool UCombatDamageSubsystem::QueueDamageInternal(int32 Slot, float Amount, AActor* Instigator, const FVector& HitLocation, bool bHasHitLocation)
+{
+	if (bBypassQueue || !Enemies.IsValidIndex(Slot)) return false;
+	//Dead enemies swallow the hit, same as TakeDamage would
+	if (Dead[Slot]) return true;
+	FQueuedDamage& Damage = Queue.AddDefaulted_GetRef();
+	Damage.Slot = Slot;
+	Damage.Generation = Generations[Slot];
+	Damage.Amount = Amount;
+	Damage.Instigator = Instigator;
+	Damage.HitLocation = HitLocation;
+	Damage.bHasHitLocation = bHasHitLocation;
+	INC_DWORD_STAT(STAT_DamageHitsQueued);
+	return true;
+}
+
+void UCombatDamageSubsystem::SetHealth(int32 Slot, float InHealth)
+{
+	if (!Enemies.IsValidIndex(Slot)) return;
+	Health[Slot] = InHealth;
+	Dead[Slot] = InHealth <= 0.f;
+}
+
+void UCombatDamageSubsystem::ResolveDamage()
+{
+	if (Queue.Num() == 0) return;
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	TArray<int32, TInlineAllocator<32>> TouchedSlots;
+	TArray<int32, TInlineAllocator<8>> KilledSlots;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_DamageResolve);
+		//Queue order is hit order, so the same hits always kill in the same order
+		for (const FQueuedDamage& Damage : Queue)
+		{
+			const int32 Slot = Damage.Slot;
+			if (Generations[Slot] != Damage.Generation || Dead[Slot]) continue;
+			Health[Slot] -= Damage.Amount;
+			if (Damage.Instigator.IsValid()) LastInstigators[Slot] = Damage.Instigator;
+			if (Damage.bHasHitLocation)
+			{
+				LastHitLocations[Slot] = Damage.HitLocation;
+				PointHits[Slot]++;
+			}
+			if (!Touched[Slot])
+			{
+				Touched[Slot] = true;
+				TouchedSlots.Add(Slot);
+			}
+			if (Health[Slot] <= 0.f)
+			{
+				Health[Slot] = 0.f;
+				Dead[Slot] = true;
+				KilledSlots.Add(Slot);
+			}
+		}
+		NumHits += Queue.Num();
+		Queue.Reset();
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_DamageNotify);
+		//Notifications can unregister slots, the scratch is cleared from the saved list afterward
+		for (const int32 Slot : TouchedSlots)
+		{
+			AEnemy* Enemy = Enemies[Slot].Get();
+			if (Enemy && !Dead[Slot]) Enemy->ApplyResolvedDamage(Health[Slot], LastInstigators[Slot].Get(), PointHits[Slot], LastHitLocations[Slot]);
+		}
+		for (const int32 Slot : KilledSlots)
+		{
+			AEnemy* Enemy = Enemies[Slot].Get();
+			if (Enemy) Enemy->ApplyResolvedDeath(LastInstigators[Slot].Get(), PointHits[Slot] > 0, LastHitLocations[Slot]);
+		}
+		for (const int32 Slot : TouchedSlots)
+		{
+			Touched[Slot] = false;
+			PointHits[Slot] = 0;
+		}
+		INC_DWORD_STAT_BY(STAT_DamageNotifications, TouchedSlots.Num());
+	}
+	NumResolves++;
+	TotalResolveMs += FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+}
+
+bool UCombatDamageSubsystem::RunBenchmark(int32 InNumHits, double& OutUnbatchedUs, double& OutBatchedUs)
+{
+	OutUnbatchedUs = OutBatchedUs = 0.0;
+	TArray<int32> Slots;
+	for (int32 Slot = 0; Slot < Enemies.Num(); Slot++)
+	{
+		if (Enemies[Slot].IsValid() && !Dead[Slot]) Slots.Add(Slot);
+	}
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	if (Slots.Num() == 0 || Pawn == nullptr || InNumHits <= 0)
+	{
+		UE_LOG(LogArcorox, Warning, TEXT("Damage benchmark needs a player pawn and living enemies"));
+		return false;
+	}
+	ResolveDamage();
+	//Both paths retarget every hit enemy at the pawn, the enemies go back to what they were doing after
+	TArray<float> SavedHealth;
+	TArray<TWeakObjectPtr<AActor>> SavedTargets;
+	TArray<TWeakObjectPtr<AActor>> SavedInstigators;
+	for (const int32 Slot : Slots)
+	{
+		SavedHealth.Add(Health[Slot]);
+		SavedTargets.Add(Enemies[Slot]->GetTarget());
+		SavedInstigators.Add(LastInstigators[Slot]);
+	}
+	//Small enough that nobody dies, both paths still run their full per-hit work
+	const float Amount = KINDA_SMALL_NUMBER;
+
+	bBypassQueue = true;
+	uint64 StartCycles = FPlatformTime::Cycles64();
+	for (int32 i = 0; i < InNumHits; i++)
+	{
+		UGameplayStatics::ApplyDamage(Enemies[Slots[i % Slots.Num()]].Get(), Amount, PlayerController, Pawn, UDamageType::StaticClass());
+	}
+	const double UnbatchedMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+	bBypassQueue = false;
+
+	StartCycles = FPlatformTime::Cycles64();
+	for (int32 i = 0; i < InNumHits; i++)
+	{
+		QueueDamage(Slots[i % Slots.Num()], Amount, Pawn);
+	}
+	ResolveDamage();
+	const double BatchedMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+	for (int32 i = 0; i < Slots.Num(); i++)
+	{
+		AEnemy* Enemy = Enemies[Slots[i]].Get();
+		if (Enemy == nullptr) continue;
+		Enemy->SetHealth(SavedHealth[i]);
+		Enemy->SetTarget(SavedTargets[i].Get());
+		LastInstigators[Slots[i]] = SavedInstigators[i];
+	}
+	OutUnbatchedUs = UnbatchedMs * 1000.0 / InNumHits;
+	OutBatchedUs = BatchedMs * 1000.0 / InNumHits;
+	UE_LOG(LogArcorox, Display, TEXT("Damage benchmark: %d hits on %d enemies, ApplyDamage %.3f us per hit, batched %.3f us per hit"),
+		InNumHits, Slots.Num(), OutUnbatchedUs, OutBatchedUs);
+	return true;
+}
+
+void UCombatDamageSubsystem::LogDamageReport() const
+{
+	const double AverageMs = NumResolves > 0 ? TotalResolveMs / NumResolves : 0.0;
+	const double PerHitUs = NumHits > 0 ? TotalResolveMs * 1000.0 / NumHits : 0.0;
+	UE_LOG(LogArcorox, Display, TEXT("Damage: %s, %d slots (%d free), %d queued"), IsBatchEnabled() ? TEXT("batched") : TEXT("immediate"), Enemies.Num(), FreeSlots.Num(), Queue.Num());
+	UE_LOG(LogArcorox, Display, TEXT("  %llu hits over %llu passes, %.3f ms per pass, %.3f us per hit"), NumHits, NumResolves, AverageMs, PerHitUs);
+}
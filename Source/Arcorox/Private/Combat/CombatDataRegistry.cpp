@@ -0,0 +1,222 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/CombatDataRegistry.h"
+#include "Engine/Engine.h"
+#include "Engine/DataTable.h"
+#include "Engine/SkeletalMesh.h"
+#include "Animation/Skeleton.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Combat Data Load"), STAT_CombatDataLoad, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Hit Zone Compile"), STAT_HitZoneCompile, STATGROUP_Arcorox);
+
+static void LogHitZonesCommand()
+{
+	if (UCombatDataRegistry* Registry = UCombatDataRegistry::Get()) Registry->LogHitZoneReport();
+}
+
+static FAutoConsoleCommand LogHitZonesConsoleCommand(
+	TEXT("arcorox.Combat.HitZoneReport"),
+	TEXT("Logs the compiled hit zones of every enemy mesh with the combined multiplier of each zone for each weapon type."),
+	FConsoleCommandDelegate::CreateStatic(&LogHitZonesCommand));
+
+namespace
+{
+	/* Row name for an enum value, EWT_Pistol is stored in the table as Pistol */
+	template<typename EnumType>
+	FName GetArchetypeRowName(int32 Index)
+	{
+		FString Name = StaticEnum<EnumType>()->GetNameStringByIndex(Index);
+		int32 PrefixEnd;
+		if (Name.FindChar(TEXT('_'), PrefixEnd)) Name.RightChopInline(PrefixEnd + 1);
+		return FName(*Name);
+	}
+
+	template<typename EnumType, typename RowType>
+	void IndexTable(UDataTable* Table, TArray<RowType>& Archetypes, TArray<bool>& ValidArchetypes)
+	{
+		for (int32 i = 0; i < Archetypes.Num(); i++)
+		{
+			const RowType* Row = Table ? Table->FindRow<RowType>(GetArchetypeRowName<EnumType>(i), TEXT(""), false) : nullptr;
+			ValidArchetypes[i] = Row != nullptr;
+			if (Row) Archetypes[i] = *Row;
+		}
+	}
+}
+
+UCombatDataRegistry::UCombatDataRegistry() :
+	WeaponTypeDataTablePath(TEXT("/Game/Dynamic/Blueprints/DataTables/WeaponTypeDataTable.WeaponTypeDataTable")),
+	ItemRarityDataTablePath(TEXT("/Game/Dynamic/Blueprints/DataTables/ItemRarityDataTable.ItemRarityDataTable")),
+	HitZoneDataTablePath(TEXT("/Game/Dynamic/Blueprints/DataTables/HitZoneDataTable.HitZoneDataTable")),
+	bTablesLoaded(false)
+{
+}
+
+void UCombatDataRegistry::Deinitialize()
+{
+	if (WeaponTypeDataTable) WeaponTypeDataTable->OnDataTableChanged().RemoveAll(this);
+	if (ItemRarityDataTable) ItemRarityDataTable->OnDataTableChanged().RemoveAll(this);
+	if (HitZoneDataTable) HitZoneDataTable->OnDataTableChanged().RemoveAll(this);
+	CompiledHitZones.Empty();
+
+	Super::Deinitialize();
+}
+
+UCombatDataRegistry* UCombatDataRegistry::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UCombatDataRegistry>() : nullptr;
+}
+
+const FWeaponTypeTable* UCombatDataRegistry::GetWeaponArchetype(EWeaponType Type)
+{
+	LoadTables();
+	const int32 Index = static_cast<int32>(Type);
+	return ValidWeaponArchetypes.IsValidIndex(Index) && ValidWeaponArchetypes[Index] ? &WeaponArchetypes[Index] : nullptr;
+}
+
+const FItemRarityTable* UCombatDataRegistry::GetItemRarityArchetype(EItemRarity Rarity)
+{
+	LoadTables();
+	const int32 Index = static_cast<int32>(Rarity);
+	return ValidItemRarityArchetypes.IsValidIndex(Index) && ValidItemRarityArchetypes[Index] ? &ItemRarityArchetypes[Index] : nullptr;
+}
+
+void UCombatDataRegistry::LoadTables()
+{
+	if (bTablesLoaded) return;
+	bTablesLoaded = true;
+	SCOPE_CYCLE_COUNTER(STAT_CombatDataLoad);
+
+	WeaponArchetypes.SetNum(static_cast<int32>(EWeaponType::EWT_MAX));
+	ValidWeaponArchetypes.Init(false, WeaponArchetypes.Num());
+	ItemRarityArchetypes.SetNum(static_cast<int32>(EItemRarity::EIR_MAX));
+	ValidItemRarityArchetypes.Init(false, ItemRarityArchetypes.Num());
+
+	WeaponTypeDataTable = Cast<UDataTable>(WeaponTypeDataTablePath.TryLoad());
+	ItemRarityDataTable = Cast<UDataTable>(ItemRarityDataTablePath.TryLoad());
+	HitZoneDataTable = Cast<UDataTable>(HitZoneDataTablePath.TryLoad());
+	//Re-index in place when a table is edited or reimported in the editor
+	if (WeaponTypeDataTable) WeaponTypeDataTable->OnDataTableChanged().AddUObject(this, &UCombatDataRegistry::IndexWeaponTypeTable);
+	if (ItemRarityDataTable) ItemRarityDataTable->OnDataTableChanged().AddUObject(this, &UCombatDataRegistry::IndexItemRarityTable);
+	if (HitZoneDataTable) HitZoneDataTable->OnDataTableChanged().AddUObject(this, &UCombatDataRegistry::RecompileHitZones);
+
+	IndexWeaponTypeTable();
+	IndexItemRarityTable();
+}
+
+void UCombatDataRegistry::IndexWeaponTypeTable()
+{
+	IndexTable<EWeaponType>(WeaponTypeDataTable, WeaponArchetypes, ValidWeaponArchetypes);
+}
+
+void UCombatDataRegistry::IndexItemRarityTable()
+{
+	IndexTable<EItemRarity>(ItemRarityDataTable, ItemRarityArchetypes, ValidItemRarityArchetypes);
+}
+
+const FCompiledHitZones* UCombatDataRegistry::GetHitZones(USkeletalMesh* Mesh, const FName& FallbackHeadBone)
+{
+	if (Mesh == nullptr) return nullptr;
+	LoadTables();
+	TUniquePtr<FCompiledHitZones>& HitZones = CompiledHitZones.FindOrAdd(TPair<TObjectKey<USkeletalMesh>, FName>(Mesh, FallbackHeadBone));
+	if (!HitZones.IsValid())
+	{
+		HitZones = MakeUnique<FCompiledHitZones>();
+		HitZones->Mesh = Mesh;
+		HitZones->FallbackHeadBone = FallbackHeadBone;
+		CompileHitZones(*HitZones);
+	}
+	return HitZones.Get();
+}
+
+void UCombatDataRegistry::CompileHitZones(FCompiledHitZones& HitZones)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HitZoneCompile);
+	USkeletalMesh* Mesh = HitZones.Mesh.Get();
+	if (Mesh == nullptr) return;
+
+	const FHitZoneTable* Row = nullptr;
+	if (HitZoneDataTable && Mesh->GetSkeleton())
+	{
+		const FSoftObjectPath SkeletonPath{ Mesh->GetSkeleton() };
+		HitZoneDataTable->ForeachRow<FHitZoneTable>(TEXT(""), [&Row, &SkeletonPath](const FName& Key, const FHitZoneTable& Value)
+		{
+			if (Row == nullptr && Value.Skeleton.ToSoftObjectPath() == SkeletonPath) Row = &Value;
+		});
+	}
+	CompileBoneZones(HitZones, Mesh->GetRefSkeleton(), Row);
+}
+
+void UCombatDataRegistry::CompileBoneZones(FCompiledHitZones& HitZones, const FReferenceSkeleton& RefSkeleton, const FHitZoneTable* Row)
+{
+	HitZones.bFromTable = Row != nullptr;
+	HitZones.ZoneMultipliers = FHitZoneMultipliers();
+	if (Row)
+	{
+		HitZones.ZoneMultipliers.Set(EHitZone::EHZ_Head, Row->HeadMultiplier);
+		HitZones.ZoneMultipliers.Set(EHitZone::EHZ_Torso, Row->TorsoMultiplier);
+		HitZones.ZoneMultipliers.Set(EHitZone::EHZ_Arms, Row->ArmMultiplier);
+		HitZones.ZoneMultipliers.Set(EHitZone::EHZ_Legs, Row->LegMultiplier);
+	}
+
+	//Parents always come before their children in the reference skeleton, so one pass carries zones down the hierarchy
+	HitZones.Bones.SetNum(RefSkeleton.GetNum());
+	for (int32 BoneIndex = 0; BoneIndex < RefSkeleton.GetNum(); BoneIndex++)
+	{
+		const FName BoneName = RefSkeleton.GetBoneName(BoneIndex);
+		EHitZone Zone = EHitZone::EHZ_Torso;
+		if (Row)
+		{
+			const int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+			if (ParentIndex != INDEX_NONE) Zone = HitZones.Bones[ParentIndex].Zone;
+			if (Row->HeadBones.Contains(BoneName)) Zone = EHitZone::EHZ_Head;
+			else if (Row->ArmBones.Contains(BoneName)) Zone = EHitZone::EHZ_Arms;
+			else if (Row->LegBones.Contains(BoneName)) Zone = EHitZone::EHZ_Legs;
+		}
+		//The fallback head bone matches the old exact bone name check, its children stay torso
+		else if (BoneName == HitZones.FallbackHeadBone) Zone = EHitZone::EHZ_Head;
+		HitZones.Bones[BoneIndex].Zone = Zone;
+		HitZones.Bones[BoneIndex].Multiplier = HitZones.ZoneMultipliers.Get(Zone);
+	}
+}
+
+void UCombatDataRegistry::RecompileHitZones()
+{
+	for (TPair<TPair<TObjectKey<USkeletalMesh>, FName>, TUniquePtr<FCompiledHitZones>>& Pair : CompiledHitZones)
+	{
+		if (Pair.Value.IsValid()) CompileHitZones(*Pair.Value);
+	}
+}
+
+void UCombatDataRegistry::LogHitZoneReport()
+{
+	LoadTables();
+	const UEnum* ZoneEnum = StaticEnum<EHitZone>();
+	const UEnum* WeaponEnum = StaticEnum<EWeaponType>();
+	UE_LOG(LogArcorox, Display, TEXT("Hit zones: %d compiled meshes, table %s"), CompiledHitZones.Num(), HitZoneDataTable ? *HitZoneDataTable->GetName() : TEXT("missing"));
+	for (const TPair<TPair<TObjectKey<USkeletalMesh>, FName>, TUniquePtr<FCompiledHitZones>>& Pair : CompiledHitZones)
+	{
+		const FCompiledHitZones& HitZones = *Pair.Value;
+		const USkeletalMesh* Mesh = HitZones.Mesh.Get();
+		UE_LOG(LogArcorox, Display, TEXT("  %s: %d bones, %s"), Mesh ? *Mesh->GetName() : TEXT("(unloaded)"), HitZones.Bones.Num(),
+			HitZones.bFromTable ? TEXT("from table") : *FString::Printf(TEXT("fallback head bone %s"), *HitZones.FallbackHeadBone.ToString()));
+		for (int32 Zone = 0; Zone < static_cast<int32>(EHitZone::EHZ_MAX); Zone++)
+		{
+			int32 NumBones = 0;
+			for (const FHitZoneBone& Bone : HitZones.Bones)
+			{
+				if (static_cast<int32>(Bone.Zone) == Zone) NumBones++;
+			}
+			FString WeaponMultipliers;
+			for (int32 WeaponType = 0; WeaponType < WeaponArchetypes.Num(); WeaponType++)
+			{
+				if (!ValidWeaponArchetypes[WeaponType]) continue;
+				const float Multiplier = HitZones.ZoneMultipliers.Get(static_cast<EHitZone>(Zone)) * WeaponArchetypes[WeaponType].GetHitZoneMultipliers().Get(static_cast<EHitZone>(Zone));
+				WeaponMultipliers += FString::Printf(TEXT(" %s x%.2f"), *WeaponEnum->GetDisplayNameTextByIndex(WeaponType).ToString(), Multiplier);
+			}
+			UE_LOG(LogArcorox, Display, TEXT("    %s: %d bones, x%.2f,%s"), *ZoneEnum->GetDisplayNameTextByIndex(Zone).ToString(), NumBones, HitZones.ZoneMultipliers.Get(static_cast<EHitZone>(Zone)), *WeaponMultipliers);
+		}
+	}
+}
@@ -0,0 +1,287 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/ExplosionSubsystem.h"
+#include "Explosive/Explosive.h"
+#include "Items/Item.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Explosion Wave"), STAT_ExplosionWave, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosion Detonations"), STAT_ExplosionDetonations, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosion Blast Targets"), STAT_ExplosionBlastTargets, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosion Overlaps"), STAT_ExplosionOverlaps, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosion Line Of Sight Traces"), STAT_ExplosionLineOfSightTraces, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Explosions Queued"), STAT_ExplosionsQueued, STATGROUP_Arcorox);
+
+static void SpawnChainTestCommand(const TArray<FString>& Args, UWorld* World)
+{
+	UExplosionSubsystem* Explosions = World ? World->GetSubsystem<UExplosionSubsystem>() : nullptr;
+	if (Explosions == nullptr) return;
+	const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 500;
+	const float Spacing = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 300.f;
+	Explosions->SpawnChainTest(Count, Spacing);
+}
+
+static void LogExplosionsCommand(UWorld* World)
+{
+	if (UExplosionSubsystem* Explosions = World ? World->GetSubsystem<UExplosionSubsystem>() : nullptr) Explosions->LogExplosionReport();
+}
+
+static FAutoConsoleCommandWithWorldAndArgs SpawnChainTestConsoleCommand(
+	TEXT("arcorox.Explosive.ChainTest"),
+	TEXT("Spawns a grid of explosives in front of the player and sets off a chain reaction. Usage: arcorox.Explosive.ChainTest <Count> <Spacing>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&SpawnChainTestCommand));
+
+static FAutoConsoleCommandWithWorld LogExplosionsConsoleCommand(
+	TEXT("arcorox.Explosive.Report"),
+	TEXT("Logs queued explosions, wave and detonation counts and the average and worst wave cost."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&LogExplosionsCommand));
+
+UExplosionSubsystem::UExplosionSubsystem() :
+	MaxDetonationsPerFrame(24),
+	ChainDelay(0.1f),
+	ImpulseUpBias(0.5f),
+	MaxLineOfSightTracesPerWave(256),
+	LineOfSightTracesLeft(0),
+	NumWaves(0),
+	NumDetonations(0),
+	TotalWaveMs(0.0),
+	MaxWaveMs(0.0)
+{
+
+}
+
+void UExplosionSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_ExplosionsQueued, Queue.Num());
+	Queue.Empty();
+	Explosives.Empty();
+
+	Super::Deinitialize();
+}
+
+void UExplosionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	ProcessWave();
+}
+
+TStatId UExplosionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UExplosionSubsystem, STATGROUP_Tickables);
+}
+
+bool UExplosionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UExplosionSubsystem::RegisterExplosive(AExplosive* Explosive)
+{
+	if (Explosive) Explosives.AddUnique(Explosive);
+}
+
+void UExplosionSubsystem::UnregisterExplosive(AExplosive* Explosive)
+{
+	Explosives.RemoveSingleSwap(Explosive, false);
+}
+
+void UExplosionSubsystem::QueueDetonation(AExplosive* Explosive, const FVector& Location, APawn* Instigator, float Delay)
+{
+	if (Explosive == nullptr || Explosive->IsDetonationQueued()) return;
+	Explosive->SetDetonationQueued(true);
+	FQueuedDetonation& Detonation = Queue.AddDefaulted_GetRef();
+	Detonation.Explosive = Explosive;
+	Detonation.Location = Location;
+	Detonation.Instigator = Instigator;
+	Detonation.DetonateTime = GetWorld()->GetTimeSeconds() + Delay;
+	INC_DWORD_STAT(STAT_ExplosionsQueued);
+}
+
+void UExplosionSubsystem::ProcessWave()
+{
+	if (Queue.Num() == 0) return;
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	//Oldest due detonations first, anything past the per-frame limit stays queued for the next frame
+	TArray<FQueuedDetonation> Wave;
+	for (int32 i = 0; i < Queue.Num() && Wave.Num() < FMath::Max(MaxDetonationsPerFrame, 1);)
+	{
+		if (Queue[i].Explosive.IsValid() && Queue[i].DetonateTime > Now)
+		{
+			i++;
+			continue;
+		}
+		if (Queue[i].Explosive.IsValid()) Wave.Add(Queue[i]);
+		Queue.RemoveAt(i, 1, false);
+		DEC_DWORD_STAT(STAT_ExplosionsQueued);
+	}
+	if (Wave.Num() == 0) return;
+	SCOPE_CYCLE_COUNTER(STAT_ExplosionWave);
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	LineOfSightTracesLeft = MaxLineOfSightTracesPerWave;
+	TMap<AActor*, FBlastTarget> Targets;
+	GatherBlastTargets(Wave, Targets);
+	for (const FQueuedDetonation& Detonation : Wave)
+	{
+		QueueCaughtExplosives(Detonation, Detonation.Explosive->GetDamageOuterRadius());
+	}
+	//Gone before damage is applied so nothing reacting to the damage finds a spent explosive
+	for (const FQueuedDetonation& Detonation : Wave)
+	{
+		if (AExplosive* Explosive = Detonation.Explosive.Get()) Explosive->Detonate(Detonation.Location);
+	}
+	ApplyBlastTargets(Targets);
+
+	const double WaveMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+	NumWaves++;
+	NumDetonations += Wave.Num();
+	TotalWaveMs += WaveMs;
+	MaxWaveMs = FMath::Max(MaxWaveMs, WaveMs);
+	INC_DWORD_STAT_BY(STAT_ExplosionDetonations, Wave.Num());
+	INC_DWORD_STAT_BY(STAT_ExplosionBlastTargets, Targets.Num());
+}
+
+void UExplosionSubsystem::GatherBlastTargets(const TArray<FQueuedDetonation>& Wave, TMap<AActor*, FBlastTarget>& OutTargets)
+{
+	//One query around every blast of the wave, each blast then keeps only the candidates within its own radius
+	FBox WaveBounds(ForceInit);
+	for (const FQueuedDetonation& Detonation : Wave)
+	{
+		WaveBounds += FBox::BuildAABB(Detonation.Location, FVector(Detonation.Explosive->GetDamageOuterRadius()));
+	}
+	FCollisionObjectQueryParams ObjectParams;
+	ObjectParams.AddObjectTypesToQuery(ECollisionChannel::ECC_Pawn);
+	ObjectParams.AddObjectTypesToQuery(ECollisionChannel::ECC_PhysicsBody);
+	ObjectParams.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldDynamic);
+	const FCollisionQueryParams QueryParams{ SCENE_QUERY_STAT(ExplosionBlast), false };
+	TArray<FOverlapResult> Overlaps;
+	GetWorld()->OverlapMultiByObjectType(Overlaps, WaveBounds.GetCenter(), FQuat::Identity, ObjectParams, FCollisionShape::MakeBox(WaveBounds.GetExtent()), QueryParams);
+	INC_DWORD_STAT(STAT_ExplosionOverlaps);
+
+	TSet<AActor*> Candidates;
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		AActor* Actor = Overlap.GetActor();
+		//Explosives chain instead of taking damage
+		if (Actor && !Actor->IsA<AExplosive>()) Candidates.Add(Actor);
+	}
+	for (const FQueuedDetonation& Detonation : Wave)
+	{
+		const AExplosive* Explosive = Detonation.Explosive.Get();
+		const float Radius = Explosive->GetDamageOuterRadius();
+		for (AActor* Actor : Candidates)
+		{
+			const FVector ToActor{ Actor->GetActorLocation() - Detonation.Location };
+			const float Distance = ToActor.Size();
+			if (Distance > Radius || !HasLineOfSight(Detonation, Actor->GetActorLocation(), Actor)) continue;
+			FBlastTarget& Target = OutTargets.FindOrAdd(Actor);
+			Target.Damage += Explosive->GetDamageAtDistance(Distance);
+			const FVector Direction{ (ToActor.GetSafeNormal2D() + FVector(0.f, 0.f, ImpulseUpBias)).GetSafeNormal() };
+			Target.Impulse += Direction * Explosive->GetImpulseStrength() * (1.f - Distance / Radius);
+			if (!Target.Instigator.IsValid()) Target.Instigator = Detonation.Instigator;
+		}
+	}
+}
+
+void UExplosionSubsystem::QueueCaughtExplosives(const FQueuedDetonation& Detonation, float Radius)
+{
+	const float RadiusSquared = Radius * Radius;
+	for (int32 i = 0; i < Explosives.Num(); i++)
+	{
+		AExplosive* Explosive = Explosives[i].Get();
+		if (Explosive == nullptr || Explosive->IsDetonationQueued()) continue;
+		if (FVector::DistSquared(Explosive->GetActorLocation(), Detonation.Location) > RadiusSquared) continue;
+		if (!HasLineOfSight(Detonation, Explosive->GetActorLocation(), Explosive)) continue;
+		QueueDetonation(Explosive, Explosive->GetActorLocation(), Detonation.Instigator.Get(), ChainDelay);
+	}
+}
+
+bool UExplosionSubsystem::HasLineOfSight(const FQueuedDetonation& Detonation, const FVector& TargetLocation, const AActor* Target)
+{
+	//Past the budget a large wave falls back to distance alone rather than stalling the frame on traces
+	if (LineOfSightTracesLeft <= 0) return true;
+	LineOfSightTracesLeft--;
+	//Only level geometry shelters, other actors caught in the blast do not
+	FCollisionQueryParams QueryParams{ SCENE_QUERY_STAT(ExplosionLineOfSight), false, Detonation.Explosive.Get() };
+	QueryParams.AddIgnoredActor(Target);
+	INC_DWORD_STAT(STAT_ExplosionLineOfSightTraces);
+	return !GetWorld()->LineTraceTestByObjectType(Detonation.Location, TargetLocation, FCollisionObjectQueryParams{ ECollisionChannel::ECC_WorldStatic }, QueryParams);
+}
+
+void UExplosionSubsystem::ApplyBlastTargets(const TMap<AActor*, FBlastTarget>& Targets)
+{
+	for (const TPair<AActor*, FBlastTarget>& Pair : Targets)
+	{
+		//Damage from an earlier target can destroy later ones
+		AActor* Actor = Pair.Key;
+		if (!IsValid(Actor)) continue;
+		const FBlastTarget& Target = Pair.Value;
+		APawn* Instigator = Target.Instigator.Get();
+		if (Target.Damage > 0.f) UGameplayStatics::ApplyDamage(Actor, Target.Damage, Instigator ? Instigator->GetController() : nullptr, Instigator, UDamageType::StaticClass());
+		if (!IsValid(Actor) || Target.Impulse.IsNearlyZero()) continue;
+
+		if (AItem* Item = Cast<AItem>(Actor))
+		{
+			Item->ApplyBlastImpulse(Target.Impulse);
+			continue;
+		}
+		ACharacter* Character = Cast<ACharacter>(Actor);
+		if (Character && Character->GetCharacterMovement())
+		{
+			Character->GetCharacterMovement()->AddImpulse(Target.Impulse, true);
+			continue;
+		}
+		UPrimitiveComponent* Root = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+		if (Root && Root->IsSimulatingPhysics()) Root->AddImpulse(Target.Impulse, NAME_None, true);
+	}
+}
+
+void UExplosionSubsystem::SpawnChainTest(int32 Count, float Spacing)
+{
+	UWorld* World = GetWorld();
+	APlayerController* PlayerController = World->GetFirstPlayerController();
+	APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	TActorIterator<AExplosive> It(World);
+	if (Pawn == nullptr || !It)
+	{
+		UE_LOG(LogArcorox, Warning, TEXT("Explosive chain test needs a player pawn and an explosive in the level to copy"));
+		return;
+	}
+	UClass* ExplosiveClass = It->GetClass();
+	const int32 Side = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Count)));
+	const FVector Forward{ Pawn->GetActorForwardVector().GetSafeNormal2D() };
+	const FVector Right{ FVector::CrossProduct(FVector::UpVector, Forward) };
+	const FVector Origin{ Pawn->GetActorLocation() + Forward * 1000.f - Right * (Side - 1) * Spacing * 0.5f };
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AExplosive* First = nullptr;
+	for (int32 i = 0; i < Count; i++)
+	{
+		const FVector Location{ Origin + Forward * (i / Side) * Spacing + Right * (i % Side) * Spacing };
+		AExplosive* Explosive = World->SpawnActor<AExplosive>(ExplosiveClass, Location, FRotator::ZeroRotator, SpawnParameters);
+		if (First == nullptr) First = Explosive;
+	}
+	if (First) QueueDetonation(First, First->GetActorLocation(), Pawn, 0.f);
+	//Waves from the test alone
+	NumWaves = 0;
+	NumDetonations = 0;
+	TotalWaveMs = 0.0;
+	MaxWaveMs = 0.0;
+}
+
+void UExplosionSubsystem::LogExplosionReport() const
+{
+	const double AverageMs = NumWaves > 0 ? TotalWaveMs / NumWaves : 0.0;
+	UE_LOG(LogArcorox, Display, TEXT("Explosions: %d queued, %d explosives in world, limit %d per frame, chain delay %.2f s"), Queue.Num(), Explosives.Num(), MaxDetonationsPerFrame, ChainDelay);
+	UE_LOG(LogArcorox, Display, TEXT("  %llu waves, %llu detonations, wave %.3f ms average, %.3f ms worst, game thread: %.2f ms"), NumWaves, NumDetonations, AverageMs, MaxWaveMs, FPlatformTime::ToMilliseconds(GGameThreadTime));
+}
@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/HitscanSubsystem.h"
+#include "Characters/ArcoroxCharacter.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hitscan Queue Shot"), STAT_HitscanQueueShot, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Submit Batch"), STAT_HitscanSubmitBatch, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Hitscan Apply Shot"), STAT_HitscanApplyShot, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Shots Queued"), STAT_HitscanShotsQueued, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Traces Submitted"), STAT_HitscanTracesSubmitted, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<bool> CVarHitscanAsync(
+	TEXT("arcorox.Hitscan.Async"),
+	true,
+	TEXT("Resolve hitscan shots with batched async scene queries (1) or synchronous traces on the game thread (0)."));
+
+void UHitscanSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	BarrelTraceDelegate.BindUObject(this, &UHitscanSubsystem::OnBarrelTraceComplete);
+}
+
+void UHitscanSubsystem::Deinitialize()
+{
+	PendingShots.Empty();
+	InFlightShots.Empty();
+	BarrelTraceDelegate.Unbind();
+
+	Super::Deinitialize();
+}
+
+void UHitscanSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SubmitPendingShots();
+}
+
+TStatId UHitscanSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHitscanSubsystem, STATGROUP_Tickables);
+}
+
+bool UHitscanSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UHitscanSubsystem::IsAsyncEnabled()
+{
+	return CVarHitscanAsync.GetValueOnGameThread();
+}
+
+void UHitscanSubsystem::QueueShot(const FHitscanShot& Shot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HitscanQueueShot);
+	INC_DWORD_STAT(STAT_HitscanShotsQueued);
+
+	if (IsAsyncEnabled())
+	{
+		PendingShots.Add(Shot);
+		return;
+	}
+
+	//Synchronous fallback, same traces resolved immediately
+	UWorld* World = GetWorld();
+	if (World == nullptr) return;
+	FHitResult BeamHitResult;
+	TraceBarrel(World, Shot, BeamHitResult);
+	ApplyShot(Shot, BeamHitResult, BeamHitResult.bBlockingHit);
+}
+
+void UHitscanSubsystem::TraceBarrel(UWorld* World, const FHitscanShot& Shot, FHitResult& OutHit)
+{
+	World->LineTraceSingleByChannel(OutHit, Shot.SocketTransform.GetLocation(), GetBarrelTraceEnd(Shot), ECollisionChannel::ECC_Visibility);
+}
+
+FTraceHandle UHitscanSubsystem::SubmitBarrelTrace(UWorld* World, const FHitscanShot& Shot, FTraceDelegate* Delegate, uint32 UserData)
+{
+	return World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Shot.SocketTransform.GetLocation(), GetBarrelTraceEnd(Shot), ECollisionChannel::ECC_Visibility,
+		FCollisionQueryParams::DefaultQueryParam, FCollisionResponseParams::DefaultResponseParam, Delegate, UserData);
+}
+
+FVector UHitscanSubsystem::GetBarrelTraceEnd(const FHitscanShot& Shot)
+{
+	//Trace slightly past the beam end so surfaces at the crosshair hit location are found
+	const FVector WeaponTraceStart{ Shot.SocketTransform.GetLocation() };
+	const FVector StartToEnd{ Shot.BeamEnd - WeaponTraceStart };
+	return WeaponTraceStart + StartToEnd * 1.25f;
+}
+
+void UHitscanSubsystem::SubmitPendingShots()
+{
+	if (PendingShots.Num() == 0) return;
+	SCOPE_CYCLE_COUNTER(STAT_HitscanSubmitBatch);
+	UWorld* World = GetWorld();
+	if (World == nullptr) return;
+	for (FHitscanShot& Shot : PendingShots)
+	{
+		const uint32 ShotId = NextShotId++;
+		SubmitBarrelTrace(World, Shot, &BarrelTraceDelegate, ShotId);
+		InFlightShots.Add(ShotId, MoveTemp(Shot));
+	}
+	INC_DWORD_STAT_BY(STAT_HitscanTracesSubmitted, PendingShots.Num());
+	PendingShots.Reset();
+}
+
+void UHitscanSubsystem::OnBarrelTraceComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	FHitscanShot Shot;
+	if (!InFlightShots.RemoveAndCopyValue(TraceDatum.UserData, Shot)) return;
+	const bool bBlockingHit = TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit;
+	ApplyShot(Shot, bBlockingHit ? TraceDatum.OutHits[0] : FHitResult(), bBlockingHit);
+}
+
+void UHitscanSubsystem::ApplyShot(const FHitscanShot& Shot, const FHitResult& BeamHitResult, bool bBlockingHit)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HitscanApplyShot);
+	//No object between weapon barrel and beam end point
+	if (!bBlockingHit) return;
+	AArcoroxCharacter* Shooter = Shot.Shooter.Get();
+	if (Shooter) Shooter->ApplyBulletHit(Shot.SocketTransform, BeamHitResult, Shot.Damage, Shot.ZoneMultipliers);
+}
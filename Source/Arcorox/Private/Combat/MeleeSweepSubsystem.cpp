@@ -0,0 +1,178 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/MeleeSweepSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Characters/ArcoroxCharacter.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Melee Submit Sweeps"), STAT_MeleeSubmitSweeps, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Melee Apply Hits"), STAT_MeleeApplyHits, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Melee Sweeps Submitted"), STAT_MeleeSweepsSubmitted, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Melee Hits"), STAT_MeleeHits, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<bool> CVarMeleeAsync(
+	TEXT("arcorox.Melee.Async"),
+	true,
+	TEXT("Resolve enemy weapon sweeps with batched async scene queries (1) or synchronous sweeps on the game thread (0)."));
+
+static TAutoConsoleVariable<float> CVarMeleeMaxSweepAngle(
+	TEXT("arcorox.Melee.MaxSweepAngle"),
+	15.f,
+	TEXT("Largest blade rotation in degrees covered by one sweep, faster swings are split into more sweeps along the arc."));
+
+/* Upper bound on sweeps per swing per frame, however far the blade turned */
+static const int32 MaxSweepSteps = 8;
+
+void UMeleeSweepSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SweepDelegate.BindUObject(this, &UMeleeSweepSubsystem::OnSweepComplete);
+}
+
+void UMeleeSweepSubsystem::Deinitialize()
+{
+	Swings.Empty();
+	SweepDelegate.Unbind();
+
+	Super::Deinitialize();
+}
+
+void UMeleeSweepSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SubmitSweeps();
+}
+
+TStatId UMeleeSweepSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMeleeSweepSubsystem, STATGROUP_Tickables);
+}
+
+bool UMeleeSweepSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+uint32 UMeleeSweepSubsystem::BeginSwing(AEnemy* Attacker, const FName& BaseSocket, const FName& TipSocket, float Radius)
+{
+	if (Attacker == nullptr || Attacker->GetMesh() == nullptr) return 0;
+	const uint32 SwingId = NextSwingId++;
+	FMeleeSwing& Swing = Swings.Add(SwingId);
+	Swing.Attacker = Attacker;
+	Swing.BaseSocket = BaseSocket;
+	Swing.TipSocket = TipSocket;
+	Swing.Radius = Radius;
+	Swing.PreviousBase = Attacker->GetMesh()->GetSocketLocation(BaseSocket);
+	Swing.PreviousTip = Attacker->GetMesh()->GetSocketLocation(TipSocket);
+	return SwingId;
+}
+
+void UMeleeSweepSubsystem::EndSwing(uint32 SwingId)
+{
+	FMeleeSwing* Swing = Swings.Find(SwingId);
+	if (Swing == nullptr) return;
+	if (Swing->NumInFlight > 0) Swing->bOpen = false;
+	else Swings.Remove(SwingId);
+}
+
+void UMeleeSweepSubsystem::GetWeaponCapsule(const FVector& Base, const FVector& Tip, float Radius, FVector& OutCenter, FQuat& OutRotation, FCollisionShape& OutShape)
+{
+	const FVector Blade{ Tip - Base };
+	OutCenter = Base + Blade * 0.5f;
+	OutRotation = FRotationMatrix::MakeFromZ(Blade.IsNearlyZero() ? FVector::UpVector : Blade).ToQuat();
+	OutShape = FCollisionShape::MakeCapsule(Radius, Blade.Size() * 0.5f + Radius);
+}
+
+void UMeleeSweepSubsystem::SubmitSweeps()
+{
+	if (Swings.Num() == 0) return;
+	SCOPE_CYCLE_COUNTER(STAT_MeleeSubmitSweeps);
+	UWorld* World = GetWorld();
+	const bool bAsync = CVarMeleeAsync.GetValueOnGameThread();
+	const FCollisionObjectQueryParams ObjectParams{ ECollisionChannel::ECC_Pawn };
+	TArray<TPair<uint32, TArray<FHitResult>>> SyncHits;
+	for (auto It = Swings.CreateIterator(); It; ++It)
+	{
+		FMeleeSwing& Swing = It.Value();
+		AEnemy* Attacker = Swing.Attacker.Get();
+		if (Attacker == nullptr || Attacker->GetMesh() == nullptr)
+		{
+			if (Swing.NumInFlight == 0) It.RemoveCurrent();
+			continue;
+		}
+		if (!Swing.bOpen) continue;
+
+		//Sweeping the capsule from last frame's pose to this frame's catches swings faster than the target is thick
+		const FVector Base{ Attacker->GetMesh()->GetSocketLocation(Swing.BaseSocket) };
+		const FVector Tip{ Attacker->GetMesh()->GetSocketLocation(Swing.TipSocket) };
+		//One sweep has a single rotation, so wide arcs are split into steps that each turn the blade a little
+		const FVector PreviousBlade{ (Swing.PreviousTip - Swing.PreviousBase).GetSafeNormal() };
+		const FVector Blade{ (Tip - Base).GetSafeNormal() };
+		const float Angle = FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(FVector::DotProduct(PreviousBlade, Blade), -1.f, 1.f)));
+		const float MaxAngle = FMath::Max(CVarMeleeMaxSweepAngle.GetValueOnGameThread(), 1.f);
+		const int32 NumSteps = FMath::Clamp(FMath::CeilToInt(Angle / MaxAngle), 1, MaxSweepSteps);
+		FCollisionQueryParams QueryParams{ SCENE_QUERY_STAT(MeleeSweep), false, Attacker };
+		TArray<FHitResult> Hits;
+		for (int32 Step = 1; Step <= NumSteps; Step++)
+		{
+			const float StartAlpha = static_cast<float>(Step - 1) / NumSteps;
+			const float EndAlpha = static_cast<float>(Step) / NumSteps;
+			FVector Start, End;
+			FQuat StartRotation, EndRotation;
+			FCollisionShape Shape;
+			GetWeaponCapsule(FMath::Lerp(Swing.PreviousBase, Base, StartAlpha), FMath::Lerp(Swing.PreviousTip, Tip, StartAlpha), Swing.Radius, Start, StartRotation, Shape);
+			GetWeaponCapsule(FMath::Lerp(Swing.PreviousBase, Base, EndAlpha), FMath::Lerp(Swing.PreviousTip, Tip, EndAlpha), Swing.Radius, End, EndRotation, Shape);
+			const FQuat Rotation{ FQuat::Slerp(StartRotation, EndRotation, 0.5f) };
+			if (bAsync)
+			{
+				World->AsyncSweepByObjectType(EAsyncTraceType::Multi, Start, End, Rotation, ObjectParams, Shape, QueryParams, &SweepDelegate, It.Key());
+				Swing.NumInFlight++;
+			}
+			else
+			{
+				TArray<FHitResult> StepHits;
+				World->SweepMultiByObjectType(StepHits, Start, End, Rotation, ObjectParams, Shape, QueryParams);
+				Hits.Append(StepHits);
+			}
+			INC_DWORD_STAT(STAT_MeleeSweepsSubmitted);
+		}
+		Swing.PreviousBase = Base;
+		Swing.PreviousTip = Tip;
+		if (Hits.Num() > 0) SyncHits.Emplace(It.Key(), MoveTemp(Hits));
+	}
+	//Applied after the loop since damage can end swings
+	for (const TPair<uint32, TArray<FHitResult>>& Hits : SyncHits) ApplyHits(Hits.Key, Hits.Value);
+}
+
+void UMeleeSweepSubsystem::OnSweepComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const uint32 SwingId = TraceDatum.UserData;
+	FMeleeSwing* Swing = Swings.Find(SwingId);
+	if (Swing == nullptr) return;
+	Swing->NumInFlight--;
+	ApplyHits(SwingId, TraceDatum.OutHits);
+	Swing = Swings.Find(SwingId);
+	if (Swing && !Swing->bOpen && Swing->NumInFlight <= 0) Swings.Remove(SwingId);
+}
+
+void UMeleeSweepSubsystem::ApplyHits(uint32 SwingId, const TArray<FHitResult>& Hits)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MeleeApplyHits);
+	for (const FHitResult& Hit : Hits)
+	{
+		//Looked up per hit since the attacker reacting to damage can close the swing
+		FMeleeSwing* Swing = Swings.Find(SwingId);
+		AEnemy* Attacker = Swing ? Swing->Attacker.Get() : nullptr;
+		if (Attacker == nullptr || Attacker->IsDead()) return;
+		AArcoroxCharacter* ArcoroxCharacter = Cast<AArcoroxCharacter>(Hit.GetActor());
+		if (ArcoroxCharacter == nullptr || Swing->HitActors.Contains(ArcoroxCharacter)) continue;
+		Swing->HitActors.Add(ArcoroxCharacter);
+		INC_DWORD_STAT(STAT_MeleeHits);
+		Attacker->ApplyMeleeHit(ArcoroxCharacter, Swing->TipSocket, Hit);
+	}
+}
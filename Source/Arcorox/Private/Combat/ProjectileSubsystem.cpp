@@ -0,0 +1,378 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/ProjectileSubsystem.h"
+#include "Characters/ArcoroxCharacter.h"
+#include "Items/Weapon.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Integrate"), STAT_ProjectileIntegrate, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Projectile Submit Traces"), STAT_ProjectileSubmitTraces, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Projectile Impacts"), STAT_ProjectileImpacts, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Projectile Visuals"), STAT_ProjectileVisuals, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectile Traces"), STAT_ProjectileTraces, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectiles Live"), STAT_ProjectilesLive, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<bool> CVarProjectileAsync(
+	TEXT("arcorox.Projectile.Async"),
+	true,
+	TEXT("Trace projectile paths with batched async scene queries (1) or synchronous traces on the game thread (0)."));
+
+static TAutoConsoleVariable<bool> CVarProjectileVisuals(
+	TEXT("arcorox.Projectile.Visuals"),
+	true,
+	TEXT("Draw the projectile mesh of each projectile in flight (1) or only the impact effects (0). Applies to projectiles fired afterward."));
+
+static void SpawnProjectilesCommand(const TArray<FString>& Args, UWorld* World)
+{
+	UProjectileSubsystem* Projectiles = World ? World->GetSubsystem<UProjectileSubsystem>() : nullptr;
+	APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	if (Projectiles == nullptr) return;
+	const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000;
+	const float Speed = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 20000.f;
+	//Headless runs may have no pawn, the world origin works as well
+	const FVector Origin = PlayerController && PlayerController->GetPawn() ? PlayerController->GetPawn()->GetActorLocation() : FVector::ZeroVector;
+	Projectiles->SpawnTestProjectiles(Count, Origin, Speed);
+}
+
+static void LogProjectilesCommand(UWorld* World)
+{
+	if (UProjectileSubsystem* Projectiles = World ? World->GetSubsystem<UProjectileSubsystem>() : nullptr) Projectiles->LogProjectileReport();
+}
+
+static FAutoConsoleCommandWithWorldAndArgs SpawnProjectilesConsoleCommand(
+	TEXT("arcorox.Projectile.Spawn"),
+	TEXT("Adds test projectiles flying upward from the player. Usage: arcorox.Projectile.Spawn <Count> <Speed>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&SpawnProjectilesCommand));
+
+static FAutoConsoleCommandWithWorld LogProjectilesConsoleCommand(
+	TEXT("arcorox.Projectile.Report"),
+	TEXT("Logs live projectiles, traces per frame and the average and worst frame cost against the trace budget."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&LogProjectilesCommand));
+
+UProjectileSubsystem::UProjectileSubsystem() :
+	MaxProjectiles(16384),
+	SubstepTime(1.f / 60.f),
+	MaxSubsteps(4),
+	TraceBudgetMs(2.f),
+	SubstepRemainder(0.f),
+	TraceCursor(0),
+	NumFrames(0),
+	NumTraces(0),
+	TotalFrameMs(0.0),
+	MaxFrameMs(0.0)
+{
+
+}
+
+void UProjectileSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TraceDelegate.BindUObject(this, &UProjectileSubsystem::OnTraceComplete);
+}
+
+void UProjectileSubsystem::Deinitialize()
+{
+	for (int32 i = 0; i < Dead.Num(); i++) Dead[i] = true;
+	RemoveDeadProjectiles();
+	PendingImpacts.Empty();
+	TraceDelegate.Unbind();
+	for (UInstancedStaticMeshComponent* Component : VisualComponents)
+	{
+		if (Component) Component->DestroyComponent();
+	}
+	VisualComponents.Empty();
+	VisualTransforms.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSubsystem, STATGROUP_Tickables);
+}
+
+bool UProjectileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UProjectileSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (PositionX.Num() == 0 && PendingImpacts.Num() == 0)
+	{
+		//The last projectiles were removed last frame, their instances still need clearing
+		UpdateVisuals();
+		return;
+	}
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	//Traces submitted last frame have resolved by now, their indices are still valid until the dead are removed
+	ResolveImpacts();
+	RemoveDeadProjectiles();
+	Integrate(DeltaTime);
+	SubmitTraces();
+	if (!CVarProjectileAsync.GetValueOnGameThread()) ResolveImpacts();
+	UpdateVisuals();
+
+	const double FrameMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+	NumFrames++;
+	TotalFrameMs += FrameMs;
+	MaxFrameMs = FMath::Max(MaxFrameMs, FrameMs);
+}
+
+bool UProjectileSubsystem::FireProjectile(AArcoroxCharacter* Shooter, const FTransform& SocketTransform, const FVector& Target, float Damage, const FHitZoneMultipliers& ZoneMultipliers, const FWeaponTypeTable& Weapon)
+{
+	if (PositionX.Num() >= MaxProjectiles) return false;
+	const FVector Start{ SocketTransform.GetLocation() };
+	FVector Direction{ (Target - Start).GetSafeNormal() };
+	if (Direction.IsZero()) Direction = SocketTransform.GetRotation().GetForwardVector();
+	FProjectileInfo Info;
+	Info.Shooter = Shooter;
+	Info.Damage = Damage;
+	Info.ZoneMultipliers = ZoneMultipliers;
+	AddProjectile(Start, Direction * Weapon.ProjectileSpeed, GetWorld()->GetGravityZ() * Weapon.ProjectileGravityScale, Weapon.ProjectileDrag, Weapon.ProjectileLifetime, Weapon.ProjectileMesh, MoveTemp(Info));
+	return true;
+}
+
+void UProjectileSubsystem::SpawnTestProjectiles(int32 Count, const FVector& Origin, float Speed, UStaticMesh* Mesh)
+{
+	const float WorldGravityZ = GetWorld()->GetGravityZ();
+	for (int32 i = 0; i < Count && PositionX.Num() < MaxProjectiles; i++)
+	{
+		FVector Direction{ FMath::VRand() };
+		Direction.Z = FMath::Abs(Direction.Z);
+		AddProjectile(Origin + FVector(0.f, 0.f, 100.f), Direction * Speed, WorldGravityZ, 0.00001f, 10.f, Mesh, FProjectileInfo());
+	}
+	NumFrames = 0;
+	NumTraces = 0;
+	TotalFrameMs = 0.0;
+	MaxFrameMs = 0.0;
+}
+
+void UProjectileSubsystem::AddProjectile(const FVector& Location, const FVector& Velocity, float InGravityZ, float InDrag, float InLifetime, UStaticMesh* Mesh, FProjectileInfo&& Info)
+{
+	PositionX.Add(Location.X);
+	PositionY.Add(Location.Y);
+	PositionZ.Add(Location.Z);
+	VelocityX.Add(Velocity.X);
+	VelocityY.Add(Velocity.Y);
+	VelocityZ.Add(Velocity.Z);
+	GravityZ.Add(InGravityZ);
+	Drag.Add(InDrag);
+	Age.Add(0.f);
+	Lifetime.Add(InLifetime);
+	VisualGroups.Add(GetVisualGroup(Mesh));
+	TraceStarts.Add(Location);
+	Infos.Add(MoveTemp(Info));
+	Dead.Add(false);
+	INC_DWORD_STAT(STAT_ProjectilesLive);
+}
+
+void UProjectileSubsystem::ResolveImpacts()
+{
+	if (PendingImpacts.Num() == 0) return;
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileImpacts);
+	for (const TPair<int32, FHitResult>& Impact : PendingImpacts)
+	{
+		if (!Dead.IsValidIndex(Impact.Key) || Dead[Impact.Key]) continue;
+		Dead[Impact.Key] = true;
+		const FProjectileInfo& Info = Infos[Impact.Key];
+		//The beam covers the segment the projectile hit in, the in-flight mesh drew the path before it
+		const FHitResult& Hit = Impact.Value;
+		const FTransform SegmentStart{ (Hit.TraceEnd - Hit.TraceStart).Rotation(), Hit.TraceStart };
+		//Same damage and hit interface path as hitscan shots
+		if (AArcoroxCharacter* Shooter = Info.Shooter.Get()) Shooter->ApplyBulletHit(SegmentStart, Hit, Info.Damage, Info.ZoneMultipliers);
+	}
+	PendingImpacts.Reset();
+}
+
+void UProjectileSubsystem::RemoveDeadProjectiles()
+{
+	for (int32 i = Dead.Num() - 1; i >= 0; i--)
+	{
+		//Expired projectiles stay until the segment up to where their lifetime ended has been traced
+		const bool bExpired = Age[i] >= Lifetime[i] - KINDA_SMALL_NUMBER && TraceStarts[i].Equals(FVector(PositionX[i], PositionY[i], PositionZ[i]));
+		if (!Dead[i] && !bExpired) continue;
+		PositionX.RemoveAtSwap(i, 1, false);
+		PositionY.RemoveAtSwap(i, 1, false);
+		PositionZ.RemoveAtSwap(i, 1, false);
+		VelocityX.RemoveAtSwap(i, 1, false);
+		VelocityY.RemoveAtSwap(i, 1, false);
+		VelocityZ.RemoveAtSwap(i, 1, false);
+		GravityZ.RemoveAtSwap(i, 1, false);
+		Drag.RemoveAtSwap(i, 1, false);
+		Age.RemoveAtSwap(i, 1, false);
+		Lifetime.RemoveAtSwap(i, 1, false);
+		VisualGroups.RemoveAtSwap(i, 1, false);
+		TraceStarts.RemoveAtSwap(i, 1, false);
+		Infos.RemoveAtSwap(i, 1, false);
+		Dead.RemoveAtSwap(i, 1, false);
+		DEC_DWORD_STAT(STAT_ProjectilesLive);
+	}
+}
+
+void UProjectileSubsystem::Integrate(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileIntegrate);
+	//Fixed substeps keep trajectories independent of frame rate, long frames stretch the substeps instead of adding more
+	const float FrameTime = DeltaTime + SubstepRemainder;
+	int32 NumSteps = FMath::FloorToInt(FrameTime / SubstepTime);
+	float StepTime = SubstepTime;
+	SubstepRemainder = FrameTime - NumSteps * SubstepTime;
+	if (NumSteps > MaxSubsteps)
+	{
+		NumSteps = MaxSubsteps;
+		StepTime = FrameTime / MaxSubsteps;
+		SubstepRemainder = 0.f;
+	}
+	const int32 Num = PositionX.Num();
+	const int32 NumVectorized = Num & ~3;
+
+	for (int32 Step = 0; Step < NumSteps; Step++)
+	{
+		//Semi-implicit Euler with quadratic drag, v *= max(0, 1 - Drag * |v| * dt), v.z += g * dt, p += v * dt
+		//Each lane's step is clamped to its remaining lifetime, so an expiring projectile stops where its lifetime ends
+		const VectorRegister4Float StepDt = VectorSetFloat1(StepTime);
+		for (int32 i = 0; i < NumVectorized; i += 4)
+		{
+			const VectorRegister4Float Dt = VectorMin(StepDt, VectorMax(VectorSubtract(VectorLoad(&Lifetime[i]), VectorLoad(&Age[i])), GlobalVectorConstants::FloatZero));
+			VectorRegister4Float VX = VectorLoad(&VelocityX[i]);
+			VectorRegister4Float VY = VectorLoad(&VelocityY[i]);
+			VectorRegister4Float VZ = VectorLoad(&VelocityZ[i]);
+			const VectorRegister4Float Speed = VectorSqrt(VectorMultiplyAdd(VX, VX, VectorMultiplyAdd(VY, VY, VectorMultiply(VZ, VZ))));
+			const VectorRegister4Float DragFactor = VectorMax(VectorSubtract(GlobalVectorConstants::FloatOne, VectorMultiply(VectorMultiply(VectorLoad(&Drag[i]), Speed), Dt)), GlobalVectorConstants::FloatZero);
+			VX = VectorMultiply(VX, DragFactor);
+			VY = VectorMultiply(VY, DragFactor);
+			VZ = VectorMultiplyAdd(VectorLoad(&GravityZ[i]), Dt, VectorMultiply(VZ, DragFactor));
+			VectorStore(VX, &VelocityX[i]);
+			VectorStore(VY, &VelocityY[i]);
+			VectorStore(VZ, &VelocityZ[i]);
+			VectorStore(VectorMultiplyAdd(VX, Dt, VectorLoad(&PositionX[i])), &PositionX[i]);
+			VectorStore(VectorMultiplyAdd(VY, Dt, VectorLoad(&PositionY[i])), &PositionY[i]);
+			VectorStore(VectorMultiplyAdd(VZ, Dt, VectorLoad(&PositionZ[i])), &PositionZ[i]);
+			VectorStore(VectorAdd(VectorLoad(&Age[i]), Dt), &Age[i]);
+		}
+		for (int32 i = NumVectorized; i < Num; i++)
+		{
+			const float Dt = FMath::Clamp(Lifetime[i] - Age[i], 0.f, StepTime);
+			const float Speed = FMath::Sqrt(VelocityX[i] * VelocityX[i] + VelocityY[i] * VelocityY[i] + VelocityZ[i] * VelocityZ[i]);
+			const float DragFactor = FMath::Max(1.f - Drag[i] * Speed * Dt, 0.f);
+			VelocityX[i] *= DragFactor;
+			VelocityY[i] *= DragFactor;
+			VelocityZ[i] = VelocityZ[i] * DragFactor + GravityZ[i] * Dt;
+			PositionX[i] += VelocityX[i] * Dt;
+			PositionY[i] += VelocityY[i] * Dt;
+			PositionZ[i] += VelocityZ[i] * Dt;
+			Age[i] += Dt;
+		}
+	}
+}
+
+void UProjectileSubsystem::SubmitTraces()
+{
+	const int32 Num = PositionX.Num();
+	if (Num == 0) return;
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileSubmitTraces);
+	UWorld* World = GetWorld();
+	const bool bAsync = CVarProjectileAsync.GetValueOnGameThread();
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	const FCollisionQueryParams QueryParams{ SCENE_QUERY_STAT(ProjectileTrace), false };
+	if (TraceCursor >= Num) TraceCursor = 0;
+	int32 NumSubmitted = 0;
+	int32 NumVisited = 0;
+	for (; NumVisited < Num; NumVisited++)
+	{
+		//Checking the clock every few traces keeps its cost out of the loop
+		if ((NumVisited & 63) == 63 && FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) >= TraceBudgetMs) break;
+		const int32 i = (TraceCursor + NumVisited) % Num;
+		if (Dead[i]) continue;
+		const FVector End{ PositionX[i], PositionY[i], PositionZ[i] };
+		const FVector Start{ TraceStarts[i] };
+		if (Start.Equals(End)) continue;
+		TraceStarts[i] = End;
+		NumSubmitted++;
+		if (bAsync)
+		{
+			World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ECollisionChannel::ECC_Visibility, QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, i);
+			continue;
+		}
+		FHitResult Hit;
+		if (World->LineTraceSingleByChannel(Hit, Start, End, ECollisionChannel::ECC_Visibility, QueryParams)) PendingImpacts.Add(i, Hit);
+	}
+	TraceCursor = (TraceCursor + NumVisited) % Num;
+	NumTraces += NumSubmitted;
+	INC_DWORD_STAT_BY(STAT_ProjectileTraces, NumSubmitted);
+}
+
+void UProjectileSubsystem::OnTraceComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	if (TraceDatum.OutHits.Num() == 0 || !TraceDatum.OutHits[0].bBlockingHit) return;
+	PendingImpacts.Add(static_cast<int32>(TraceDatum.UserData), TraceDatum.OutHits[0]);
+}
+
+int32 UProjectileSubsystem::GetVisualGroup(UStaticMesh* Mesh)
+{
+	//Headless servers have nothing to draw
+	if (Mesh == nullptr || !CVarProjectileVisuals.GetValueOnGameThread() || GetWorld()->GetNetMode() == NM_DedicatedServer) return INDEX_NONE;
+	for (int32 Group = 0; Group < VisualComponents.Num(); Group++)
+	{
+		if (VisualComponents[Group]->GetStaticMesh() == Mesh) return Group;
+	}
+	//Outered to the world settings like the combat effect components, instances are placed in world space
+	UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(GetWorld()->GetWorldSettings());
+	Component->SetStaticMesh(Mesh);
+	Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Component->SetCastShadow(false);
+	Component->SetAbsolute(true, true, true);
+	Component->RegisterComponentWithWorld(GetWorld());
+	VisualTransforms.AddDefaulted();
+	return VisualComponents.Add(Component);
+}
+
+void UProjectileSubsystem::UpdateVisuals()
+{
+	if (VisualComponents.Num() == 0) return;
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileVisuals);
+	for (TArray<FTransform>& Transforms : VisualTransforms) Transforms.Reset();
+	for (int32 i = 0; i < PositionX.Num(); i++)
+	{
+		if (VisualGroups[i] == INDEX_NONE || Dead[i]) continue;
+		const FVector Velocity{ VelocityX[i], VelocityY[i], VelocityZ[i] };
+		VisualTransforms[VisualGroups[i]].Emplace(Velocity.ToOrientationQuat(), FVector(PositionX[i], PositionY[i], PositionZ[i]));
+	}
+	//Instances are matched to projectiles by order each frame, only the count changes are added or removed at the end
+	for (int32 Group = 0; Group < VisualComponents.Num(); Group++)
+	{
+		UInstancedStaticMeshComponent* Component = VisualComponents[Group];
+		const TArray<FTransform>& Transforms = VisualTransforms[Group];
+		const int32 NumInstances = Component->GetInstanceCount();
+		if (Transforms.Num() > NumInstances)
+		{
+			Component->AddInstances(TArray<FTransform>(Transforms.GetData() + NumInstances, Transforms.Num() - NumInstances), false, true);
+		}
+		else if (Transforms.Num() < NumInstances)
+		{
+			TArray<int32> Removed;
+			for (int32 Instance = NumInstances - 1; Instance >= Transforms.Num(); Instance--) Removed.Add(Instance);
+			Component->RemoveInstances(Removed);
+		}
+		if (Transforms.Num() > 0) Component->BatchUpdateInstancesTransforms(0, Transforms, true, true, false);
+	}
+}
+
+void UProjectileSubsystem::LogProjectileReport() const
+{
+	const double AverageMs = NumFrames > 0 ? TotalFrameMs / NumFrames : 0.0;
+	const double TracesPerFrame = NumFrames > 0 ? static_cast<double>(NumTraces) / NumFrames : 0.0;
+	UE_LOG(LogArcorox, Display, TEXT("Projectiles: %d live of %d, %s traces, substep %.4f s, trace budget %.2f ms"), PositionX.Num(), MaxProjectiles,
+		CVarProjectileAsync.GetValueOnGameThread() ? TEXT("async") : TEXT("sync"), SubstepTime, TraceBudgetMs);
+	UE_LOG(LogArcorox, Display, TEXT("  %llu frames, %.3f ms average, %.3f ms worst, %.0f traces per frame, game thread: %.2f ms"), NumFrames, AverageMs, MaxFrameMs, TracesPerFrame, FPlatformTime::ToMilliseconds(GGameThreadTime));
+}
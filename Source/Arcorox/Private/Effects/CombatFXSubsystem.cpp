@@ -0,0 +1,229 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Effects/CombatFXSubsystem.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Combat FX Spawn"), STAT_CombatFXSpawn, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat FX Requested"), STAT_CombatFXRequested, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat FX Played"), STAT_CombatFXPlayed, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat FX Culled"), STAT_CombatFXCulled, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat FX Recycled"), STAT_CombatFXRecycled, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat FX Allocated"), STAT_CombatFXAllocated, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Combat FX Components"), STAT_CombatFXComponents, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Combat FX Active"), STAT_CombatFXActive, STATGROUP_Arcorox);
+
+static FCombatFXBudget MakeBudget(int32 PrewarmCount, int32 MaxActive, float CullDistance)
+{
+	FCombatFXBudget Budget;
+	Budget.PrewarmCount = PrewarmCount;
+	Budget.MaxActive = MaxActive;
+	Budget.CullDistance = CullDistance;
+	return Budget;
+}
+
+static void LogCombatFX(UWorld* World)
+{
+	if (UCombatFXSubsystem* CombatFX = World ? World->GetSubsystem<UCombatFXSubsystem>() : nullptr) CombatFX->LogFXReport();
+}
+
+static FAutoConsoleCommandWithWorld LogCombatFXCommand(
+	TEXT("arcorox.FX.Report"),
+	TEXT("Logs pooled and active combat effect components per effect type."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&LogCombatFX));
+
+UCombatFXSubsystem::UCombatFXSubsystem() :
+	MaxActiveTotal(64),
+	CullDistanceWeight(0.001f),
+	NumActiveTotal(0)
+{
+	//Defaults indexed by ECombatFXType, overridable from the [/Script/Arcorox.CombatFXSubsystem] section of DefaultGame.ini
+	Budgets.Add(MakeBudget(4, 4, 0.f));
+	Budgets.Add(MakeBudget(8, 8, 0.f));
+	Budgets.Add(MakeBudget(16, 24, 8000.f));
+	Budgets.Add(MakeBudget(8, 16, 6000.f));
+	Budgets.Add(MakeBudget(2, 6, 0.f));
+}
+
+void UCombatFXSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Pools.SetNum(static_cast<int32>(ECombatFXType::ECFX_MAX));
+}
+
+void UCombatFXSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (int32 TypeIndex = 0; TypeIndex < Pools.Num(); TypeIndex++)
+	{
+		const int32 PrewarmCount = Budgets.IsValidIndex(TypeIndex) ? Budgets[TypeIndex].PrewarmCount : 0;
+		while (Pools[TypeIndex].Slots.Num() < PrewarmCount) AddSlot(TypeIndex);
+	}
+}
+
+void UCombatFXSubsystem::Deinitialize()
+{
+	for (UParticleSystemComponent* Component : Components)
+	{
+		if (IsValid(Component)) Component->DestroyComponent();
+	}
+	DEC_DWORD_STAT_BY(STAT_CombatFXComponents, Components.Num());
+	DEC_DWORD_STAT_BY(STAT_CombatFXActive, NumActiveTotal);
+	Components.Empty();
+	Pools.Empty();
+	ComponentSlots.Empty();
+	NumActiveTotal = 0;
+
+	Super::Deinitialize();
+}
+
+bool UCombatFXSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UCombatFXSubsystem::AddSlot(int32 TypeIndex)
+{
+	//Outered to the world settings like the components UGameplayStatics spawns, but never auto destroyed
+	UParticleSystemComponent* Component = NewObject<UParticleSystemComponent>(GetWorld()->GetWorldSettings());
+	Component->bAutoActivate = false;
+	Component->bAutoDestroy = false;
+	Component->SetAbsolute(true, true, true);
+	Component->OnSystemFinished.AddDynamic(this, &UCombatFXSubsystem::OnEffectFinished);
+	Component->RegisterComponentWithWorld(GetWorld());
+	Components.Add(Component);
+	INC_DWORD_STAT(STAT_CombatFXComponents);
+
+	const int32 SlotIndex = Pools[TypeIndex].Slots.Add(FCombatFXSlot{ Component, 0.f, false });
+	ComponentSlots.Add(Component, FIntPoint(TypeIndex, SlotIndex));
+	return SlotIndex;
+}
+
+UParticleSystemComponent* UCombatFXSubsystem::SpawnEffectAt(const UObject* WorldContextObject, ECombatFXType Type, UParticleSystem* Template, const FTransform& Transform)
+{
+	if (Template == nullptr || WorldContextObject == nullptr) return nullptr;
+	UWorld* World = WorldContextObject->GetWorld();
+	UCombatFXSubsystem* CombatFX = World ? World->GetSubsystem<UCombatFXSubsystem>() : nullptr;
+	if (CombatFX) return CombatFX->SpawnEffect(Type, Template, Transform);
+	return UGameplayStatics::SpawnEmitterAtLocation(World, Template, Transform);
+}
+
+UParticleSystemComponent* UCombatFXSubsystem::SpawnEffect(ECombatFXType Type, UParticleSystem* Template, const FTransform& Transform)
+{
+	const int32 TypeIndex = static_cast<int32>(Type);
+	if (Template == nullptr || !Pools.IsValidIndex(TypeIndex)) return nullptr;
+	SCOPE_CYCLE_COUNTER(STAT_CombatFXSpawn);
+	INC_DWORD_STAT(STAT_CombatFXRequested);
+	const FCombatFXBudget Budget{ Budgets.IsValidIndex(TypeIndex) ? Budgets[TypeIndex] : FCombatFXBudget() };
+
+	FVector ViewLocation{ Transform.GetLocation() };
+	FRotator ViewRotation;
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (PlayerController) PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+	if (Budget.CullDistance > 0.f && FVector::DistSquared(ViewLocation, Transform.GetLocation()) > FMath::Square(Budget.CullDistance))
+	{
+		INC_DWORD_STAT(STAT_CombatFXCulled);
+		return nullptr;
+	}
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	FCombatFXPool& Pool = Pools[TypeIndex];
+	if (Pool.NumActive >= Budget.MaxActive || NumActiveTotal >= MaxActiveTotal)
+	{
+		//Over the type budget recycle within the type, over the global budget recycle the worst effect of any type
+		int32 VictimType = TypeIndex;
+		float VictimScore = -1.f;
+		int32 VictimSlot = FindCullVictim(TypeIndex, ViewLocation, Now, VictimScore);
+		if (Pool.NumActive < Budget.MaxActive)
+		{
+			for (int32 OtherType = 0; OtherType < Pools.Num(); OtherType++)
+			{
+				float Score;
+				const int32 Slot = FindCullVictim(OtherType, ViewLocation, Now, Score);
+				if (Slot == INDEX_NONE || Score <= VictimScore) continue;
+				VictimType = OtherType;
+				VictimSlot = Slot;
+				VictimScore = Score;
+			}
+		}
+		if (VictimSlot == INDEX_NONE)
+		{
+			INC_DWORD_STAT(STAT_CombatFXCulled);
+			return nullptr;
+		}
+		DeactivateSlot(VictimType, VictimSlot);
+		INC_DWORD_STAT(STAT_CombatFXRecycled);
+	}
+
+	int32 SlotIndex = Pool.Slots.IndexOfByPredicate([](const FCombatFXSlot& Slot) { return !Slot.bActive; });
+	if (SlotIndex == INDEX_NONE)
+	{
+		SlotIndex = AddSlot(TypeIndex);
+		INC_DWORD_STAT(STAT_CombatFXAllocated);
+	}
+	FCombatFXSlot& Slot = Pool.Slots[SlotIndex];
+	if (Slot.Component->Template != Template) Slot.Component->SetTemplate(Template);
+	Slot.Component->SetWorldTransform(Transform);
+	Slot.Component->ActivateSystem(true);
+	Slot.StartTime = Now;
+	Slot.bActive = true;
+	Pool.NumActive++;
+	NumActiveTotal++;
+	INC_DWORD_STAT(STAT_CombatFXPlayed);
+	INC_DWORD_STAT(STAT_CombatFXActive);
+	return Slot.Component;
+}
+
+int32 UCombatFXSubsystem::FindCullVictim(int32 TypeIndex, const FVector& ViewLocation, float Now, float& OutScore) const
+{
+	int32 Victim = INDEX_NONE;
+	OutScore = -1.f;
+	const TArray<FCombatFXSlot>& Slots = Pools[TypeIndex].Slots;
+	for (int32 i = 0; i < Slots.Num(); i++)
+	{
+		if (!Slots[i].bActive) continue;
+		const float Score = (Now - Slots[i].StartTime) + FVector::Dist(ViewLocation, Slots[i].Component->GetComponentLocation()) * CullDistanceWeight;
+		if (Score <= OutScore) continue;
+		OutScore = Score;
+		Victim = i;
+	}
+	return Victim;
+}
+
+void UCombatFXSubsystem::DeactivateSlot(int32 TypeIndex, int32 SlotIndex)
+{
+	FCombatFXSlot& Slot = Pools[TypeIndex].Slots[SlotIndex];
+	if (!Slot.bActive) return;
+	//Cleared first so the finished callback fired by the deactivation is ignored
+	Slot.bActive = false;
+	Pools[TypeIndex].NumActive--;
+	NumActiveTotal--;
+	DEC_DWORD_STAT(STAT_CombatFXActive);
+	Slot.Component->DeactivateImmediate();
+}
+
+void UCombatFXSubsystem::OnEffectFinished(UParticleSystemComponent* Component)
+{
+	const FIntPoint* Location = ComponentSlots.Find(Component);
+	if (Location) DeactivateSlot(Location->X, Location->Y);
+}
+
+void UCombatFXSubsystem::LogFXReport() const
+{
+	const UEnum* TypeEnum = StaticEnum<ECombatFXType>();
+	UE_LOG(LogArcorox, Display, TEXT("Combat FX components: %d, active: %d / %d"), Components.Num(), NumActiveTotal, MaxActiveTotal);
+	for (int32 TypeIndex = 0; TypeIndex < Pools.Num(); TypeIndex++)
+	{
+		const int32 MaxActive = Budgets.IsValidIndex(TypeIndex) ? Budgets[TypeIndex].MaxActive : 0;
+		UE_LOG(LogArcorox, Display, TEXT("  %s: %d pooled, %d / %d active"), *TypeEnum->GetDisplayNameTextByIndex(TypeIndex).ToString(), Pools[TypeIndex].Slots.Num(), Pools[TypeIndex].NumActive, MaxActive);
+	}
+}
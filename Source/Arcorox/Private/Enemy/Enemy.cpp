@@ -3,171 +3,322 @@
 
 #include "Enemy/Enemy.h"
 #include "Enemy/EnemyController.h"
+#include "Enemy/EnemyAnimInstance.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Animation/AnimMontage.h"
-#include "Blueprint/UserWidget.h"
-#include "Components/SphereComponent.h"
 #include "Components/CapsuleComponent.h"
-#include "Components/BoxComponent.h"
 #include "Characters/ArcoroxCharacter.h"
 #include "Engine/DamageEvents.h"
-
-AEnemy::AEnemy() :
+#include "HUD/HealthBarSubsystem.h"
+#include "HUD/ArcoroxHUD.h"
+#include "Blueprint/UserWidget.h"
+#include "GameFramework/PlayerController.h"
+#include "Enemy/EnemySignificanceSubsystem.h"
+#include "Enemy/EnemyPoolSubsystem.h"
+#include "Enemy/EnemyProximitySubsystem.h"
+#include "Combat/MeleeSweepSubsystem.h"
+#include "Combat/CombatDamageSubsystem.h"
+#include "Combat/CombatDataRegistry.h"
+#include "Combat/HitZone.h"
+#include "Effects/CombatFXSubsystem.h"
+#include "Audio/CombatAudioSubsystem.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BrainComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarEnemyForceBrainMode(
+	TEXT("arcorox.AI.ForceBrainMode"),
+	-1,
+	TEXT("Overrides the brain of enemies starting their behavior: -1 per class setting, 0 behavior tree, 1 native state machine."));
+
+AEnemy::AEnemy(const FObjectInitializer& ObjectInitializer) :
+	Super(ObjectInitializer.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName)),
 	Health(100.f),
 	MaxHealth(100.f),
 	HealthBarDisplayTime(5.f),
 	bCanHitReact(true),
 	MinHitReactTime(0.5f),
 	MaxHitReactTime(0.8f),
-	HitDamageDestroyTime(1.5f),
+	AggroRadius(600.f),
+	AttackRangeRadius(120.f),
 	bStunned(false),
 	StunChance(0.5f),
 	bInAttackRange(false),
 	WeaponDamage(20.f),
 	LeftWeaponSocket(TEXT("FX_Trail_L_02")),
 	RightWeaponSocket(TEXT("FX_Trail_R_02")),
+	WeaponSweepRadius(20.f),
+	LeftWeaponBaseSocket(TEXT("LeftWeapon")),
+	RightWeaponBaseSocket(TEXT("RightWeapon")),
+	LeftSwingId(0),
+	RightSwingId(0),
 	bCanAttack(true),
 	AttackDelayTime(1.f),
 	bDead(false),
+	bInPool(false),
+	bUpdateProximity(true),
+	bUseNativeBrain(false),
+	bAnimationBudgeted(false),
+	HealthSlot(INDEX_NONE),
+	HitZones(nullptr),
 	DestroyDelay(3.f)
 {
-	PrimaryActorTick.bCanEverTick = true;
-
-	AggroSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AggroSphere"));
-	AggroSphere->SetupAttachment(GetRootComponent());
+	//Damage numbers moved to the HUD, nothing is left to do per frame on the enemy itself
+	PrimaryActorTick.bCanEverTick = false;
 
-	AttackRangeSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AttackRangeSphere"));
-	AttackRangeSphere->SetupAttachment(GetRootComponent());
-
-	LeftWeaponBox = CreateDefaultSubobject<UBoxComponent>(TEXT("LeftWeaponBox"));
-	LeftWeaponBox->SetupAttachment(GetMesh(), FName("LeftWeapon"));
-	RightWeaponBox = CreateDefaultSubobject<UBoxComponent>(TEXT("RightWeaponBox"));
-	RightWeaponBox->SetupAttachment(GetMesh(), FName("RightWeapon"));
+	//The significance subsystem registers the mesh so pooled enemies leave the budget while inactive
+	if (USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh())) BudgetedMesh->SetAutoRegisterWithBudgetAllocator(false);
 }
 
 void AEnemy::BeginPlay()
 {
 	Super::BeginPlay();
 	
-	if (AggroSphere) AggroSphere->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::AggroSphereOverlap);
-	if (AttackRangeSphere)
-	{
-		AttackRangeSphere->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::AttackRangeSphereOverlap);
-		AttackRangeSphere->OnComponentEndOverlap.AddDynamic(this, &AEnemy::AttackRangeSphereEndOverlap);
-	}
-	if (LeftWeaponBox)
-	{
-		LeftWeaponBox->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::LeftWeaponOverlap);
-		LeftWeaponBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		LeftWeaponBox->SetCollisionObjectType(ECollisionChannel::ECC_WorldDynamic);
-		LeftWeaponBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		LeftWeaponBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Overlap);
-	}
-	if (RightWeaponBox)
-	{
-		RightWeaponBox->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::RightWeaponOverlap);
-		RightWeaponBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		RightWeaponBox->SetCollisionObjectType(ECollisionChannel::ECC_WorldDynamic);
-		RightWeaponBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		RightWeaponBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Overlap);
-	}
-
 	if (GetMesh())
 	{
 		GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
 		GetMesh()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
 	}
 	if (GetCapsuleComponent()) GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
+	//Compiled once per mesh, enemies reusing the mesh share the lookup
+	UCombatDataRegistry* Registry = UCombatDataRegistry::Get();
+	if (Registry && GetMesh()) HitZones = Registry->GetHitZones(GetMesh()->GetSkeletalMeshAsset(), HeadBone);
+
+	StartBehavior();
 
+	if (UEnemySignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>()) Significance->RegisterEnemy(this);
+	if (UEnemyProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UEnemyProximitySubsystem>()) Proximity->RegisterEnemy(this);
+	if (UCombatDamageSubsystem* Damage = GetWorld()->GetSubsystem<UCombatDamageSubsystem>()) HealthSlot = Damage->RegisterEnemy(this);
+}
+
+void AEnemy::StartBehavior()
+{
 	EnemyController = Cast<AEnemyController>(GetController());
 	const FVector WorldPatrolPoint = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint);
 	const FVector WorldPatrolPoint2 = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint2);
-	if (EnemyController && EnemyController->GetBlackboardComponent() && BehaviorTree)
+	const int32 ForcedBrainMode = CVarEnemyForceBrainMode.GetValueOnGameThread();
+	const bool bNativeBrain = ForcedBrainMode >= 0 ? ForcedBrainMode > 0 : bUseNativeBrain;
+	if (EnemyController && (BehaviorTree || bNativeBrain))
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsVector(TEXT("PatrolPoint"), WorldPatrolPoint);
-		EnemyController->GetBlackboardComponent()->SetValueAsVector(TEXT("PatrolPoint2"), WorldPatrolPoint2);
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("CanAttack"), true);
-		EnemyController->RunBehaviorTree(BehaviorTree);
+		EnemyController->SetUseNativeBrain(bNativeBrain);
+		EnemyController->SetPatrolPoints(WorldPatrolPoint, WorldPatrolPoint2);
+		EnemyController->SetCanAttack(true);
+		//Pooled enemies keep the blackboard of their previous life
+		EnemyController->SetTarget(nullptr);
+		EnemyController->SetDead(false);
+		EnemyController->SetStunned(false);
+		EnemyController->SetInAttackRange(false);
+		if (bNativeBrain) EnemyController->StartNativeBrain();
+		else EnemyController->RunBehaviorTree(BehaviorTree);
 	}
 }
 
-void AEnemy::Tick(float DeltaTime)
+void AEnemy::DeactivateForPool()
 {
-	Super::Tick(DeltaTime);
+	bInPool = true;
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	HideHealthBar();
+	DeactivateLeftWeapon();
+	DeactivateRightWeapon();
+	if (GetMesh())
+	{
+		if (GetMesh()->GetAnimInstance()) GetMesh()->GetAnimInstance()->StopAllMontages(0.f);
+		GetMesh()->SetComponentTickEnabled(false);
+	}
+	if (EnemyController)
+	{
+		EnemyController->StopMovement();
+		if (EnemyController->GetBrainComponent()) EnemyController->GetBrainComponent()->StopLogic(TEXT("Pooled"));
+		EnemyController->StopNativeBrain();
+	}
+	if (GetCharacterMovement())
+	{
+		GetCharacterMovement()->StopMovementImmediately();
+		GetCharacterMovement()->DisableMovement();
+		GetCharacterMovement()->SetComponentTickEnabled(false);
+	}
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	if (UEnemySignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>()) Significance->UnregisterEnemy(this);
+	if (UEnemyProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UEnemyProximitySubsystem>()) Proximity->UnregisterEnemy(this);
+	if (UCombatDamageSubsystem* Damage = GetWorld()->GetSubsystem<UCombatDamageSubsystem>()) Damage->UnregisterEnemy(HealthSlot);
+	HealthSlot = INDEX_NONE;
+}
+
+void AEnemy::ActivateFromPool(const FTransform& Transform, float InHealth, const FVector& WorldPatrolPoint, const FVector& WorldPatrolPoint2)
+{
+	bInPool = false;
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	SetHordeState(InHealth, WorldPatrolPoint, WorldPatrolPoint2);
+	bDead = false;
+	bStunned = false;
+	bInAttackRange = false;
+	bCanAttack = true;
+	bCanHitReact = true;
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+	if (GetMesh())
+	{
+		GetMesh()->bPauseAnims = false;
+		GetMesh()->SetComponentTickEnabled(true);
+	}
+	if (GetCharacterMovement())
+	{
+		GetCharacterMovement()->SetComponentTickEnabled(true);
+		GetCharacterMovement()->SetMovementMode(EMovementMode::MOVE_Walking);
+	}
+	StartBehavior();
+	if (UEnemySignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>()) Significance->RegisterEnemy(this);
+	if (UEnemyProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UEnemyProximitySubsystem>()) Proximity->RegisterEnemy(this);
+	if (UCombatDamageSubsystem* Damage = GetWorld()->GetSubsystem<UCombatDamageSubsystem>()) HealthSlot = Damage->RegisterEnemy(this);
+}
 
-	UpdateHitDamages();
+void AEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UEnemySignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>()) Significance->UnregisterEnemy(this);
+	if (UEnemyProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UEnemyProximitySubsystem>()) Proximity->UnregisterEnemy(this);
+	if (UCombatDamageSubsystem* Damage = GetWorld()->GetSubsystem<UCombatDamageSubsystem>()) Damage->UnregisterEnemy(HealthSlot);
+	HealthSlot = INDEX_NONE;
+
+	Super::EndPlay(EndPlayReason);
 }
 
-void AEnemy::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
+void AEnemy::ApplySignificanceTier(const FEnemySignificanceTier& Tier)
 {
-	Super::SetupPlayerInputComponent(PlayerInputComponent);
+	SetActorTickInterval(Tier.ActorTickInterval);
+	if (GetCharacterMovement()) GetCharacterMovement()->SetComponentTickInterval(Tier.MovementTickInterval);
+	if (GetMesh() && !bAnimationBudgeted)
+	{
+		GetMesh()->SetComponentTickInterval(Tier.AnimationTickInterval);
+		//Distant enemies only evaluate their pose while on screen
+		GetMesh()->VisibilityBasedAnimTickOption = Tier.AnimationTickInterval > 0.f ? EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered : EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	}
+	if (EnemyController && EnemyController->GetBehaviorTreeComponent()) EnemyController->GetBehaviorTreeComponent()->SetComponentTickInterval(Tier.BehaviorTreeTickInterval);
+	if (EnemyController) EnemyController->SetBrainUpdateInterval(Tier.BehaviorTreeTickInterval);
+	bUpdateProximity = Tier.bUpdateProximity;
+}
 
+void AEnemy::FillAnimSnapshot(FEnemyAnimSnapshot& OutSnapshot) const
+{
+	OutSnapshot.Velocity = GetCharacterMovement()->Velocity;
 }
 
-void AEnemy::StoreHitDamage(UUserWidget* Widget, FVector Location)
+float AEnemy::GetHitZoneMultiplier(const FName& BoneName, const FHitZoneMultipliers& WeaponMultipliers, EHitZone& OutZone) const
 {
-	HitDamages.Add(Widget, Location);
-	FTimerHandle HitDamageTimer;
-	FTimerDelegate HitDamageDelegate;
-	HitDamageDelegate.BindUFunction(this, FName("DestroyHitDamage"), Widget);
-	GetWorldTimerManager().SetTimer(HitDamageTimer, HitDamageDelegate, HitDamageDestroyTime, false);
+	if (HitZones) return HitZones->GetMultiplier(GetMesh()->GetBoneIndex(BoneName), WeaponMultipliers, OutZone);
+	OutZone = BoneName == HeadBone ? EHitZone::EHZ_Head : EHitZone::EHZ_Torso;
+	return WeaponMultipliers.Get(OutZone);
 }
 
-void AEnemy::SetStunned(bool Stunned)
+bool AEnemy::IsAttacking() const
 {
-	bStunned = Stunned;
-	if (EnemyController && EnemyController->GetBlackboardComponent())
-	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("Stunned"), bStunned);
-	}
+	UAnimInstance* AnimInstance = GetMesh() ? GetMesh()->GetAnimInstance() : nullptr;
+	return AnimInstance && AttackMontage && AnimInstance->Montage_IsPlaying(AttackMontage);
 }
 
-void AEnemy::SetInAttackRange(bool InRange)
+bool AEnemy::HasTarget() const
 {
-	bInAttackRange = InRange;
-	if (EnemyController && EnemyController->GetBlackboardComponent())
-	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("InAttackRange"), bInAttackRange);
-	}
+	return EnemyController && EnemyController->GetTarget() != nullptr;
 }
 
-void AEnemy::DestroyHitDamage(UUserWidget* HitDamage)
+void AEnemy::SetTarget(AActor* Target)
 {
-	HitDamages.Remove(HitDamage);
-	HitDamage->RemoveFromParent();
+	if (EnemyController) EnemyController->SetTarget(Target);
 }
 
-void AEnemy::AggroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+AActor* AEnemy::GetTarget() const
 {
-	if (OtherActor == nullptr) return;
-	AArcoroxCharacter* ArcoroxCharacter = Cast<AArcoroxCharacter>(OtherActor);
-	if (ArcoroxCharacter && EnemyController && EnemyController->GetBlackboardComponent())
-	{
-		EnemyController->GetBlackboardComponent()->SetValueAsObject(TEXT("Target"), ArcoroxCharacter);
-	}
+	return EnemyController ? EnemyController->GetTarget() : nullptr;
+}
+
+void AEnemy::SetHordeState(float InHealth, const FVector& WorldPatrolPoint, const FVector& WorldPatrolPoint2)
+{
+	Health = FMath::Clamp(InHealth, 0.f, MaxHealth);
+	//Patrol points are edited relative to the actor, BeginPlay converts them back to world space
+	PatrolPoint = GetActorTransform().InverseTransformPosition(WorldPatrolPoint);
+	PatrolPoint2 = GetActorTransform().InverseTransformPosition(WorldPatrolPoint2);
+}
+
+bool AEnemy::UsesBatchedDamage() const
+{
+	return HealthSlot != INDEX_NONE && UCombatDamageSubsystem::IsBatchEnabled();
 }
 
-void AEnemy::AttackRangeSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AEnemy::SetHealth(float InHealth)
 {
-	if (OtherActor == nullptr) return;
-	AArcoroxCharacter* ArcoroxCharacter = Cast<AArcoroxCharacter>(OtherActor);
-	if (ArcoroxCharacter)
+	Health = FMath::Clamp(InHealth, 0.f, MaxHealth);
+	UCombatDamageSubsystem* Damage = HealthSlot != INDEX_NONE ? GetWorld()->GetSubsystem<UCombatDamageSubsystem>() : nullptr;
+	if (Damage) Damage->SetHealth(HealthSlot, Health);
+}
+
+void AEnemy::ApplyResolvedDamage(float NewHealth, AActor* DamageInstigator, int32 NumPointHits, const FVector& HitLocation)
+{
+	Health = NewHealth;
+	//One blackboard write per frame however many hits landed
+	if (EnemyController) EnemyController->SetTarget(DamageInstigator);
+	if (NumPointHits <= 0) return;
+	//Same odds as rolling StunChance once per hit
+	if (FMath::FRandRange(0.f, 1.f) <= 1.f - FMath::Pow(1.f - StunChance, static_cast<float>(NumPointHits)))
 	{
-		SetInAttackRange(true);
+		FHitResult HitResult;
+		HitResult.Location = HitLocation;
+		PlayHitMontage(HitResult);
+		SetStunned(true);
 	}
 }
 
-void AEnemy::AttackRangeSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+void AEnemy::ApplyResolvedDeath(AActor* DamageInstigator, bool bHasHitLocation, const FVector& HitLocation)
 {
-	if (OtherActor == nullptr) return;
-	AArcoroxCharacter* ArcoroxCharacter = Cast<AArcoroxCharacter>(OtherActor);
-	if (ArcoroxCharacter)
+	Health = 0.f;
+	if (EnemyController) EnemyController->SetTarget(DamageInstigator);
+	if (bHasHitLocation)
 	{
-		SetInAttackRange(false);
+		FHitResult HitResult;
+		HitResult.Location = HitLocation;
+		Die(HitResult);
 	}
+	else Die();
+}
+
+void AEnemy::GetWorldPatrolPoints(FVector& OutPatrolPoint, FVector& OutPatrolPoint2) const
+{
+	if (EnemyController && EnemyController->GetPatrolPoints(OutPatrolPoint, OutPatrolPoint2)) return;
+	OutPatrolPoint = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint);
+	OutPatrolPoint2 = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint2);
+}
+
+void AEnemy::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
+{
+	Super::SetupPlayerInputComponent(PlayerInputComponent);
+
+}
+
+void AEnemy::StoreHitDamage(UUserWidget* Widget, FVector Location)
+{
+	if (Widget == nullptr) return;
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	AArcoroxHUD* ArcoroxHUD = PlayerController ? PlayerController->GetHUD<AArcoroxHUD>() : nullptr;
+	if (ArcoroxHUD) ArcoroxHUD->AddDamageNumberWidget(Widget, Location);
+	else Widget->RemoveFromParent();
+}
+
+void AEnemy::SetStunned(bool Stunned)
+{
+	bStunned = Stunned;
+	if (EnemyController) EnemyController->SetStunned(bStunned);
+}
+
+void AEnemy::SetInAttackRange(bool InRange)
+{
+	bInAttackRange = InRange;
+	if (EnemyController) EnemyController->SetInAttackRange(bInAttackRange);
 }
 
 void AEnemy::InflictDamage(AArcoroxCharacter* ArcoroxCharacter, const FName& WeaponSocket)
@@ -178,32 +329,21 @@ void AEnemy::InflictDamage(AArcoroxCharacter* ArcoroxCharacter, const FName& Wea
 	ArcoroxCharacter->SpawnBloodParticles(GetMesh()->GetSocketTransform(WeaponSocket));
 }
 
-void AEnemy::LeftWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AEnemy::ApplyMeleeHit(AArcoroxCharacter* ArcoroxCharacter, const FName& WeaponSocket, const FHitResult& HitResult)
 {
-	if (OtherActor == nullptr) return;
-	AArcoroxCharacter* ArcoroxCharacter = Cast<AArcoroxCharacter>(OtherActor);
-	if (ArcoroxCharacter)
-	{
-		InflictDamage(ArcoroxCharacter, LeftWeaponSocket);
-		StunCharacter(ArcoroxCharacter, SweepResult);
-	}
+	if (ArcoroxCharacter == nullptr) return;
+	InflictDamage(ArcoroxCharacter, WeaponSocket);
+	StunCharacter(ArcoroxCharacter, HitResult);
 }
 
-void AEnemy::RightWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AEnemy::ShowHealthBar_Implementation()
 {
-	if (OtherActor == nullptr) return;
-	AArcoroxCharacter* ArcoroxCharacter = Cast<AArcoroxCharacter>(OtherActor);
-	if (ArcoroxCharacter)
-	{
-		InflictDamage(ArcoroxCharacter, RightWeaponSocket);
-		StunCharacter(ArcoroxCharacter, SweepResult);
-	}
+	if (UHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UHealthBarSubsystem>()) HealthBars->ShowHealthBar(this, HealthBarDisplayTime);
 }
 
-void AEnemy::ShowHealthBar_Implementation()
+void AEnemy::HideHealthBar_Implementation()
 {
-	GetWorldTimerManager().ClearTimer(HealthBarDisplayTimer);
-	GetWorldTimerManager().SetTimer(HealthBarDisplayTimer, this, &AEnemy::HideHealthBar, HealthBarDisplayTime);
+	if (UHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UHealthBarSubsystem>()) HealthBars->HideHealthBar(this);
 }
 
 void AEnemy::Die(const FHitResult& HitResult)
@@ -211,10 +351,13 @@ void AEnemy::Die(const FHitResult& HitResult)
 	if (bDead) return;
 	bDead = true;
 	HideHealthBar();
+	//The death montage can interrupt an attack before its window closes
+	DeactivateLeftWeapon();
+	DeactivateRightWeapon();
 	PlayDeathMontage(HitResult);
-	if (EnemyController && EnemyController->GetBlackboardComponent())
+	if (EnemyController)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("Dead"), true);
+		EnemyController->SetDead(true);
 		EnemyController->StopMovement();
 	}
 }
@@ -224,10 +367,12 @@ void AEnemy::Die()
 	if (bDead) return;
 	bDead = true;
 	HideHealthBar();
+	DeactivateLeftWeapon();
+	DeactivateRightWeapon();
 	PlayMontageSection(DeathMontage, FName("DeathA"), 1.f);
-	if (EnemyController && EnemyController->GetBlackboardComponent())
+	if (EnemyController)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("Dead"), true);
+		EnemyController->SetDead(true);
 		EnemyController->StopMovement();
 	}
 }
@@ -237,18 +382,6 @@ void AEnemy::ResetHitReactTimer()
 	bCanHitReact = true;
 }
 
-void AEnemy::UpdateHitDamages()
-{
-	for (auto& HitPair : HitDamages)
-	{
-		UUserWidget* HitDamage = HitPair.Key;
-		const FVector HitLocation = HitPair.Value;
-		FVector2D ScreenPosition;
-		UGameplayStatics::ProjectWorldToScreen(GetWorld()->GetFirstPlayerController(), HitLocation, ScreenPosition);
-		HitDamage->SetPositionInViewport(ScreenPosition);
-	}
-}
-
 void AEnemy::StunCharacter(AArcoroxCharacter* Character, const FHitResult& HitResult)
 {
 	if (Character)
@@ -260,25 +393,24 @@ void AEnemy::StunCharacter(AArcoroxCharacter* Character, const FHitResult& HitRe
 void AEnemy::ResetAttackTimer()
 {
 	bCanAttack = true;
-	if (EnemyController && EnemyController->GetBlackboardComponent())
-	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("CanAttack"), bCanAttack);
-	}
+	if (EnemyController) EnemyController->SetCanAttack(bCanAttack);
 }
 
 void AEnemy::DestroyEnemy()
 {
-	Destroy();
+	UEnemyPoolSubsystem* Pool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>();
+	if (Pool) Pool->ReleaseEnemy(this);
+	else Destroy();
 }
 
 void AEnemy::PlayImpactSound()
 {
-	if (ImpactSound) UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
+	UCombatAudioSubsystem::PlayCombatSoundAtLocation(this, ECombatSoundCategory::ECSC_Impact, ImpactSound, GetActorLocation());
 }
 
 void AEnemy::SpawnImpactParticles(FHitResult& HitResult)
 {
-	if (ImpactParticles) UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, HitResult.Location);
+	UCombatFXSubsystem::SpawnEffectAt(this, ECombatFXType::ECFX_Impact, ImpactParticles, FTransform(HitResult.Location));
 }
 
 void AEnemy::PlayHitMontage(FHitResult& HitResult, float PlayRate)
@@ -323,30 +455,35 @@ void AEnemy::PlayAttackMontage(float PlayRate)
 	PlayRandomMontageSection(AttackMontage, AttackMontageSections, PlayRate);
 	bCanAttack = false;
 	GetWorldTimerManager().SetTimer(AttackTimer, this, &AEnemy::ResetAttackTimer, AttackDelayTime);
-	if (EnemyController && EnemyController->GetBlackboardComponent())
-	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("CanAttack"), bCanAttack);
-	}
+	if (EnemyController) EnemyController->SetCanAttack(bCanAttack);
 }
 
 void AEnemy::ActivateLeftWeapon()
 {
-	if (LeftWeaponBox) LeftWeaponBox->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	UMeleeSweepSubsystem* MeleeSweep = GetWorld()->GetSubsystem<UMeleeSweepSubsystem>();
+	if (MeleeSweep == nullptr) return;
+	MeleeSweep->EndSwing(LeftSwingId);
+	LeftSwingId = MeleeSweep->BeginSwing(this, LeftWeaponBaseSocket, LeftWeaponSocket, WeaponSweepRadius);
 }
 
 void AEnemy::DeactivateLeftWeapon()
 {
-	if (LeftWeaponBox) LeftWeaponBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	if (UMeleeSweepSubsystem* MeleeSweep = GetWorld()->GetSubsystem<UMeleeSweepSubsystem>()) MeleeSweep->EndSwing(LeftSwingId);
+	LeftSwingId = 0;
 }
 
 void AEnemy::ActivateRightWeapon()
 {
-	if (RightWeaponBox) RightWeaponBox->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	UMeleeSweepSubsystem* MeleeSweep = GetWorld()->GetSubsystem<UMeleeSweepSubsystem>();
+	if (MeleeSweep == nullptr) return;
+	MeleeSweep->EndSwing(RightSwingId);
+	RightSwingId = MeleeSweep->BeginSwing(this, RightWeaponBaseSocket, RightWeaponSocket, WeaponSweepRadius);
 }
 
 void AEnemy::DeactivateRightWeapon()
 {
-	if (RightWeaponBox) RightWeaponBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	if (UMeleeSweepSubsystem* MeleeSweep = GetWorld()->GetSubsystem<UMeleeSweepSubsystem>()) MeleeSweep->EndSwing(RightSwingId);
+	RightSwingId = 0;
 }
 
 void AEnemy::FinishDeath()
@@ -378,6 +515,8 @@ void AEnemy::Hit_Implementation(FHitResult HitResult)
 	SpawnImpactParticles(HitResult);
 	if (bDead) return;
 	ShowHealthBar();
+	//Batched hits roll the stun once the frame's damage is resolved
+	if (UsesBatchedDamage()) return;
 	const float Stunned = FMath::FRandRange(0.f, 1.f);
 	if (Stunned <= StunChance)
 	{
@@ -389,13 +528,17 @@ void AEnemy::Hit_Implementation(FHitResult HitResult)
 float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
 {
 	Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
-	if (EnemyController && EnemyController->GetBlackboardComponent())
+	UCombatDamageSubsystem* Damage = UsesBatchedDamage() ? GetWorld()->GetSubsystem<UCombatDamageSubsystem>() : nullptr;
+	if (Damage)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsObject(FName("Target"), DamageCauser);
+		const bool bPointDamage = DamageEvent.IsOfType(FPointDamageEvent::ClassID);
+		const bool bQueued = bPointDamage ? Damage->QueuePointDamage(HealthSlot, DamageAmount, DamageCauser, ((FPointDamageEvent*)&DamageEvent)->HitInfo.Location) : Damage->QueueDamage(HealthSlot, DamageAmount, DamageCauser);
+		if (bQueued) return DamageAmount;
 	}
+	if (EnemyController) EnemyController->SetTarget(DamageCauser);
 	if (Health - DamageAmount <= 0.f)
 	{
-		Health = 0.f;
+		SetHealth(0.f);
 		if (DamageEvent.IsOfType(FPointDamageEvent::ClassID))
 		{
 			FPointDamageEvent* const PointDamageEvent = (FPointDamageEvent*)&DamageEvent;
@@ -403,6 +546,6 @@ float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AC
 		}
 		else Die();
 	}
-	else Health -= DamageAmount;
+	else SetHealth(Health - DamageAmount);
 	return DamageAmount;
 }
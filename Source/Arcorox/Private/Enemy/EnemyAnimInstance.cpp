@@ -5,9 +5,14 @@
 #include "Enemy/Enemy.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Characters/ArcoroxAnimInstance.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Anim Game Thread"), STAT_EnemyAnimGameThread, STATGROUP_Arcorox);
 
 UEnemyAnimInstance::UEnemyAnimInstance() :
-	Speed(0.f)
+	Speed(0.f),
+	bUpdatedOnGameThread(false)
 {
 
 }
@@ -27,8 +32,21 @@ void UEnemyAnimInstance::NativeUpdateAnimation(float DeltaTime)
 {
 	Super::NativeUpdateAnimation(DeltaTime);
 
-	if (Enemy && EnemyCharacterMovement)
-	{
-		Speed = UKismetMathLibrary::VSizeXY(EnemyCharacterMovement->Velocity);
-	}
-}
\ No newline at end of file
+	SCOPE_CYCLE_COUNTER(STAT_EnemyAnimGameThread);
+	Snapshot.bValid = Enemy && EnemyCharacterMovement;
+	if (Snapshot.bValid) Enemy->FillAnimSnapshot(Snapshot);
+	bUpdatedOnGameThread = !UArcoroxAnimInstance::IsThreadSafeUpdateEnabled();
+	if (bUpdatedOnGameThread) UpdateFromSnapshot();
+}
+
+void UEnemyAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaTime)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaTime);
+
+	if (!bUpdatedOnGameThread) UpdateFromSnapshot();
+}
+
+void UEnemyAnimInstance::UpdateFromSnapshot()
+{
+	if (Snapshot.bValid) Speed = UKismetMathLibrary::VSizeXY(Snapshot.Velocity);
+}
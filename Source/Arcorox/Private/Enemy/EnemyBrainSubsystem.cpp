@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyBrainSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyController.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Native Brains"), STAT_EnemyNativeBrains, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Native Brain Updates"), STAT_EnemyNativeBrainUpdates, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemy Native Brains Running"), STAT_EnemyNativeBrainsRunning, STATGROUP_Arcorox);
+
+static void LogEnemyBrains(UWorld* World)
+{
+	if (UEnemyBrainSubsystem* Brains = World ? World->GetSubsystem<UEnemyBrainSubsystem>() : nullptr) Brains->LogBrainReport();
+}
+
+static FAutoConsoleCommandWithWorld LogEnemyBrainsCommand(
+	TEXT("arcorox.AI.BrainReport"),
+	TEXT("Logs native brain and behavior tree enemy counts and the average native update cost per frame."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&LogEnemyBrains));
+
+UEnemyBrainSubsystem::UEnemyBrainSubsystem() :
+	BudgetMicroseconds(500.f),
+	AcceptanceRadius(50.f),
+	MaxStunnedTime(2.f),
+	Cursor(0),
+	NumUpdates(0),
+	NumFrames(0),
+	TotalUpdateMs(0.0),
+	LastFrameUpdates(0)
+{
+}
+
+void UEnemyBrainSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_EnemyNativeBrainsRunning, Controllers.Num());
+	Controllers.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UEnemyBrainSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyBrainSubsystem, STATGROUP_Tickables);
+}
+
+bool UEnemyBrainSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemyBrainSubsystem::RegisterController(AEnemyController* Controller)
+{
+	if (Controller == nullptr) return;
+	Controllers.AddUnique(Controller);
+	INC_DWORD_STAT(STAT_EnemyNativeBrainsRunning);
+}
+
+void UEnemyBrainSubsystem::UnregisterController(AEnemyController* Controller)
+{
+	if (Controllers.RemoveSingleSwap(Controller, false) > 0) DEC_DWORD_STAT(STAT_EnemyNativeBrainsRunning);
+}
+
+void UEnemyBrainSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Controllers.Num() == 0) return;
+	SCOPE_CYCLE_COUNTER(STAT_EnemyNativeBrains);
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	//Resumes where the previous frame ran out of budget so every brain gets its turn
+	int32 NumVisited = 0;
+	LastFrameUpdates = 0;
+	while (NumVisited < Controllers.Num())
+	{
+		if (Cursor >= Controllers.Num()) Cursor = 0;
+		AEnemyController* Controller = Controllers[Cursor].Get();
+		if (Controller == nullptr)
+		{
+			Controllers.RemoveAtSwap(Cursor, 1, false);
+			DEC_DWORD_STAT(STAT_EnemyNativeBrainsRunning);
+			continue;
+		}
+		Cursor++;
+		NumVisited++;
+		FEnemyBrain& Brain = Controller->GetBrain();
+		if (Now - Brain.LastUpdateTime < Brain.UpdateInterval) continue;
+		UpdateBrain(Controller, Now);
+		LastFrameUpdates++;
+		if (FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0 >= BudgetMicroseconds) break;
+	}
+
+	NumUpdates += LastFrameUpdates;
+	NumFrames++;
+	TotalUpdateMs += FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+	INC_DWORD_STAT_BY(STAT_EnemyNativeBrainUpdates, LastFrameUpdates);
+}
+
+void UEnemyBrainSubsystem::UpdateBrain(AEnemyController* Controller, float Now)
+{
+	FEnemyBrain& Brain = Controller->GetBrain();
+	Brain.LastUpdateTime = Now;
+	AEnemy* Enemy = Cast<AEnemy>(Controller->GetPawn());
+	if (Enemy == nullptr) return;
+
+	//Same priorities as the behavior tree, death over stun over combat over patrol
+	AActor* Target = Brain.bPlayerDead ? nullptr : Brain.Target.Get();
+	EEnemyBrainState State = EEnemyBrainState::EEBS_Patrol;
+	if (Brain.bDead) State = EEnemyBrainState::EEBS_Dead;
+	else if (Brain.bStunned) State = EEnemyBrainState::EEBS_Stunned;
+	else if (Target && Brain.bInAttackRange) State = EEnemyBrainState::EEBS_Attack;
+	else if (Target) State = EEnemyBrainState::EEBS_Chase;
+
+	if (State != Brain.State)
+	{
+		Brain.State = State;
+		Brain.StateStartTime = Now;
+		Brain.bMoveRequested = false;
+		Controller->StopMovement();
+		if (Target && (State == EEnemyBrainState::EEBS_Chase || State == EEnemyBrainState::EEBS_Attack)) Controller->SetFocus(Target);
+		else Controller->ClearFocus(EAIFocusPriority::Gameplay);
+	}
+
+	switch (State)
+	{
+	case EEnemyBrainState::EEBS_Stunned:
+		//The hit react montage normally clears the flag, this only catches an interrupted montage
+		if (Now - Brain.StateStartTime >= MaxStunnedTime) Enemy->SetStunned(false);
+		break;
+	case EEnemyBrainState::EEBS_Attack:
+		if (Brain.bCanAttack) Enemy->PlayAttackMontage();
+		break;
+	case EEnemyBrainState::EEBS_Chase:
+		if (!Brain.bMoveRequested || Controller->GetMoveStatus() == EPathFollowingStatus::Idle)
+		{
+			Controller->MoveToActor(Target, AcceptanceRadius);
+			Brain.bMoveRequested = true;
+		}
+		break;
+	case EEnemyBrainState::EEBS_Patrol:
+		if (Controller->GetMoveStatus() == EPathFollowingStatus::Idle)
+		{
+			//A finished move means the patrol point was reached or unreachable, head to the other one
+			if (Brain.bMoveRequested) Brain.PatrolIndex ^= 1;
+			Controller->MoveToLocation(Brain.PatrolPoints[Brain.PatrolIndex], AcceptanceRadius);
+			Brain.bMoveRequested = true;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void UEnemyBrainSubsystem::LogBrainReport() const
+{
+	int32 NumBehaviorTree = 0;
+	for (TActorIterator<AEnemyController> It(GetWorld()); It; ++It)
+	{
+		if (!It->UsesNativeBrain() && It->GetBehaviorTreeComponent() && It->GetBehaviorTreeComponent()->IsRunning()) NumBehaviorTree++;
+	}
+	const double AverageMs = NumFrames > 0 ? TotalUpdateMs / NumFrames : 0.0;
+	UE_LOG(LogArcorox, Display, TEXT("Enemy brains: %d native, %d behavior tree (compare with stat AI)"), Controllers.Num(), NumBehaviorTree);
+	UE_LOG(LogArcorox, Display, TEXT("  Native: %.3f ms per frame over %llu frames, %llu updates, %d last frame, budget %.0f us"), AverageMs, NumFrames, NumUpdates, LastFrameUpdates, BudgetMicroseconds);
+}
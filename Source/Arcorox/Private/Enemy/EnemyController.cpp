@@ -5,9 +5,33 @@
 #include "BehaviorTree/BehaviorTree.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "HAL/IConsoleManager.h"
 #include "Enemy/Enemy.h"
+#include "Arcorox/Arcorox.h"
 
-AEnemyController::AEnemyController()
+DECLARE_DWORD_COUNTER_STAT(TEXT("Blackboard Writes"), STAT_BlackboardWrites, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Blackboard Writes Skipped"), STAT_BlackboardWritesSkipped, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<bool> CVarSkipUnchangedBlackboardWrites(
+	TEXT("arcorox.AI.SkipUnchangedBlackboardWrites"),
+	true,
+	TEXT("Skips enemy blackboard writes that would not change the value, disable to compare the write rate."));
+
+AEnemyController::AEnemyController() :
+	TargetKey(FBlackboard::InvalidKey),
+	PatrolPointKey(FBlackboard::InvalidKey),
+	PatrolPoint2Key(FBlackboard::InvalidKey),
+	CanAttackKey(FBlackboard::InvalidKey),
+	InAttackRangeKey(FBlackboard::InvalidKey),
+	StunnedKey(FBlackboard::InvalidKey),
+	DeadKey(FBlackboard::InvalidKey),
+	PlayerDeadKey(FBlackboard::InvalidKey),
+	NumBlackboardWrites(0),
+	NumBlackboardWritesSkipped(0),
+	bUseNativeBrain(false)
 {
 	BlackboardComponent = CreateDefaultSubobject<UBlackboardComponent>(TEXT("BlackboardComponent"));
 	BehaviorTreeComponent = CreateDefaultSubobject<UBehaviorTreeComponent>(TEXT("BehaviorTreeComponent"));
@@ -25,5 +49,140 @@ void AEnemyController::OnPossess(APawn* InPawn)
 	if (Enemy->GetBehaviorTree() && BlackboardComponent)
 	{
 		BlackboardComponent->InitializeBlackboard(*(Enemy->GetBehaviorTree()->BlackboardAsset));
+		CacheBlackboardKeys();
+	}
+}
+
+void AEnemyController::CacheBlackboardKeys()
+{
+	TargetKey = BlackboardComponent->GetKeyID(TEXT("Target"));
+	PatrolPointKey = BlackboardComponent->GetKeyID(TEXT("PatrolPoint"));
+	PatrolPoint2Key = BlackboardComponent->GetKeyID(TEXT("PatrolPoint2"));
+	CanAttackKey = BlackboardComponent->GetKeyID(TEXT("CanAttack"));
+	InAttackRangeKey = BlackboardComponent->GetKeyID(TEXT("InAttackRange"));
+	StunnedKey = BlackboardComponent->GetKeyID(TEXT("Stunned"));
+	DeadKey = BlackboardComponent->GetKeyID(TEXT("Dead"));
+	PlayerDeadKey = BlackboardComponent->GetKeyID(TEXT("PlayerDead"));
+}
+
+void AEnemyController::SetUseNativeBrain(bool bNative)
+{
+	if (!bNative) StopNativeBrain();
+	bUseNativeBrain = bNative;
+}
+
+void AEnemyController::StartNativeBrain()
+{
+	if (!bUseNativeBrain || Brain.bRunning) return;
+	Brain.bRunning = true;
+	Brain.bMoveRequested = false;
+	Brain.State = EEnemyBrainState::EEBS_Patrol;
+	Brain.StateStartTime = GetWorld()->GetTimeSeconds();
+	if (UEnemyBrainSubsystem* Brains = GetWorld()->GetSubsystem<UEnemyBrainSubsystem>()) Brains->RegisterController(this);
+}
+
+void AEnemyController::StopNativeBrain()
+{
+	if (!Brain.bRunning) return;
+	Brain.bRunning = false;
+	if (UEnemyBrainSubsystem* Brains = GetWorld()->GetSubsystem<UEnemyBrainSubsystem>()) Brains->UnregisterController(this);
+}
+
+void AEnemyController::SetBrainUpdateInterval(float Interval)
+{
+	Brain.UpdateInterval = Interval;
+}
+
+void AEnemyController::SetBoolValue(FBlackboard::FKey Key, bool bValue)
+{
+	if (BlackboardComponent == nullptr || Key == FBlackboard::InvalidKey) return;
+	if (CVarSkipUnchangedBlackboardWrites.GetValueOnGameThread() && BlackboardComponent->GetValue<UBlackboardKeyType_Bool>(Key) == bValue)
+	{
+		INC_DWORD_STAT(STAT_BlackboardWritesSkipped);
+		NumBlackboardWritesSkipped++;
+		return;
+	}
+	BlackboardComponent->SetValue<UBlackboardKeyType_Bool>(Key, bValue);
+	INC_DWORD_STAT(STAT_BlackboardWrites);
+	NumBlackboardWrites++;
+}
+
+void AEnemyController::SetTarget(AActor* Target)
+{
+	if (bUseNativeBrain)
+	{
+		Brain.Target = Target;
+		return;
+	}
+	if (BlackboardComponent == nullptr || TargetKey == FBlackboard::InvalidKey) return;
+	//Every bullet re-targets the shooter, usually the same actor
+	if (CVarSkipUnchangedBlackboardWrites.GetValueOnGameThread() && BlackboardComponent->GetValue<UBlackboardKeyType_Object>(TargetKey) == Target)
+	{
+		INC_DWORD_STAT(STAT_BlackboardWritesSkipped);
+		NumBlackboardWritesSkipped++;
+		return;
+	}
+	BlackboardComponent->SetValue<UBlackboardKeyType_Object>(TargetKey, Target);
+	INC_DWORD_STAT(STAT_BlackboardWrites);
+	NumBlackboardWrites++;
+}
+
+AActor* AEnemyController::GetTarget() const
+{
+	if (bUseNativeBrain) return Brain.Target.Get();
+	if (BlackboardComponent == nullptr || TargetKey == FBlackboard::InvalidKey) return nullptr;
+	return Cast<AActor>(BlackboardComponent->GetValue<UBlackboardKeyType_Object>(TargetKey));
+}
+
+void AEnemyController::SetStunned(bool bStunned)
+{
+	if (bUseNativeBrain) Brain.bStunned = bStunned;
+	else SetBoolValue(StunnedKey, bStunned);
+}
+
+void AEnemyController::SetInAttackRange(bool bInAttackRange)
+{
+	if (bUseNativeBrain) Brain.bInAttackRange = bInAttackRange;
+	else SetBoolValue(InAttackRangeKey, bInAttackRange);
+}
+
+void AEnemyController::SetCanAttack(bool bCanAttack)
+{
+	if (bUseNativeBrain) Brain.bCanAttack = bCanAttack;
+	else SetBoolValue(CanAttackKey, bCanAttack);
+}
+
+void AEnemyController::SetDead(bool bDead)
+{
+	if (bUseNativeBrain) Brain.bDead = bDead;
+	else SetBoolValue(DeadKey, bDead);
+}
+
+void AEnemyController::SetPlayerDead(bool bPlayerDead)
+{
+	if (bUseNativeBrain) Brain.bPlayerDead = bPlayerDead;
+	else SetBoolValue(PlayerDeadKey, bPlayerDead);
+}
+
+void AEnemyController::SetPatrolPoints(const FVector& PatrolPoint, const FVector& PatrolPoint2)
+{
+	Brain.PatrolPoints[0] = PatrolPoint;
+	Brain.PatrolPoints[1] = PatrolPoint2;
+	if (bUseNativeBrain || BlackboardComponent == nullptr) return;
+	if (PatrolPointKey != FBlackboard::InvalidKey) BlackboardComponent->SetValue<UBlackboardKeyType_Vector>(PatrolPointKey, PatrolPoint);
+	if (PatrolPoint2Key != FBlackboard::InvalidKey) BlackboardComponent->SetValue<UBlackboardKeyType_Vector>(PatrolPoint2Key, PatrolPoint2);
+}
+
+bool AEnemyController::GetPatrolPoints(FVector& OutPatrolPoint, FVector& OutPatrolPoint2) const
+{
+	if (bUseNativeBrain)
+	{
+		OutPatrolPoint = Brain.PatrolPoints[0];
+		OutPatrolPoint2 = Brain.PatrolPoints[1];
+		return true;
 	}
+	if (BlackboardComponent == nullptr || PatrolPointKey == FBlackboard::InvalidKey || PatrolPoint2Key == FBlackboard::InvalidKey) return false;
+	OutPatrolPoint = BlackboardComponent->GetValue<UBlackboardKeyType_Vector>(PatrolPointKey);
+	OutPatrolPoint2 = BlackboardComponent->GetValue<UBlackboardKeyType_Vector>(PatrolPoint2Key);
+	return true;
 }
@@ -0,0 +1,251 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyHordeSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyPoolSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Components/CapsuleComponent.h"
+#include "NavigationSystem.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Horde Steering"), STAT_HordeSteering, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Horde Promotion"), STAT_HordePromotion, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Horde Ground Queries"), STAT_HordeGroundQueries, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Horde Agents"), STAT_HordeAgents, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Horde Promoted"), STAT_HordePromoted, STATGROUP_Arcorox);
+
+static void SpawnHordeCommand(const TArray<FString>& Args, UWorld* World)
+{
+	UEnemyHordeSubsystem* Horde = World ? World->GetSubsystem<UEnemyHordeSubsystem>() : nullptr;
+	APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	if (Horde == nullptr || PlayerController == nullptr || PlayerController->GetPawn() == nullptr) return;
+	const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100;
+	const float Radius = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 20000.f;
+	Horde->SpawnHorde(Count, PlayerController->GetPawn()->GetActorLocation(), Radius);
+}
+
+static void LogHordeCommand(UWorld* World)
+{
+	if (UEnemyHordeSubsystem* Horde = World ? World->GetSubsystem<UEnemyHordeSubsystem>() : nullptr) Horde->LogHordeReport();
+}
+
+static FAutoConsoleCommandWithWorldAndArgs SpawnHordeConsoleCommand(
+	TEXT("arcorox.Horde.Spawn"),
+	TEXT("Adds horde agents around the player. Usage: arcorox.Horde.Spawn <Count> <Radius>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&SpawnHordeCommand));
+
+static FAutoConsoleCommandWithWorld LogHordeConsoleCommand(
+	TEXT("arcorox.Horde.Report"),
+	TEXT("Logs horde agent and promoted actor counts with the game thread time."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&LogHordeCommand));
+
+UEnemyHordeSubsystem::UEnemyHordeSubsystem() :
+	PromoteDistance(3000.f),
+	DemoteDistance(4000.f),
+	MaxPromotionsPerFrame(4),
+	PatrolSpeed(150.f),
+	ChaseSpeed(450.f),
+	MaxGroundQueriesPerFrame(64),
+	GroundQueryHeight(500.f),
+	NextGroundAgent(0),
+	NumPromoted(0)
+{
+
+}
+
+void UEnemyHordeSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_HordeAgents, Agents.Num());
+	DEC_DWORD_STAT_BY(STAT_HordePromoted, NumPromoted);
+	Agents.Empty();
+	NumPromoted = 0;
+
+	Super::Deinitialize();
+}
+
+TStatId UEnemyHordeSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyHordeSubsystem, STATGROUP_Tickables);
+}
+
+bool UEnemyHordeSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemyHordeSubsystem::AddAgent(TSubclassOf<AEnemy> EnemyClass, const FVector& Location, float Health, const FVector& PatrolPoint, const FVector& PatrolPoint2)
+{
+	if (EnemyClass == nullptr) return;
+	FHordeAgent& Agent = Agents.AddDefaulted_GetRef();
+	Agent.EnemyClass = EnemyClass;
+	Agent.Location = Location;
+	Agent.Health = Health;
+	Agent.PatrolPoints[0] = PatrolPoint;
+	Agent.PatrolPoints[1] = PatrolPoint2;
+	GroundAgent(Agent);
+	INC_DWORD_STAT(STAT_HordeAgents);
+}
+
+void UEnemyHordeSubsystem::SpawnHorde(int32 Count, const FVector& Center, float Radius, TSubclassOf<AEnemy> EnemyClass)
+{
+	if (EnemyClass == nullptr) EnemyClass = DefaultEnemyClass.LoadSynchronous();
+	if (EnemyClass == nullptr)
+	{
+		//A bare AEnemy has no mesh, brain or weapons, promoting one would look like the horde vanished
+		UE_LOG(LogArcorox, Error, TEXT("SpawnHorde: DefaultEnemyClass '%s' in [/Script/Arcorox.EnemyHordeSubsystem] did not load, no agents added"), *DefaultEnemyClass.ToString());
+		return;
+	}
+	const float Health = EnemyClass->GetDefaultObject<AEnemy>()->GetMaxHealth();
+	for (int32 i = 0; i < Count; i++)
+	{
+		const FVector Offset{ FMath::VRand().GetSafeNormal2D() * FMath::FRandRange(PromoteDistance, FMath::Max(Radius, PromoteDistance)) };
+		const FVector Location{ Center + Offset };
+		const FVector PatrolOffset{ FMath::VRand().GetSafeNormal2D() * FMath::FRandRange(300.f, 1000.f) };
+		AddAgent(EnemyClass, Location, Health, Location + PatrolOffset, Location - PatrolOffset);
+	}
+}
+
+void UEnemyHordeSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Agents.Num() == 0) return;
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (PlayerController == nullptr || PlayerController->GetPawn() == nullptr) return;
+	const FVector PlayerLocation{ PlayerController->GetPawn()->GetActorLocation() };
+
+	SteerAgents(DeltaTime, PlayerLocation);
+	UpdatePromotions(PlayerLocation);
+}
+
+void UEnemyHordeSubsystem::SteerAgents(float DeltaTime, const FVector& PlayerLocation)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HordeSteering);
+	for (FHordeAgent& Agent : Agents)
+	{
+		if (Agent.bPromoted) continue;
+		FVector Goal{ Agent.bAggro ? PlayerLocation : Agent.PatrolPoints[Agent.PatrolIndex] };
+		//Steering is flat, height comes from the round robin ground queries below
+		Goal.Z = Agent.Location.Z;
+		const FVector ToGoal{ Goal - Agent.Location };
+		const float DistanceToGoal = ToGoal.Size();
+		const float Step = (Agent.bAggro ? ChaseSpeed : PatrolSpeed) * DeltaTime;
+		if (DistanceToGoal <= Step)
+		{
+			Agent.Location = Goal;
+			if (!Agent.bAggro) Agent.PatrolIndex = 1 - Agent.PatrolIndex;
+			continue;
+		}
+		const FVector Direction{ ToGoal / DistanceToGoal };
+		Agent.Location += Direction * Step;
+		Agent.Yaw = Direction.Rotation().Yaw;
+	}
+
+	const int32 NumGroundQueries = FMath::Min(MaxGroundQueriesPerFrame, Agents.Num());
+	for (int32 i = 0; i < NumGroundQueries; i++)
+	{
+		NextGroundAgent = (NextGroundAgent + 1) % Agents.Num();
+		if (!Agents[NextGroundAgent].bPromoted) GroundAgent(Agents[NextGroundAgent]);
+	}
+}
+
+void UEnemyHordeSubsystem::GroundAgent(FHordeAgent& Agent) const
+{
+	INC_DWORD_STAT(STAT_HordeGroundQueries);
+	const UCapsuleComponent* Capsule = Agent.EnemyClass->GetDefaultObject<AEnemy>()->GetCapsuleComponent();
+	const float HalfHeight = Capsule ? Capsule->GetScaledCapsuleHalfHeight() : 0.f;
+	const FVector Feet{ Agent.Location - FVector(0.f, 0.f, HalfHeight) };
+	UNavigationSystemV1* NavSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	FNavLocation NavLocation;
+	if (NavSystem && NavSystem->ProjectPointToNavigation(Feet, NavLocation, FVector(50.f, 50.f, GroundQueryHeight)))
+	{
+		Agent.Location.Z = NavLocation.Location.Z + HalfHeight;
+		return;
+	}
+	//Only static geometry counts as floor, promoted enemies and pickups are ignored
+	FHitResult Hit;
+	const FVector Up{ 0.f, 0.f, GroundQueryHeight };
+	if (GetWorld()->LineTraceSingleByObjectType(Hit, Feet + Up, Feet - Up, FCollisionObjectQueryParams(ECollisionChannel::ECC_WorldStatic), FCollisionQueryParams(SCENE_QUERY_STAT(HordeGround))))
+	{
+		Agent.Location.Z = Hit.ImpactPoint.Z + HalfHeight;
+	}
+}
+
+void UEnemyHordeSubsystem::UpdatePromotions(const FVector& PlayerLocation)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HordePromotion);
+	const float PromoteDistanceSquared = PromoteDistance * PromoteDistance;
+	const float DemoteDistanceSquared = DemoteDistance * DemoteDistance;
+	int32 Promotions = 0;
+	for (int32 i = Agents.Num() - 1; i >= 0; i--)
+	{
+		FHordeAgent& Agent = Agents[i];
+		if (Agent.bPromoted)
+		{
+			AEnemy* Enemy = Agent.Actor.Get();
+			//Promoted enemies that died, were pooled or were destroyed leave the horde
+			if (Enemy == nullptr || Enemy->IsDead() || Enemy->IsInPool())
+			{
+				NumPromoted--;
+				DEC_DWORD_STAT(STAT_HordePromoted);
+				DEC_DWORD_STAT(STAT_HordeAgents);
+				Agents.RemoveAtSwap(i, 1, false);
+				continue;
+			}
+			if (FVector::DistSquared(Enemy->GetActorLocation(), PlayerLocation) > DemoteDistanceSquared) DemoteAgent(Agent);
+		}
+		else if (Promotions < MaxPromotionsPerFrame && FVector::DistSquared(Agent.Location, PlayerLocation) < PromoteDistanceSquared)
+		{
+			if (PromoteAgent(Agent)) Promotions++;
+		}
+	}
+}
+
+bool UEnemyHordeSubsystem::PromoteAgent(FHordeAgent& Agent)
+{
+	UEnemyPoolSubsystem* Pool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>();
+	if (Pool == nullptr) return false;
+	//The round robin may not have reached the agent since it last moved
+	GroundAgent(Agent);
+	const FTransform SpawnTransform{ FRotator(0.f, Agent.Yaw, 0.f), Agent.Location };
+	AEnemy* Enemy = Pool->AcquireEnemy(Agent.EnemyClass, SpawnTransform, Agent.Health, Agent.PatrolPoints[0], Agent.PatrolPoints[1]);
+	if (Enemy == nullptr) return false;
+	if (Agent.bAggro)
+	{
+		APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+		if (PlayerController) Enemy->SetTarget(PlayerController->GetPawn());
+	}
+	Agent.Actor = Enemy;
+	Agent.bPromoted = true;
+	NumPromoted++;
+	INC_DWORD_STAT(STAT_HordePromoted);
+	return true;
+}
+
+void UEnemyHordeSubsystem::DemoteAgent(FHordeAgent& Agent)
+{
+	AEnemy* Enemy = Agent.Actor.Get();
+	if (Enemy)
+	{
+		Agent.Location = Enemy->GetActorLocation();
+		Agent.Yaw = Enemy->GetActorRotation().Yaw;
+		Agent.Health = Enemy->GetHealth();
+		Agent.bAggro = Enemy->HasTarget();
+		Enemy->GetWorldPatrolPoints(Agent.PatrolPoints[0], Agent.PatrolPoints[1]);
+		UEnemyPoolSubsystem* Pool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>();
+		if (Pool) Pool->ReleaseEnemy(Enemy);
+		else Enemy->Destroy();
+	}
+	Agent.Actor.Reset();
+	Agent.bPromoted = false;
+	NumPromoted--;
+	DEC_DWORD_STAT(STAT_HordePromoted);
+}
+
+void UEnemyHordeSubsystem::LogHordeReport() const
+{
+	UE_LOG(LogArcorox, Display, TEXT("Horde agents: %d, promoted actors: %d, game thread: %.2f ms"), Agents.Num(), NumPromoted, FPlatformTime::ToMilliseconds(GGameThreadTime));
+}
@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyPoolSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Spawn"), STAT_EnemySpawn, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Enemy Reuse"), STAT_EnemyReuse, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemies Pooled"), STAT_EnemiesPooled, STATGROUP_Arcorox);
+
+static const int32 DefaultTestWaveSize = 100;
+
+static void SpawnEnemyWaveCommand(const TArray<FString>& Args, UWorld* World)
+{
+	UEnemyPoolSubsystem* Pool = World ? World->GetSubsystem<UEnemyPoolSubsystem>() : nullptr;
+	APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	if (Pool == nullptr || PlayerController == nullptr || PlayerController->GetPawn() == nullptr) return;
+	const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : DefaultTestWaveSize;
+	const bool bPooled = Args.Num() > 1 ? FCString::ToBool(*Args[1]) : true;
+	Pool->SpawnTestWave(Count, PlayerController->GetPawn()->GetActorLocation(), 5000.f, bPooled, Args.Num() > 2 ? Args[2] : FString());
+}
+
+static void LogEnemyPoolCommand(UWorld* World)
+{
+	if (UEnemyPoolSubsystem* Pool = World ? World->GetSubsystem<UEnemyPoolSubsystem>() : nullptr) Pool->LogPoolReport();
+}
+
+static FAutoConsoleCommandWithWorldAndArgs SpawnEnemyWaveConsoleCommand(
+	TEXT("arcorox.Enemy.SpawnWave"),
+	TEXT("Replaces the last test wave with Count enemies and logs total and worst spawn time. Usage: arcorox.Enemy.SpawnWave <Count> <bPooled> <EnemyClassPath>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&SpawnEnemyWaveCommand));
+
+static FAutoConsoleCommandWithWorld LogEnemyPoolConsoleCommand(
+	TEXT("arcorox.Enemy.PoolReport"),
+	TEXT("Logs the number of pooled enemies per class."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&LogEnemyPoolCommand));
+
+UEnemyPoolSubsystem::UEnemyPoolSubsystem() :
+	//Holds a whole default test wave so a pooled wave reuses every enemy
+	MaxPooledPerClass(128),
+	bPoolingEnabled(true)
+{
+
+}
+
+void UEnemyPoolSubsystem::Deinitialize()
+{
+	for (const TPair<TSubclassOf<AEnemy>, FEnemyPoolBucket>& Pool : Pools)
+	{
+		DEC_DWORD_STAT_BY(STAT_EnemiesPooled, Pool.Value.Enemies.Num());
+	}
+	Pools.Empty();
+	TestWave.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UEnemyPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+AEnemy* UEnemyPoolSubsystem::AcquireEnemy(TSubclassOf<AEnemy> EnemyClass, const FTransform& Transform, float Health, const FVector& PatrolPoint, const FVector& PatrolPoint2)
+{
+	if (EnemyClass == nullptr) return nullptr;
+	FEnemyPoolBucket* Pool = Pools.Find(EnemyClass);
+	while (Pool && Pool->Enemies.Num() > 0)
+	{
+		AEnemy* Enemy = Pool->Enemies.Pop(false);
+		DEC_DWORD_STAT(STAT_EnemiesPooled);
+		if (!IsValid(Enemy)) continue;
+		SCOPE_CYCLE_COUNTER(STAT_EnemyReuse);
+		Enemy->ActivateFromPool(Transform, Health, PatrolPoint, PatrolPoint2);
+		return Enemy;
+	}
+	return SpawnEnemy(EnemyClass, Transform, Health, PatrolPoint, PatrolPoint2);
+}
+
+AEnemy* UEnemyPoolSubsystem::SpawnEnemy(TSubclassOf<AEnemy> EnemyClass, const FTransform& Transform, float Health, const FVector& PatrolPoint, const FVector& PatrolPoint2)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemySpawn);
+	AEnemy* Enemy = GetWorld()->SpawnActorDeferred<AEnemy>(EnemyClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+	if (Enemy == nullptr) return nullptr;
+	Enemy->SetHordeState(Health, PatrolPoint, PatrolPoint2);
+	//The controller must exist before BeginPlay so the behavior tree starts with the given patrol points
+	Enemy->AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+	Enemy->FinishSpawning(Transform);
+	return Enemy;
+}
+
+void UEnemyPoolSubsystem::ReleaseEnemy(AEnemy* Enemy)
+{
+	if (!IsValid(Enemy) || Enemy->IsInPool()) return;
+	FEnemyPoolBucket& Pool = Pools.FindOrAdd(Enemy->GetClass());
+	if (!bPoolingEnabled || Pool.Enemies.Num() >= MaxPooledPerClass)
+	{
+		Enemy->Destroy();
+		return;
+	}
+	Enemy->DeactivateForPool();
+	Pool.Enemies.Add(Enemy);
+	INC_DWORD_STAT(STAT_EnemiesPooled);
+}
+
+TSubclassOf<AEnemy> UEnemyPoolSubsystem::ResolveTestWaveClass(const FString& ClassPath) const
+{
+	if (!ClassPath.IsEmpty()) return TSoftClassPtr<AEnemy>(FSoftObjectPath(ClassPath)).LoadSynchronous();
+	if (TSubclassOf<AEnemy> EnemyClass = DefaultEnemyClass.LoadSynchronous()) return EnemyClass;
+	//Enemies placed in the level are the Blueprint class the game actually fights
+	for (TActorIterator<AEnemy> It(GetWorld()); It; ++It)
+	{
+		if (It->GetClass() != AEnemy::StaticClass() && !It->IsInPool()) return It->GetClass();
+	}
+	return nullptr;
+}
+
+void UEnemyPoolSubsystem::SpawnTestWave(int32 Count, const FVector& Center, float Radius, bool bPooled, const FString& ClassPath)
+{
+	//Bare AEnemy spawns skip the mesh, anim and brain setup the wave is meant to measure
+	const TSubclassOf<AEnemy> EnemyClass = ResolveTestWaveClass(ClassPath);
+	if (EnemyClass == nullptr)
+	{
+		UE_LOG(LogArcorox, Error, TEXT("SpawnTestWave: no enemy class, pass a class path, set DefaultEnemyClass in [/Script/Arcorox.EnemyPoolSubsystem] or place an enemy Blueprint in the level"));
+		return;
+	}
+	if (bPooled && Count > MaxPooledPerClass)
+	{
+		UE_LOG(LogArcorox, Warning, TEXT("SpawnTestWave: %d enemies exceed MaxPooledPerClass %d, %d of the next pooled wave will be fresh spawns"), Count, MaxPooledPerClass, Count - MaxPooledPerClass);
+	}
+	for (const TWeakObjectPtr<AEnemy>& Enemy : TestWave)
+	{
+		if (!Enemy.IsValid()) continue;
+		if (bPooled) ReleaseEnemy(Enemy.Get());
+		else Enemy->Destroy();
+	}
+	TestWave.Reset();
+
+	const float Health = EnemyClass->GetDefaultObject<AEnemy>()->GetMaxHealth();
+	double TotalSeconds = 0.0;
+	double WorstSeconds = 0.0;
+	for (int32 i = 0; i < Count; i++)
+	{
+		const FVector Location{ Center + FMath::VRand().GetSafeNormal2D() * FMath::FRandRange(500.f, FMath::Max(Radius, 500.f)) };
+		const FTransform Transform{ FRotator(0.f, FMath::FRandRange(0.f, 360.f), 0.f), Location };
+		const double StartSeconds = FPlatformTime::Seconds();
+		AEnemy* Enemy = bPooled ? AcquireEnemy(EnemyClass, Transform, Health, Location, Location) : SpawnEnemy(EnemyClass, Transform, Health, Location, Location);
+		const double ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+		TotalSeconds += ElapsedSeconds;
+		WorstSeconds = FMath::Max(WorstSeconds, ElapsedSeconds);
+		if (Enemy) TestWave.Add(Enemy);
+	}
+	UE_LOG(LogArcorox, Display, TEXT("%s wave of %d %s: total %.2f ms, average %.3f ms, worst %.3f ms"),
+		bPooled ? TEXT("Pooled") : TEXT("Unpooled"), TestWave.Num(), *EnemyClass->GetName(), TotalSeconds * 1000.0, Count > 0 ? TotalSeconds * 1000.0 / Count : 0.0, WorstSeconds * 1000.0);
+}
+
+void UEnemyPoolSubsystem::LogPoolReport() const
+{
+	for (const TPair<TSubclassOf<AEnemy>, FEnemyPoolBucket>& Pool : Pools)
+	{
+		UE_LOG(LogArcorox, Display, TEXT("%s: %d pooled"), *GetNameSafe(Pool.Key), Pool.Value.Enemies.Num());
+	}
+}
@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyProximitySubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Characters/ArcoroxCharacter.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Proximity"), STAT_EnemyProximity, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Proximity Evaluated"), STAT_EnemyProximityEvaluated, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Proximity Transitions"), STAT_EnemyProximityTransitions, STATGROUP_Arcorox);
+
+static void LogEnemyProximity(UWorld* World)
+{
+	if (UEnemyProximitySubsystem* Proximity = World ? World->GetSubsystem<UEnemyProximitySubsystem>() : nullptr) Proximity->LogProximityReport();
+}
+
+static FAutoConsoleCommandWithWorld LogEnemyProximityCommand(
+	TEXT("arcorox.Enemy.ProximityReport"),
+	TEXT("Logs registered and evaluated enemies, grid cells and the time of the last aggro and attack range pass."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&LogEnemyProximity));
+
+UEnemyProximitySubsystem::UEnemyProximitySubsystem() :
+	CellSize(1000.f),
+	MinEnemiesForParallel(64),
+	MaxPlayerRadius(0.f),
+	NumEvaluated(0),
+	LastPassMs(0.0)
+{
+}
+
+void UEnemyProximitySubsystem::Deinitialize()
+{
+	Entries.Empty();
+	Cells.Empty();
+	PlayerCells.Empty();
+	Players.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UEnemyProximitySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyProximitySubsystem, STATGROUP_Tickables);
+}
+
+bool UEnemyProximitySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemyProximitySubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr) return;
+	Entries.Add(FProximityEntry{ Enemy, false, false });
+}
+
+void UEnemyProximitySubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	//Cleared rather than removed so grid indices stay valid until the next pass compacts the entries
+	for (FProximityEntry& Entry : Entries)
+	{
+		if (Entry.Enemy == Enemy) Entry.Enemy = nullptr;
+	}
+}
+
+void UEnemyProximitySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_EnemyProximity);
+	const double StartTime = FPlatformTime::Seconds();
+	BuildGrids();
+
+	const int32 NumEnemies = Entries.Num();
+	AggroPlayers.Init(INDEX_NONE, NumEnemies);
+	AttackResults.Init(false, NumEnemies);
+	if (Players.Num() > 0)
+	{
+		//Each iteration only reads the grids and writes its own result slots
+		ParallelFor(NumEnemies, [this](int32 Index) { EvaluateEnemy(Index); }, NumEnemies < MinEnemiesForParallel);
+	}
+
+	//Only transitions reach the enemies and their blackboards
+	for (int32 i = 0; i < NumEnemies; i++)
+	{
+		if (!EnemyEvaluated[i]) continue;
+		AEnemy* Enemy = Entries[i].Enemy.Get();
+		if (Enemy == nullptr) continue;
+		FProximityEntry& Entry = Entries[i];
+		const bool bInAggroRange = AggroPlayers[i] != INDEX_NONE;
+		if (bInAggroRange != Entry.bInAggroRange)
+		{
+			Entry.bInAggroRange = bInAggroRange;
+			if (bInAggroRange) Enemy->SetTarget(Players[AggroPlayers[i]]);
+			INC_DWORD_STAT(STAT_EnemyProximityTransitions);
+		}
+		if (AttackResults[i] != Entry.bInAttackRange)
+		{
+			Entry.bInAttackRange = AttackResults[i];
+			Enemy->SetInAttackRange(Entry.bInAttackRange);
+			INC_DWORD_STAT(STAT_EnemyProximityTransitions);
+		}
+	}
+	LastPassMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+}
+
+void UEnemyProximitySubsystem::BuildGrids()
+{
+	Entries.RemoveAllSwap([](const FProximityEntry& Entry) { return !Entry.Enemy.IsValid(); }, false);
+
+	Players.Reset();
+	PlayerLocations.Reset();
+	PlayerRadii.Reset();
+	PlayerCells.Reset();
+	MaxPlayerRadius = 0.f;
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		AArcoroxCharacter* Character = Iterator->IsValid() ? Cast<AArcoroxCharacter>((*Iterator)->GetPawn()) : nullptr;
+		if (Character == nullptr) continue;
+		const int32 PlayerIndex = Players.Add(Character);
+		PlayerLocations.Add(Character->GetActorLocation());
+		//The spheres overlapped the player capsule, so its radius extends every range
+		PlayerRadii.Add(Character->GetSimpleCollisionRadius());
+		MaxPlayerRadius = FMath::Max(MaxPlayerRadius, PlayerRadii[PlayerIndex]);
+		PlayerCells.FindOrAdd(GetCell(PlayerLocations[PlayerIndex])).Add(PlayerIndex);
+	}
+
+	const int32 NumEnemies = Entries.Num();
+	EnemyLocations.SetNumUninitialized(NumEnemies, false);
+	AggroRadii.SetNumUninitialized(NumEnemies, false);
+	AttackRadii.SetNumUninitialized(NumEnemies, false);
+	EnemyEvaluated.SetNumUninitialized(NumEnemies, false);
+	for (TPair<FIntPoint, TArray<int32>>& Cell : Cells) Cell.Value.Reset();
+	NumEvaluated = 0;
+	for (int32 i = 0; i < NumEnemies; i++)
+	{
+		const AEnemy* Enemy = Entries[i].Enemy.Get();
+		EnemyLocations[i] = Enemy->GetActorLocation();
+		AggroRadii[i] = Enemy->GetAggroRadius();
+		AttackRadii[i] = Enemy->GetAttackRangeRadius();
+		const bool bLive = !Enemy->IsDead() && !Enemy->IsInPool();
+		EnemyEvaluated[i] = bLive && Enemy->ShouldUpdateProximity();
+		if (bLive) Cells.FindOrAdd(GetCell(EnemyLocations[i])).Add(i);
+		if (EnemyEvaluated[i]) NumEvaluated++;
+	}
+	//Cells emptied for several passes are dropped, the rest keep their allocation
+	if (Cells.Num() > NumEnemies * 2) Cells = Cells.FilterByPredicate([](const TPair<FIntPoint, TArray<int32>>& Cell) { return Cell.Value.Num() > 0; });
+	INC_DWORD_STAT_BY(STAT_EnemyProximityEvaluated, NumEvaluated);
+}
+
+void UEnemyProximitySubsystem::EvaluateEnemy(int32 Index)
+{
+	if (!EnemyEvaluated[Index]) return;
+	const FVector& Location = EnemyLocations[Index];
+	const float SearchRadius = FMath::Max(AggroRadii[Index], AttackRadii[Index]) + MaxPlayerRadius;
+	const FIntPoint Min{ GetCell(Location - FVector(SearchRadius)) };
+	const FIntPoint Max{ GetCell(Location + FVector(SearchRadius)) };
+	float NearestDistanceSquared = BIG_NUMBER;
+	for (int32 X = Min.X; X <= Max.X; X++)
+	{
+		for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+		{
+			const TArray<int32>* Cell = PlayerCells.Find(FIntPoint(X, Y));
+			if (Cell == nullptr) continue;
+			for (const int32 PlayerIndex : *Cell)
+			{
+				const float DistanceSquared = FVector::DistSquared(Location, PlayerLocations[PlayerIndex]);
+				if (DistanceSquared <= FMath::Square(AggroRadii[Index] + PlayerRadii[PlayerIndex]) && DistanceSquared < NearestDistanceSquared)
+				{
+					NearestDistanceSquared = DistanceSquared;
+					AggroPlayers[Index] = PlayerIndex;
+				}
+				if (DistanceSquared <= FMath::Square(AttackRadii[Index] + PlayerRadii[PlayerIndex])) AttackResults[Index] = true;
+			}
+		}
+	}
+}
+
+void UEnemyProximitySubsystem::LogProximityReport() const
+{
+	UE_LOG(LogArcorox, Display, TEXT("Enemy proximity: %d registered, %d evaluated against %d players, %d cells, last pass %.3f ms"), Entries.Num(), NumEvaluated, Players.Num(), Cells.Num(), LastPassMs);
+}
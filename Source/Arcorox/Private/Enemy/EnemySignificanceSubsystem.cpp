@@ -0,0 +1,217 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemySignificanceSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "IAnimationBudgetAllocator.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "Misc/App.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Significance"), STAT_EnemySignificance, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Tier Changes"), STAT_EnemyTierChanges, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<int32> CVarEnemyForceTier(
+	TEXT("arcorox.Enemy.ForceSignificanceTier"),
+	-1,
+	TEXT("Forces every enemy into one significance tier to measure its cost, -1 scores enemies normally."));
+
+static TAutoConsoleVariable<int32> CVarEnemyAnimationBudget(
+	TEXT("arcorox.Enemy.AnimationBudget"),
+	-1,
+	TEXT("Overrides bUseAnimationBudget for worlds that begin play after it is set, 0 off, 1 on, -1 uses the config."));
+
+static FEnemySignificanceTier MakeTier(float MaxDistance, float ActorTickInterval, float MovementTickInterval, float BehaviorTreeTickInterval, float AnimationTickInterval, bool bUpdateProximity)
+{
+	FEnemySignificanceTier Tier;
+	Tier.MaxDistance = MaxDistance;
+	Tier.ActorTickInterval = ActorTickInterval;
+	Tier.MovementTickInterval = MovementTickInterval;
+	Tier.BehaviorTreeTickInterval = BehaviorTreeTickInterval;
+	Tier.AnimationTickInterval = AnimationTickInterval;
+	Tier.bUpdateProximity = bUpdateProximity;
+	return Tier;
+}
+
+static void LogEnemySignificance(UWorld* World)
+{
+	if (UEnemySignificanceSubsystem* Significance = World ? World->GetSubsystem<UEnemySignificanceSubsystem>() : nullptr) Significance->LogTierReport();
+}
+
+static FAutoConsoleCommandWithWorld LogEnemySignificanceCommand(
+	TEXT("arcorox.Enemy.SignificanceReport"),
+	TEXT("Logs the number of enemies in each significance tier and the game thread time."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&LogEnemySignificance));
+
+UEnemySignificanceSubsystem::UEnemySignificanceSubsystem() :
+	UpdateInterval(0.25f),
+	bUseAnimationBudget(true),
+	AnimationBudgetMs(2.f),
+	TimeSinceUpdate(0.f)
+{
+	//Defaults, overridable from the [/Script/Arcorox.EnemySignificanceSubsystem] section of DefaultGame.ini
+	Tiers.Add(MakeTier(1500.f, 0.f, 0.f, 0.f, 0.f, true));
+	Tiers.Add(MakeTier(4000.f, 0.05f, 0.033f, 0.1f, 0.033f, true));
+	Tiers.Add(MakeTier(10000.f, 0.2f, 0.1f, 0.25f, 0.1f, false));
+	Tiers.Add(MakeTier(0.f, 0.5f, 0.25f, 0.5f, 0.25f, false));
+}
+
+void UEnemySignificanceSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(&InWorld);
+	if (Allocator == nullptr) return;
+	FAnimationBudgetAllocatorParameters Parameters;
+	Parameters.BudgetInMs = AnimationBudgetMs;
+	Allocator->SetParameters(Parameters);
+	Allocator->SetEnabled(UsesAnimationBudget());
+}
+
+void UEnemySignificanceSubsystem::Deinitialize()
+{
+	Enemies.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UEnemySignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySignificanceSubsystem, STATGROUP_Tickables);
+}
+
+bool UEnemySignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemySignificanceSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (Enemy == nullptr || Tiers.Num() == 0) return;
+	Enemies.Add(FEnemySignificance{ Enemy, 0 });
+	USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(Enemy->GetMesh());
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(GetWorld());
+	if (UsesAnimationBudget() && BudgetedMesh && Allocator)
+	{
+		Allocator->RegisterComponent(BudgetedMesh);
+		Enemy->SetAnimationBudgeted(true);
+	}
+	Enemy->ApplySignificanceTier(Tiers[0]);
+	//Score the new enemy on the next tick
+	TimeSinceUpdate = UpdateInterval;
+}
+
+void UEnemySignificanceSubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	USkeletalMeshComponentBudgeted* BudgetedMesh = Enemy ? Cast<USkeletalMeshComponentBudgeted>(Enemy->GetMesh()) : nullptr;
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(GetWorld());
+	if (BudgetedMesh && Allocator) Allocator->UnregisterComponent(BudgetedMesh);
+	Enemies.RemoveAllSwap([Enemy](const FEnemySignificance& Entry) { return Entry.Enemy == Enemy; }, false);
+}
+
+void UEnemySignificanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TimeSinceUpdate += DeltaTime;
+	if (TimeSinceUpdate < UpdateInterval || Tiers.Num() == 0) return;
+	TimeSinceUpdate = 0.f;
+	SCOPE_CYCLE_COUNTER(STAT_EnemySignificance);
+
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (PlayerController == nullptr) return;
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	const int32 ForcedTier = CVarEnemyForceTier.GetValueOnGameThread();
+	for (int32 i = Enemies.Num() - 1; i >= 0; i--)
+	{
+		AEnemy* Enemy = Enemies[i].Enemy.Get();
+		if (Enemy == nullptr)
+		{
+			Enemies.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+		const float Distance = FVector::Dist(ViewLocation, Enemy->GetActorLocation());
+		UpdateAnimationSignificance(Enemy, Distance);
+		const int32 Tier = Tiers.IsValidIndex(ForcedTier) ? ForcedTier : ScoreEnemy(Enemy, Distance);
+		if (Tier == Enemies[i].Tier) continue;
+		Enemies[i].Tier = Tier;
+		Enemy->ApplySignificanceTier(Tiers[Tier]);
+		INC_DWORD_STAT(STAT_EnemyTierChanges);
+	}
+}
+
+int32 UEnemySignificanceSubsystem::ScoreEnemy(const AEnemy* Enemy, float Distance) const
+{
+	//Enemies engaging the player always run at full rate
+	if (Enemy->HasTarget()) return 0;
+	int32 Tier = Tiers.Num() - 1;
+	for (int32 i = 0; i < Tiers.Num() - 1; i++)
+	{
+		if (Distance < Tiers[i].MaxDistance)
+		{
+			Tier = i;
+			break;
+		}
+	}
+	//Enemies out of sight drop one tier
+	if (!Enemy->WasRecentlyRendered(UpdateInterval)) Tier = FMath::Min(Tier + 1, Tiers.Num() - 1);
+	return Tier;
+}
+
+bool UEnemySignificanceSubsystem::UsesAnimationBudget() const
+{
+	const int32 Override = CVarEnemyAnimationBudget.GetValueOnGameThread();
+	return Override < 0 ? bUseAnimationBudget : Override > 0;
+}
+
+void UEnemySignificanceSubsystem::UpdateAnimationSignificance(AEnemy* Enemy, float Distance) const
+{
+	USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(Enemy->GetMesh());
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(GetWorld());
+	if (!UsesAnimationBudget() || BudgetedMesh == nullptr || Allocator == nullptr) return;
+	//Swinging enemies keep a full rate pose, on screen or not, so melee sweeps follow the real weapon path
+	const bool bEngaged = !Enemy->IsDead() && (Enemy->IsInAttackRange() || Enemy->IsAttacking());
+	const float FalloffDistance = Tiers.Num() > 1 ? Tiers[Tiers.Num() - 2].MaxDistance : 1.f;
+	float Significance = 1.f - FMath::Clamp(Distance / FalloffDistance, 0.f, 1.f);
+	if (bEngaged) Significance = 1.f;
+	else if (Enemy->IsDead()) Significance = 0.f;
+	Allocator->SetComponentSignificance(BudgetedMesh, Significance, bEngaged, bEngaged);
+}
+
+void UEnemySignificanceSubsystem::LogTierReport() const
+{
+	TArray<int32> TierCounts;
+	TArray<float> TierRates;
+	TArray<int32> TierInterpolated;
+	TierCounts.Init(0, Tiers.Num());
+	TierRates.Init(0.f, Tiers.Num());
+	TierInterpolated.Init(0, Tiers.Num());
+	const float FrameRate = FApp::GetDeltaTime() > 0.0 ? 1.f / FApp::GetDeltaTime() : 0.f;
+	for (const FEnemySignificance& Entry : Enemies)
+	{
+		const AEnemy* Enemy = Entry.Enemy.Get();
+		if (Enemy == nullptr || !TierCounts.IsValidIndex(Entry.Tier)) continue;
+		TierCounts[Entry.Tier]++;
+		const USkeletalMeshComponent* Mesh = Enemy->GetMesh();
+		if (Mesh == nullptr) continue;
+		//Budgeted meshes evaluate every ExternalTickRate frames, the rest at their tick interval
+		float Rate = FrameRate;
+		if (Mesh->IsUsingExternalTickRateControl()) Rate = FrameRate / FMath::Max<int32>(Mesh->GetExternalTickRate(), 1);
+		else if (Mesh->PrimaryComponentTick.TickInterval > 0.f) Rate = FMath::Min(FrameRate, 1.f / Mesh->PrimaryComponentTick.TickInterval);
+		TierRates[Entry.Tier] += Rate;
+		if (Mesh->IsUsingExternalInterpolation()) TierInterpolated[Entry.Tier]++;
+	}
+	UE_LOG(LogArcorox, Display, TEXT("Enemies: %d, game thread: %.2f ms, forced tier: %d"), Enemies.Num(), FPlatformTime::ToMilliseconds(GGameThreadTime), CVarEnemyForceTier.GetValueOnGameThread());
+	UE_LOG(LogArcorox, Display, TEXT("Animation budget: %s, %.2f ms per frame (stat AnimationBudgetAllocator for the measured load)"), UsesAnimationBudget() ? TEXT("on") : TEXT("off"), AnimationBudgetMs);
+	for (int32 i = 0; i < TierCounts.Num(); i++)
+	{
+		const float AverageRate = TierCounts[i] > 0 ? TierRates[i] / TierCounts[i] : 0.f;
+		UE_LOG(LogArcorox, Display, TEXT("  Tier %d: %d enemies, %.1f Hz animation, %d interpolated"), i, TierCounts[i], AverageRate, TierInterpolated[i]);
+	}
+}
@@ -4,10 +4,20 @@
 #include "Explosive/Explosive.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Kismet/GameplayStatics.h"
+#include "Effects/CombatFXSubsystem.h"
+#include "Audio/CombatAudioSubsystem.h"
+#include "Combat/ExplosionSubsystem.h"
 
-AExplosive::AExplosive()
+AExplosive::AExplosive() :
+	BaseDamage(100.f),
+	MinimumDamage(10.f),
+	DamageInnerRadius(150.f),
+	DamageOuterRadius(500.f),
+	DamageFalloff(1.f),
+	ImpulseStrength(1200.f),
+	bDetonationQueued(false)
 {
-	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
 
 }
 
@@ -15,28 +25,45 @@ void AExplosive::BeginPlay()
 {
 	Super::BeginPlay();
 	
+	if (UExplosionSubsystem* Explosions = GetWorld()->GetSubsystem<UExplosionSubsystem>()) Explosions->RegisterExplosive(this);
 }
 
-void AExplosive::Tick(float DeltaTime)
+void AExplosive::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
+	if (UExplosionSubsystem* Explosions = GetWorld() ? GetWorld()->GetSubsystem<UExplosionSubsystem>() : nullptr) Explosions->UnregisterExplosive(this);
 
+	Super::EndPlay(EndPlayReason);
 }
 
-void AExplosive::SpawnExplosionParticles(FHitResult& HitResult)
+void AExplosive::SpawnExplosionParticles(const FVector& Location)
 {
-	if (ExplosionParticles) UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionParticles, HitResult.Location);
+	UCombatFXSubsystem::SpawnEffectAt(this, ECombatFXType::ECFX_Explosion, ExplosionParticles, FTransform(Location));
 }
 
 void AExplosive::PlayExplosionSound()
 {
-	if (ExplosionSound) UGameplayStatics::PlaySoundAtLocation(this, ExplosionSound, GetActorLocation());
+	UCombatAudioSubsystem::PlayCombatSoundAtLocation(this, ECombatSoundCategory::ECSC_Explosion, ExplosionSound, GetActorLocation());
+}
+
+float AExplosive::GetDamageAtDistance(float Distance) const
+{
+	if (Distance > DamageOuterRadius) return 0.f;
+	if (Distance <= DamageInnerRadius || DamageOuterRadius <= DamageInnerRadius) return BaseDamage;
+	const float Alpha = (Distance - DamageInnerRadius) / (DamageOuterRadius - DamageInnerRadius);
+	return FMath::Lerp(MinimumDamage, BaseDamage, FMath::Pow(1.f - Alpha, DamageFalloff));
 }
 
 void AExplosive::Hit_Implementation(FHitResult HitResult)
+{
+	if (bDetonationQueued) return;
+	UExplosionSubsystem* Explosions = GetWorld()->GetSubsystem<UExplosionSubsystem>();
+	if (Explosions) Explosions->QueueDetonation(this, HitResult.Location, GetInstigator(), 0.f);
+	else Detonate(HitResult.Location);
+}
+
+void AExplosive::Detonate(const FVector& Location)
 {
 	PlayExplosionSound();
-	SpawnExplosionParticles(HitResult);
+	SpawnExplosionParticles(Location);
 	Destroy();
 }
-
@@ -2,4 +2,10 @@
 
 
 #include "GameMode/ArcoroxGameModeBase.h"
+#include "HUD/ArcoroxHUD.h"
+
+AArcoroxGameModeBase::AArcoroxGameModeBase()
+{
+	HUDClass = AArcoroxHUD::StaticClass();
+}
 
@@ -0,0 +1,192 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HUD/ArcoroxHUD.h"
+#include "HUD/DamageNumberWidget.h"
+#include "Engine/LocalPlayer.h"
+#include "SceneView.h"
+#include "CanvasItem.h"
+#include "Engine/Canvas.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Damage Numbers Update"), STAT_DamageNumbersUpdate, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Numbers Active"), STAT_DamageNumbersActive, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Health Bars Draw"), STAT_HealthBarsDraw, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Health Bars Drawn"), STAT_HealthBarsDrawn, STATGROUP_Arcorox);
+
+AArcoroxHUD::AArcoroxHUD() :
+	DamageNumberPoolSize(48),
+	DamageNumberLifetime(1.5f),
+	NextDamageNumber(0),
+	NumActiveDamageNumbers(0),
+	HealthBarSize(FVector2D(80.f, 8.f)),
+	HealthBarHeightOffset(110.f),
+	HealthBarColor(FLinearColor(0.8f, 0.05f, 0.05f)),
+	HealthBarBackgroundColor(FLinearColor(0.f, 0.f, 0.f, 0.6f)),
+	ViewProjectionMatrix(FMatrix::Identity),
+	bHasViewProjection(false)
+{
+
+}
+
+void AArcoroxHUD::BeginPlay()
+{
+	Super::BeginPlay();
+
+	DamageNumbers.SetNum(FMath::Max(DamageNumberPoolSize, 1));
+	if (PlayerOwner == nullptr) return;
+	if (DamageNumberClass == nullptr) DamageNumberClass = DefaultDamageNumberClass.LoadSynchronous();
+	if (DamageNumberClass == nullptr)
+	{
+		UE_LOG(LogArcorox, Log, TEXT("%s has no DamageNumberClass and DefaultDamageNumberClass '%s' is not set, enemies show damage numbers through ShowHitDamage"),
+			*GetName(), *DefaultDamageNumberClass.ToString());
+		return;
+	}
+	for (int32 i = 0; i < DamageNumbers.Num(); i++)
+	{
+		UDamageNumberWidget* Widget = CreateWidget<UDamageNumberWidget>(PlayerOwner, DamageNumberClass);
+		if (Widget)
+		{
+			Widget->AddToViewport();
+			Widget->SetVisibility(ESlateVisibility::Collapsed);
+		}
+		DamageNumberWidgets.Add(Widget);
+	}
+}
+
+void AArcoroxHUD::DrawHUD()
+{
+	Super::DrawHUD();
+
+	UpdateViewProjection();
+	UpdateDamageNumbers();
+	DrawHealthBars();
+}
+
+void AArcoroxHUD::UpdateViewProjection()
+{
+	//One view projection matrix for every entry instead of rebuilding the projection per widget
+	ULocalPlayer* LocalPlayer = PlayerOwner ? PlayerOwner->GetLocalPlayer() : nullptr;
+	FSceneViewProjectionData ProjectionData;
+	bHasViewProjection = LocalPlayer && LocalPlayer->ViewportClient && LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, ProjectionData);
+	if (!bHasViewProjection) return;
+	ViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix();
+	ViewRect = ProjectionData.GetConstrainedViewRect();
+}
+
+bool AArcoroxHUD::AddDamageNumber(int32 Damage, const FVector& WorldLocation, bool bHeadshot)
+{
+	if (DamageNumberWidgets.Num() == 0 || GetWorld() == nullptr) return false;
+	const int32 Index = NextDamageNumber;
+	NextDamageNumber = (NextDamageNumber + 1) % DamageNumbers.Num();
+
+	FDamageNumberEntry& Entry = DamageNumbers[Index];
+	if (!Entry.bActive) NumActiveDamageNumbers++;
+	Entry.WorldLocation = WorldLocation;
+	Entry.ExpireTime = GetWorld()->GetTimeSeconds() + DamageNumberLifetime;
+	Entry.bActive = true;
+
+	UDamageNumberWidget* Widget = DamageNumberWidgets.IsValidIndex(Index) ? DamageNumberWidgets[Index] : nullptr;
+	if (Widget) Widget->ShowDamage(Damage, bHeadshot);
+	return true;
+}
+
+void AArcoroxHUD::AddDamageNumberWidget(UUserWidget* Widget, const FVector& WorldLocation)
+{
+	if (Widget == nullptr || GetWorld() == nullptr) return;
+	FDamageNumberEntry& Entry = BlueprintDamageNumbers.AddDefaulted_GetRef();
+	Entry.WorldLocation = WorldLocation;
+	Entry.ExpireTime = GetWorld()->GetTimeSeconds() + DamageNumberLifetime;
+	Entry.bActive = true;
+	BlueprintDamageNumberWidgets.Add(Widget);
+}
+
+void AArcoroxHUD::UpdateDamageNumbers()
+{
+	if (NumActiveDamageNumbers == 0 && BlueprintDamageNumbers.Num() == 0) return;
+	SCOPE_CYCLE_COUNTER(STAT_DamageNumbersUpdate);
+	INC_DWORD_STAT_BY(STAT_DamageNumbersActive, NumActiveDamageNumbers + BlueprintDamageNumbers.Num());
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	for (int32 i = 0; i < DamageNumbers.Num(); i++)
+	{
+		FDamageNumberEntry& Entry = DamageNumbers[i];
+		if (!Entry.bActive) continue;
+		if (Entry.ExpireTime <= Now)
+		{
+			ReleaseDamageNumber(i);
+			continue;
+		}
+		UDamageNumberWidget* Widget = DamageNumberWidgets.IsValidIndex(i) ? DamageNumberWidgets[i] : nullptr;
+		if (Widget) PositionDamageNumberWidget(Widget, Entry.WorldLocation);
+	}
+	for (int32 i = BlueprintDamageNumbers.Num() - 1; i >= 0; i--)
+	{
+		UUserWidget* Widget = BlueprintDamageNumberWidgets[i];
+		if (Widget && BlueprintDamageNumbers[i].ExpireTime > Now)
+		{
+			PositionDamageNumberWidget(Widget, BlueprintDamageNumbers[i].WorldLocation);
+			continue;
+		}
+		if (Widget) Widget->RemoveFromParent();
+		BlueprintDamageNumbers.RemoveAtSwap(i, 1, false);
+		BlueprintDamageNumberWidgets.RemoveAtSwap(i, 1, false);
+	}
+}
+
+void AArcoroxHUD::PositionDamageNumberWidget(UUserWidget* Widget, const FVector& WorldLocation) const
+{
+	FVector2D ScreenPosition;
+	if (bHasViewProjection && FSceneView::ProjectWorldToScreen(WorldLocation, ViewRect, ViewProjectionMatrix, ScreenPosition))
+	{
+		Widget->SetPositionInViewport(ScreenPosition);
+		Widget->SetVisibility(ESlateVisibility::HitTestInvisible);
+	}
+	else Widget->SetVisibility(ESlateVisibility::Collapsed);
+}
+
+void AArcoroxHUD::ReleaseDamageNumber(int32 Index)
+{
+	DamageNumbers[Index].bActive = false;
+	NumActiveDamageNumbers--;
+	if (DamageNumberWidgets.IsValidIndex(Index) && DamageNumberWidgets[Index]) DamageNumberWidgets[Index]->SetVisibility(ESlateVisibility::Collapsed);
+}
+
+void AArcoroxHUD::DrawHealthBars()
+{
+	UHealthBarSubsystem* HealthBars = GetWorld()->GetSubsystem<UHealthBarSubsystem>();
+	if (HealthBars == nullptr || HealthBars->GetNumHealthBars() == 0 || !bHasViewProjection || Canvas == nullptr) return;
+	SCOPE_CYCLE_COUNTER(STAT_HealthBarsDraw);
+
+	HealthBars->GatherHealthBars(HealthBarHeightOffset, HealthBarDrawData);
+	HealthBarTriangles.Reset();
+	for (const FHealthBarDrawData& Bar : HealthBarDrawData)
+	{
+		FVector2D ScreenPosition;
+		if (!FSceneView::ProjectWorldToScreen(Bar.WorldLocation, ViewRect, ViewProjectionMatrix, ScreenPosition)) continue;
+		//Projected positions are relative to the full viewport, canvas positions to the view rect
+		const FVector2D TopLeft{ ScreenPosition - FVector2D(ViewRect.Min) - HealthBarSize * 0.5f };
+		AddHealthBarRect(TopLeft, HealthBarSize, HealthBarBackgroundColor);
+		AddHealthBarRect(TopLeft, FVector2D(HealthBarSize.X * FMath::Clamp(Bar.HealthFraction, 0.f, 1.f), HealthBarSize.Y), HealthBarColor);
+	}
+	if (HealthBarTriangles.Num() == 0) return;
+	INC_DWORD_STAT_BY(STAT_HealthBarsDrawn, HealthBarTriangles.Num() / 4);
+
+	FCanvasTriangleItem TriangleItem(HealthBarTriangles, GWhiteTexture);
+	TriangleItem.BlendMode = SE_BLEND_Translucent;
+	Canvas->DrawItem(TriangleItem);
+}
+
+void AArcoroxHUD::AddHealthBarRect(const FVector2D& Position, const FVector2D& Size, const FLinearColor& Color)
+{
+	const FVector2D BottomRight{ Position + Size };
+	FCanvasUVTri Triangle;
+	Triangle.V0_Color = Triangle.V1_Color = Triangle.V2_Color = Color;
+	Triangle.V0_Pos = Position;
+	Triangle.V1_Pos = FVector2D(BottomRight.X, Position.Y);
+	Triangle.V2_Pos = BottomRight;
+	HealthBarTriangles.Add(Triangle);
+	Triangle.V1_Pos = BottomRight;
+	Triangle.V2_Pos = FVector2D(Position.X, BottomRight.Y);
+	HealthBarTriangles.Add(Triangle);
+}
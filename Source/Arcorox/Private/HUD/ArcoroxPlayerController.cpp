@@ -3,6 +3,7 @@
 
 #include "HUD/ArcoroxPlayerController.h"
 #include "Blueprint/UserWidget.h"
+#include "Characters/ArcoroxCharacter.h"
 
 AArcoroxPlayerController::AArcoroxPlayerController()
 {
@@ -23,3 +24,11 @@ void AArcoroxPlayerController::BeginPlay()
 		}
 	}
 }
+
+void AArcoroxPlayerController::UpdateCameraManager(float DeltaSeconds)
+{
+	Super::UpdateCameraManager(DeltaSeconds);
+
+	AArcoroxCharacter* ArcoroxCharacter = Cast<AArcoroxCharacter>(GetPawn());
+	if (ArcoroxCharacter && ArcoroxCharacter->NeedsCrosshairQuery()) ArcoroxCharacter->UpdateCrosshairQuery(true);
+}
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HUD/HealthBarSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Engine/World.h"
+
+void UHealthBarSubsystem::Deinitialize()
+{
+	HealthBars.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UHealthBarSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHealthBarSubsystem::ShowHealthBar(AEnemy* Enemy, float DisplayTime)
+{
+	if (Enemy == nullptr) return;
+	const float HideTime = GetWorld()->GetTimeSeconds() + DisplayTime;
+	for (FHealthBarEntry& Entry : HealthBars)
+	{
+		if (Entry.Enemy == Enemy)
+		{
+			Entry.HideTime = HideTime;
+			return;
+		}
+	}
+	HealthBars.Add(FHealthBarEntry{ Enemy, HideTime });
+}
+
+void UHealthBarSubsystem::HideHealthBar(AEnemy* Enemy)
+{
+	HealthBars.RemoveAllSwap([Enemy](const FHealthBarEntry& Entry) { return Entry.Enemy == Enemy; }, false);
+}
+
+void UHealthBarSubsystem::GatherHealthBars(float HeightOffset, TArray<FHealthBarDrawData>& OutBars)
+{
+	OutBars.Reset();
+	const float Now = GetWorld()->GetTimeSeconds();
+	for (int32 i = HealthBars.Num() - 1; i >= 0; i--)
+	{
+		AEnemy* Enemy = HealthBars[i].Enemy.Get();
+		if (Enemy == nullptr || HealthBars[i].HideTime <= Now)
+		{
+			HealthBars.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+		//Skip enemies that are off screen or occluded
+		if (!Enemy->WasRecentlyRendered(0.2f)) continue;
+		OutBars.Add(FHealthBarDrawData{ Enemy->GetActorLocation() + FVector(0.f, 0.f, HeightOffset), Enemy->GetHealthFraction() });
+	}
+}
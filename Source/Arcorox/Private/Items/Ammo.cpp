@@ -10,13 +10,12 @@
 
 AAmmo::AAmmo()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
 
 	AmmoMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("AmmoMesh"));
 	SetRootComponent(AmmoMesh);
 
 	GetCollisionBox()->SetupAttachment(GetRootComponent());
-	GetOverlapSphere()->SetupAttachment(GetRootComponent());
 	GetPickupWidget()->SetupAttachment(GetRootComponent());
 
 	AmmoCollisionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AmmoCollisionSphere"));
@@ -24,11 +23,6 @@ AAmmo::AAmmo()
 	AmmoCollisionSphere->SetSphereRadius(50.f);
 }
 
-void AAmmo::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-}
-
 void AAmmo::BeginPlay()
 {
 	Super::BeginPlay();
@@ -38,6 +32,14 @@ void AAmmo::BeginPlay()
 	AmmoCollisionSphere->OnComponentBeginOverlap.AddDynamic(this, &AAmmo::AmmoSphereOverlap);
 }
 
+void AAmmo::ActivateFromPool(const FTransform& Transform)
+{
+	Super::ActivateFromPool(Transform);
+
+	//Disabled when the ammo was collected
+	AmmoCollisionSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+}
+
 void AAmmo::SetItemProperties(EItemState State)
 {
 	Super::SetItemProperties(State);
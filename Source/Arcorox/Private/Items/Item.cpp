@@ -5,10 +5,30 @@
 #include "Characters/ArcoroxCharacter.h"
 #include "Components/BoxComponent.h"
 #include "Components/WidgetComponent.h"
-#include "Components/SphereComponent.h"
+#include "Animation/AnimInstance.h"
 #include "Camera/CameraComponent.h"
 #include "Kismet/GameplayStatics.h"
+#include "Materials/MaterialInstanceDynamic.h"
 #include "Curves/CurveVector.h"
+#include "UObject/UObjectIterator.h"
+#include "UObject/UObjectHash.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Items/LootIndexSubsystem.h"
+#include "Items/ItemUpdateSubsystem.h"
+#include "Combat/CombatDataRegistry.h"
+#include "Audio/CombatAudioSubsystem.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Items Dormant"), STAT_ItemsDormant, STATGROUP_Arcorox);
+
+static TAutoConsoleVariable<bool> CVarItemDormancy(
+	TEXT("arcorox.Items.Dormancy"),
+	true,
+	TEXT("Suspend ticking, animation and physics state of items held in the inventory or the pickup pool (1) or leave them running hidden (0). Applies on the next item state change."));
+
+/* Used while a rarity has no row in the table */
+static const FItemRarityTable DefaultRarityArchetype;
 
 AItem::AItem() :
 	ItemName(FString("Item")),
@@ -25,14 +45,24 @@ AItem::AItem() :
 	InterpLocationIndex(1),
 	MaterialIndex(0),
 	bCanChangeCustomDepth(true),
+	bMaterialUsesPrimitiveData(false),
 	MaterialPulseCurveTime(5.f),
 	GlowAmount(150.f),
 	FresnelExponent(3.f),
 	FresnelReflectFraction(4.f),
 	InventorySlotIndex(0),
-	bCharacterInventoryFull(false)
+	bCharacterInventoryFull(false),
+	RarityArchetype(nullptr),
+	ItemUpdateIndex(INDEX_NONE),
+	bInPool(false),
+	bDormant(false),
+	MaterialPulse(EItemMaterialPulse::EIMP_None),
+	MaterialPulseStartTime(0.f),
+	MaterialPulseDuration(0.f),
+	BlastSettleTime(0.7f)
 {
-	PrimaryActorTick.bCanEverTick = true;
+	//Per-frame work is driven by UItemUpdateSubsystem only while the item is animating
+	PrimaryActorTick.bCanEverTick = false;
 
 	ItemMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("ItemMesh"));
 	ItemMesh->SetSimulatePhysics(false);
@@ -46,19 +76,96 @@ AItem::AItem() :
 
 	PickupWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("PickupWidget"));
 	PickupWidget->SetupAttachment(GetRootComponent());
-
-	OverlapSphere = CreateDefaultSubobject<USphereComponent>(TEXT("OverlapSphere"));
-	OverlapSphere->SetupAttachment(GetRootComponent());
 }
 
-void AItem::Tick(float DeltaTime)
+bool AItem::NeedsItemUpdate() const
 {
-	Super::Tick(DeltaTime);
+	//Material pulse is animated on the GPU unless the material still reads named parameters
+	return bIsInterpolating || NeedsDynamicMaterialPulse();
+}
 
+void AItem::UpdateItem(float DeltaTime)
+{
 	//Interpolate item when in interpolating state 
 	ItemInterpolation(DeltaTime);
 
-	UpdateMaterialPulse();
+	UpdateDynamicMaterialPulse();
+}
+
+void AItem::RefreshItemUpdate()
+{
+	if (!NeedsItemUpdate()) return;
+	if (UItemUpdateSubsystem* ItemUpdate = GetWorld() ? GetWorld()->GetSubsystem<UItemUpdateSubsystem>() : nullptr) ItemUpdate->RegisterItem(this);
+}
+
+void AItem::DeactivateForPool()
+{
+	bInPool = true;
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	if (UItemUpdateSubsystem* ItemUpdate = GetWorld()->GetSubsystem<UItemUpdateSubsystem>()) ItemUpdate->UnregisterItem(this);
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	bIsInterpolating = false;
+	ArcoroxCharacter = nullptr;
+	//PickedUp hides the mesh and leaves the loot index
+	SetItemState(EItemState::EIS_PickedUp);
+	SetMaterialPulse(EItemMaterialPulse::EIMP_None, 0.f);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+}
+
+void AItem::ActivateFromPool(const FTransform& Transform)
+{
+	bInPool = false;
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorScale3D(FVector(1.f));
+	//Mesh, material and rarity of a class never change, only per-instance values are reset
+	ItemCount = GetClass()->GetDefaultObject<AItem>()->ItemCount;
+	bCanChangeCustomDepth = true;
+	bCharacterInventoryFull = false;
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetItemState(EItemState::EIS_Pickup);
+	HidePickupWidget();
+	InitializeCustomDepth();
+	EnableGlowMaterial();
+	StartMaterialPulse();
+}
+
+void AItem::EnterDormancy()
+{
+	if (bDormant || !CVarItemDormancy.GetValueOnGameThread()) return;
+	bDormant = true;
+	INC_DWORD_STAT(STAT_ItemsDormant);
+	//Attached to the character the hidden mesh would still follow every move of the hand socket
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	DormantTickComponents.Reset();
+	ForEachComponent(false, [this](UActorComponent* Component)
+	{
+		if (Component->IsComponentTickEnabled())
+		{
+			Component->SetComponentTickEnabled(false);
+			DormantTickComponents.Add(Component);
+		}
+		UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+		if (Primitive && Primitive->IsPhysicsStateCreated()) Primitive->DestroyPhysicsState();
+	});
+	//Keeps the last pose and anim instance so nothing has to be rebuilt on equip
+	if (ItemMesh) ItemMesh->bNoSkeletonUpdate = true;
+}
+
+void AItem::ExitDormancy()
+{
+	if (!bDormant) return;
+	bDormant = false;
+	DEC_DWORD_STAT(STAT_ItemsDormant);
+	if (ItemMesh) ItemMesh->bNoSkeletonUpdate = false;
+	for (const TWeakObjectPtr<UActorComponent>& Component : DormantTickComponents) if (Component.IsValid()) Component->SetComponentTickEnabled(true);
+	DormantTickComponents.Reset();
+	//Components whose collision is still off get their bodies once the new state enables it
+	ForEachComponent<UPrimitiveComponent>(false, [](UPrimitiveComponent* Primitive)
+	{
+		if (!Primitive->IsPhysicsStateCreated()) Primitive->RecreatePhysicsState();
+	});
 }
 
 void AItem::BeginPlay()
@@ -68,90 +175,61 @@ void AItem::BeginPlay()
 	HidePickupWidget();
 	SetActiveStars();
 
-	//Setup overlap for sphere component
-	OverlapSphere->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnSphereOverlap);
-	OverlapSphere->OnComponentEndOverlap.AddDynamic(this, &AItem::OnSphereEndOverlap);
-
 	SetItemProperties(ItemState);
 	InitializeCustomDepth();
-	StartMaterialPulseTimer();
+	StartMaterialPulse();
+	RefreshItemUpdate();
+}
+
+void AItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (ULootIndexSubsystem* LootIndex = GetWorld()->GetSubsystem<ULootIndexSubsystem>()) LootIndex->RemoveItem(this);
+	if (UItemUpdateSubsystem* ItemUpdate = GetWorld()->GetSubsystem<UItemUpdateSubsystem>()) ItemUpdate->UnregisterItem(this);
+	if (bDormant) DEC_DWORD_STAT(STAT_ItemsDormant);
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AItem::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
 	GetItemRarityDataTableInfo();
-	InitializeDynamicMaterialInstance();
+	InitializeItemMaterial();
 }
 
-void AItem::InitializeDynamicMaterialInstance()
+void AItem::InitializeItemMaterial()
 {
-	if (MaterialInstance)
+	if (MaterialInstance == nullptr || ItemMesh == nullptr) return;
+	if (!bMaterialUsesPrimitiveData)
 	{
+		//Materials not yet reading custom primitive data keep the per-item instance and named parameters
 		DynamicMaterialInstance = UMaterialInstanceDynamic::Create(MaterialInstance, this);
-		DynamicMaterialInstance->SetVectorParameterValue(TEXT("FresnelColor"), GlowColor);
+		DynamicMaterialInstance->SetVectorParameterValue(TEXT("FresnelColor"), GetGlowColor());
 		ItemMesh->SetMaterial(MaterialIndex, DynamicMaterialInstance);
 		EnableGlowMaterial();
+		return;
 	}
+	DynamicMaterialInstance = nullptr;
+	//Items share the material instance so they can batch, rarity and pulse values are per primitive
+	ItemMesh->SetMaterial(MaterialIndex, MaterialInstance);
+	const FLinearColor RarityGlowColor{ GetGlowColor() };
+	ItemMesh->SetCustomPrimitiveDataVector3(ItemPrimitiveData::GlowColor, FVector(RarityGlowColor.R, RarityGlowColor.G, RarityGlowColor.B));
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::GlowAmount, GlowAmount);
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::FresnelExponent, FresnelExponent);
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::FresnelReflectFraction, FresnelReflectFraction);
+	EnableGlowMaterial();
 }
 
-void AItem::GetItemRarityDataTableInfo()
+const FItemRarityTable& AItem::GetRarityArchetype() const
 {
-	FString ItemRarityDataTablePath(TEXT("/Script/Engine.DataTable'/Game/Dynamic/Blueprints/DataTables/ItemRarityDataTable.ItemRarityDataTable'"));
-	UDataTable* ItemRarityDataTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *ItemRarityDataTablePath));
-	if (ItemRarityDataTableObject)
-	{
-		FItemRarityTable* RarityRow = nullptr;
-		switch (ItemRarity)
-		{
-		case EItemRarity::EIR_Damaged:
-			RarityRow = ItemRarityDataTableObject->FindRow<FItemRarityTable>(FName("Damaged"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Common:
-			RarityRow = ItemRarityDataTableObject->FindRow<FItemRarityTable>(FName("Common"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Uncommon:
-			RarityRow = ItemRarityDataTableObject->FindRow<FItemRarityTable>(FName("Uncommon"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Rare:
-			RarityRow = ItemRarityDataTableObject->FindRow<FItemRarityTable>(FName("Rare"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Legendary:
-			RarityRow = ItemRarityDataTableObject->FindRow<FItemRarityTable>(FName("Legendary"), TEXT(""));
-			break;
-		}
-		if (RarityRow)
-		{
-			GlowColor = RarityRow->GlowColor;
-			LightColor = RarityRow->LightColor;
-			DarkColor = RarityRow->DarkColor;
-			NumStars = RarityRow->NumStars;
-			BackgroundIcon = RarityRow->IconBackground;
-			if (GetItemMesh()) GetItemMesh()->SetCustomDepthStencilValue(RarityRow->CustomDepthStencil);
-		}
-	}
+	return RarityArchetype ? *RarityArchetype : DefaultRarityArchetype;
 }
 
-void AItem::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
-{
-	if (OtherActor)
-	{
-		ArcoroxCharacter = Cast<AArcoroxCharacter>(OtherActor);
-		if (ArcoroxCharacter)ArcoroxCharacter->IncrementOverlappedItemCount(1);
-	}
-}
-
-void AItem::OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+void AItem::GetItemRarityDataTableInfo()
 {
-	if (OtherActor)
-	{
-		ArcoroxCharacter = Cast<AArcoroxCharacter>(OtherActor);
-		if (ArcoroxCharacter)
-		{
-			ArcoroxCharacter->IncrementOverlappedItemCount(-1);
-			ArcoroxCharacter->UnhighlightInventorySlot();
-		}
-	}
+	UCombatDataRegistry* Registry = UCombatDataRegistry::Get();
+	RarityArchetype = Registry ? Registry->GetItemRarityArchetype(ItemRarity) : nullptr;
+	if (RarityArchetype && GetItemMesh()) GetItemMesh()->SetCustomDepthStencilValue(RarityArchetype->CustomDepthStencil);
 }
 
 void AItem::SetActiveStars()
@@ -182,6 +260,9 @@ void AItem::SetActiveStars()
 
 void AItem::SetItemProperties(EItemState State)
 {
+	UpdateLootIndex(State);
+	//Woken before the state below so collision and physics changes apply to live components
+	if (State != EItemState::EIS_PickedUp) ExitDormancy();
 	switch (State)
 	{
 		case EItemState::EIS_Pickup:
@@ -189,8 +270,6 @@ void AItem::SetItemProperties(EItemState State)
 			ItemMesh->SetEnableGravity(false);
 			ItemMesh->SetVisibility(true);
 			DisableMeshCollision();
-			OverlapSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
-			OverlapSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 			DisableBoxCollision();
 			CollisionBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
 			CollisionBox->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
@@ -201,7 +280,6 @@ void AItem::SetItemProperties(EItemState State)
 			ItemMesh->SetEnableGravity(false);
 			ItemMesh->SetVisibility(true);
 			DisableMeshCollision();
-			DisableSphereCollision();
 			DisableBoxCollision();
 			break;
 		case EItemState::EIS_Falling:
@@ -211,7 +289,6 @@ void AItem::SetItemProperties(EItemState State)
 			ItemMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
 			ItemMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 			ItemMesh->SetCollisionResponseToChannel(ECollisionChannel::ECC_WorldStatic, ECollisionResponse::ECR_Block);
-			DisableSphereCollision();
 			DisableBoxCollision();
 			break;
 		case EItemState::EIS_EquipInterpolating:
@@ -220,7 +297,6 @@ void AItem::SetItemProperties(EItemState State)
 			ItemMesh->SetEnableGravity(false);
 			ItemMesh->SetVisibility(true);
 			DisableMeshCollision();
-			DisableSphereCollision();
 			DisableBoxCollision();
 			break;
 		case EItemState::EIS_PickedUp:
@@ -229,12 +305,21 @@ void AItem::SetItemProperties(EItemState State)
 			ItemMesh->SetEnableGravity(false);
 			ItemMesh->SetVisibility(false);
 			DisableMeshCollision();
-			DisableSphereCollision();
 			DisableBoxCollision();
+			EnterDormancy();
 			break;
 	}
 }
 
+void AItem::UpdateLootIndex(EItemState State)
+{
+	ULootIndexSubsystem* LootIndex = GetWorld() ? GetWorld()->GetSubsystem<ULootIndexSubsystem>() : nullptr;
+	if (LootIndex == nullptr) return;
+	//Only items lying in the world waiting to be picked up can be focused
+	if (State == EItemState::EIS_Pickup) LootIndex->AddItem(this);
+	else LootIndex->RemoveItem(this);
+}
+
 void AItem::ItemInterpolation(float DeltaTime)
 {
 	if (!bIsInterpolating) return;
@@ -288,6 +373,7 @@ void AItem::FinishInterpolating()
 	//Scale item to original size
 	SetActorScale3D(FVector(1.f));
 	bCanChangeCustomDepth = true;
+	SetMaterialPulse(EItemMaterialPulse::EIMP_None, 0.f);
 	DisableGlowMaterial();
 	DisableCustomDepth();
 }
@@ -302,21 +388,39 @@ FVector AItem::GetInterpLocation()
 	return FVector(0.f);
 }
 
-void AItem::UpdateMaterialPulse()
+void AItem::SetMaterialPulse(EItemMaterialPulse Pulse, float Duration)
 {
-	if (DynamicMaterialInstance == nullptr) return;
-	float ElapsedTime;
-	FVector CurveValue;
-	if (ItemState == EItemState::EIS_Pickup && MaterialPulseCurve)
+	if (ItemMesh == nullptr) return;
+	const UWorld* World = GetWorld();
+	MaterialPulse = Pulse;
+	MaterialPulseStartTime = World ? World->GetTimeSeconds() : 0.f;
+	MaterialPulseDuration = Duration;
+	if (DynamicMaterialInstance)
 	{
-		ElapsedTime = GetWorldTimerManager().GetTimerElapsed(MaterialPulseTimer);
-		CurveValue = MaterialPulseCurve->GetVectorValue(ElapsedTime);
-	}
-	else if (ItemState == EItemState::EIS_EquipInterpolating && MaterialPulseInterpCurve)
-	{
-		ElapsedTime = GetWorldTimerManager().GetTimerElapsed(ItemInterpolationTimer);
-		CurveValue = MaterialPulseInterpCurve->GetVectorValue(ElapsedTime);
+		UpdateDynamicMaterialPulse();
+		RefreshItemUpdate();
+		return;
 	}
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::PulseType, static_cast<float>(Pulse));
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::PulseStartTime, MaterialPulseStartTime);
+	ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::PulseDuration, Duration);
+}
+
+bool AItem::NeedsDynamicMaterialPulse() const
+{
+	if (DynamicMaterialInstance == nullptr) return false;
+	if (MaterialPulse == EItemMaterialPulse::EIMP_Pickup) return ItemState == EItemState::EIS_Pickup && MaterialPulseCurve;
+	return MaterialPulse == EItemMaterialPulse::EIMP_EquipInterpolating && MaterialPulseInterpCurve;
+}
+
+void AItem::UpdateDynamicMaterialPulse()
+{
+	if (!NeedsDynamicMaterialPulse()) return;
+	const float ElapsedTime = GetWorld()->GetTimeSeconds() - MaterialPulseStartTime;
+	//Pickup pulse loops every MaterialPulseCurveTime seconds, the interp pulse plays once
+	const FVector CurveValue{ MaterialPulse == EItemMaterialPulse::EIMP_Pickup ?
+		MaterialPulseCurve->GetVectorValue(MaterialPulseDuration > 0.f ? FMath::Fmod(ElapsedTime, MaterialPulseDuration) : 0.f) :
+		MaterialPulseInterpCurve->GetVectorValue(ElapsedTime) };
 	DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowAmount"), CurveValue.X * GlowAmount);
 	DynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelExponent"), CurveValue.Y * FresnelExponent);
 	DynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelReflectFraction"), CurveValue.Z * FresnelReflectFraction);
@@ -324,12 +428,14 @@ void AItem::UpdateMaterialPulse()
 
 void AItem::EnableGlowMaterial()
 {
-	if (DynamicMaterialInstance) DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 0);
+	if (DynamicMaterialInstance) DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 0.f);
+	else if (ItemMesh) ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::GlowBlendAlpha, 0.f);
 }
 
 void AItem::DisableGlowMaterial()
 {
-	if (DynamicMaterialInstance) DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 1);
+	if (DynamicMaterialInstance) DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 1.f);
+	else if (ItemMesh) ItemMesh->SetCustomPrimitiveDataFloat(ItemPrimitiveData::GlowBlendAlpha, 1.f);
 }
 
 void AItem::EnableCustomDepth()
@@ -357,15 +463,6 @@ void AItem::HidePickupWidget()
 	if(PickupWidget) PickupWidget->SetVisibility(false);
 }
 
-void AItem::DisableSphereCollision()
-{
-	if (OverlapSphere)
-	{
-		OverlapSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-		OverlapSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	}
-}
-
 void AItem::DisableBoxCollision()
 {
 	if (CollisionBox)
@@ -388,6 +485,7 @@ void AItem::SetItemState(EItemState State)
 {
 	ItemState = State;
 	SetItemProperties(ItemState);
+	RefreshItemUpdate();
 }
 
 void AItem::StartItemCurve(AArcoroxCharacter* Character)
@@ -402,7 +500,7 @@ void AItem::StartItemCurve(AArcoroxCharacter* Character)
 	InterpInitialYawOffset = ItemYaw - CameraYaw;
 	bIsInterpolating = true;
 	SetItemState(EItemState::EIS_EquipInterpolating);
-	GetWorldTimerManager().ClearTimer(MaterialPulseTimer);
+	SetMaterialPulse(EItemMaterialPulse::EIMP_EquipInterpolating, ZCurveTime);
 	PlayPickupSound();
 	bCanChangeCustomDepth = false;
 	GetWorldTimerManager().SetTimer(ItemInterpolationTimer, this, &AItem::FinishInterpolating, ZCurveTime);
@@ -410,36 +508,126 @@ void AItem::StartItemCurve(AArcoroxCharacter* Character)
 
 void AItem::PlayPickupSound()
 {
-	if (ArcoroxCharacter == nullptr || PickupSound == nullptr) return;
-	if (ArcoroxCharacter->ShouldPlayPickupSound())
-	{
-		UGameplayStatics::PlaySound2D(this, PickupSound);
-		ArcoroxCharacter->StartPickupSoundTimer();
-	}
+	if (ArcoroxCharacter == nullptr) return;
+	//Throttled by the pickup category of the combat audio subsystem
+	UCombatAudioSubsystem::PlayCombatSound2D(this, ECombatSoundCategory::ECSC_Pickup, PickupSound);
 }
 
 void AItem::PlayEquipSound()
 {
-	if (ArcoroxCharacter == nullptr || EquipSound == nullptr) return;
-	if (ArcoroxCharacter->ShouldPlayEquipSound())
-	{
-		UGameplayStatics::PlaySound2D(this, EquipSound);
-		ArcoroxCharacter->StartEquipSoundTimer();
-	}
+	if (ArcoroxCharacter == nullptr) return;
+	UCombatAudioSubsystem::PlayCombatSound2D(this, ECombatSoundCategory::ECSC_Equip, EquipSound);
 }
 
 void AItem::ForcePlayEquipSound()
 {
-	if (ArcoroxCharacter == nullptr || EquipSound == nullptr) return;
-	UGameplayStatics::PlaySound2D(this, EquipSound);
+	if (ArcoroxCharacter == nullptr) return;
+	UCombatAudioSubsystem::PlayCombatSound2D(this, ECombatSoundCategory::ECSC_Equip, EquipSound, true);
+}
+
+void AItem::ApplyBlastImpulse(const FVector& Impulse)
+{
+	if (ItemState == EItemState::EIS_Pickup) SetItemState(EItemState::EIS_Falling);
+	else if (ItemState != EItemState::EIS_Falling) return;
+	//The root simulates while falling, the item mesh for most items and the ammo mesh for ammo
+	UPrimitiveComponent* Body = Cast<UPrimitiveComponent>(GetRootComponent());
+	if (Body && Body->IsSimulatingPhysics()) Body->AddImpulse(Impulse, NAME_None, true);
+	GetWorldTimerManager().SetTimer(BlastSettleTimer, this, &AItem::FinishBlastFall, BlastSettleTime);
+}
+
+void AItem::FinishBlastFall()
+{
+	if (ItemState != EItemState::EIS_Falling) return;
+	SetItemState(EItemState::EIS_Pickup);
+	StartMaterialPulse();
 }
 
-void AItem::StartMaterialPulseTimer()
+void AItem::StartMaterialPulse()
 {
-	if (ItemState == EItemState::EIS_Pickup) GetWorldTimerManager().SetTimer(MaterialPulseTimer, this, &AItem::ResetMaterialPulseTimer, MaterialPulseCurveTime);
+	//The material loops the pulse every MaterialPulseCurveTime seconds on its own
+	if (ItemState == EItemState::EIS_Pickup) SetMaterialPulse(EItemMaterialPulse::EIMP_Pickup, MaterialPulseCurveTime);
 }
 
-void AItem::ResetMaterialPulseTimer()
+static void ReportItemMaterialMemory(const TArray<FString>& Args, UWorld* World)
 {
-	StartMaterialPulseTimer();
-}
\ No newline at end of file
+	int32 NumItems = 0;
+	int32 NumItemMaterialInstances = 0;
+	int64 ItemMaterialInstanceBytes = 0;
+	for (TObjectIterator<AItem> It; It; ++It)
+	{
+		if (It->GetWorld() != World) continue;
+		NumItems++;
+		//Count dynamic instances still outered to items, only items whose material reads named parameters have one
+		TArray<UObject*> Inner;
+		GetObjectsWithOuter(*It, Inner, false);
+		for (UObject* Object : Inner)
+		{
+			if (!Object->IsA<UMaterialInstanceDynamic>()) continue;
+			NumItemMaterialInstances++;
+			ItemMaterialInstanceBytes += Object->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+		}
+	}
+	int32 NumMaterialInstances = 0;
+	for (TObjectIterator<UMaterialInstanceDynamic> It; It; ++It) NumMaterialInstances++;
+	UE_LOG(LogArcorox, Display, TEXT("Items: %d, item dynamic material instances: %d (%lld bytes), dynamic material instances total: %d"),
+		NumItems, NumItemMaterialInstances, ItemMaterialInstanceBytes, NumMaterialInstances);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs ReportItemMaterialMemoryCommand(
+	TEXT("arcorox.Items.MaterialReport"),
+	TEXT("Logs item count and the number and size of dynamic material instances owned by items."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&ReportItemMaterialMemory));
+
+#if !UE_BUILD_SHIPPING
+static void FillPlayerInventories(UWorld* World)
+{
+	for (TActorIterator<AArcoroxCharacter> It(World); It; ++It) It->FillInventory();
+}
+
+static FAutoConsoleCommandWithWorld FillInventoryCommand(
+	TEXT("arcorox.Items.FillInventory"),
+	TEXT("Fills the empty inventory slots of every player with default weapons."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&FillPlayerInventories));
+#endif
+
+static void LogInventoryDormancy(UWorld* World)
+{
+	for (TActorIterator<AArcoroxCharacter> It(World); It; ++It)
+	{
+		int32 NumDormant = 0;
+		int32 NumTicking = 0;
+		int32 NumPhysicsStates = 0;
+		int64 TotalBytes = 0;
+		for (AItem* Item : It->GetInventory())
+		{
+			if (Item == nullptr) continue;
+			int32 ItemTicking = 0;
+			int32 ItemPhysicsStates = 0;
+			int64 ItemBytes = 0;
+			Item->ForEachComponent(false, [&](UActorComponent* Component)
+			{
+				if (Component->IsComponentTickEnabled()) ItemTicking++;
+				if (Component->IsPhysicsStateCreated()) ItemPhysicsStates++;
+				ItemBytes += Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+			});
+			UAnimInstance* AnimInstance = Item->GetItemMesh() ? Item->GetItemMesh()->GetAnimInstance() : nullptr;
+			if (AnimInstance) ItemBytes += AnimInstance->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+			const bool bEquipped = Item == It->GetEquippedWeapon();
+			UE_LOG(LogArcorox, Display, TEXT("  Slot %d %s%s: %s, %d ticking components, %d physics states, anim %s, %lld bytes"),
+				Item->GetInventorySlotIndex(), *Item->GetName(), bEquipped ? TEXT(" (equipped)") : TEXT(""), Item->IsDormant() ? TEXT("dormant") : TEXT("awake"),
+				ItemTicking, ItemPhysicsStates, AnimInstance == nullptr ? TEXT("none") : Item->GetItemMesh()->bNoSkeletonUpdate ? TEXT("suspended") : TEXT("running"), ItemBytes);
+			if (Item->IsDormant()) NumDormant++;
+			NumTicking += ItemTicking;
+			NumPhysicsStates += ItemPhysicsStates;
+			TotalBytes += ItemBytes;
+		}
+		//Per-frame cost of the awake items shows under stat Game and stat Anim, compare with arcorox.Items.Dormancy 0
+		UE_LOG(LogArcorox, Display, TEXT("%s inventory: %d/%d items dormant, %d ticking components, %d physics states, %lld bytes"),
+			*It->GetName(), NumDormant, It->GetInventory().Num(), NumTicking, NumPhysicsStates, TotalBytes);
+	}
+}
+
+static FAutoConsoleCommandWithWorld LogInventoryDormancyCommand(
+	TEXT("arcorox.Items.DormancyReport"),
+	TEXT("Logs dormancy, ticking components, physics states and component memory of every inventory item."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&LogInventoryDormancy));
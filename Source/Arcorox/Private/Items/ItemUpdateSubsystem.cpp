@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/ItemUpdateSubsystem.h"
+#include "Items/Item.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Item Update"), STAT_ItemUpdate, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Items Updated"), STAT_ItemsUpdated, STATGROUP_Arcorox);
+
+void UItemUpdateSubsystem::Deinitialize()
+{
+	for (AItem* Item : ActiveItems)
+	{
+		if (Item) Item->SetItemUpdateIndex(INDEX_NONE);
+	}
+	ActiveItems.Empty();
+
+	Super::Deinitialize();
+}
+
+void UItemUpdateSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_ItemUpdate);
+	INC_DWORD_STAT_BY(STAT_ItemsUpdated, ActiveItems.Num());
+	//Iterate backwards so items removed by swapping have already been updated this frame
+	for (int32 i = ActiveItems.Num() - 1; i >= 0; i--)
+	{
+		if (!ActiveItems.IsValidIndex(i)) continue;
+		AItem* Item = ActiveItems[i];
+		if (Item && Item->NeedsItemUpdate()) Item->UpdateItem(DeltaTime);
+		//Items with nothing left to animate drop out until they are registered again
+		if (Item == nullptr) RemoveActiveItemAt(i);
+		else if (!Item->NeedsItemUpdate()) UnregisterItem(Item);
+	}
+}
+
+TStatId UItemUpdateSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemUpdateSubsystem, STATGROUP_Tickables);
+}
+
+bool UItemUpdateSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UItemUpdateSubsystem::RegisterItem(AItem* Item)
+{
+	if (Item == nullptr || Item->GetItemUpdateIndex() != INDEX_NONE) return;
+	Item->SetItemUpdateIndex(ActiveItems.Add(Item));
+}
+
+void UItemUpdateSubsystem::UnregisterItem(AItem* Item)
+{
+	if (Item == nullptr) return;
+	const int32 Index = Item->GetItemUpdateIndex();
+	if (ActiveItems.IsValidIndex(Index) && ActiveItems[Index] == Item) RemoveActiveItemAt(Index);
+}
+
+void UItemUpdateSubsystem::RemoveActiveItemAt(int32 Index)
+{
+	if (ActiveItems[Index]) ActiveItems[Index]->SetItemUpdateIndex(INDEX_NONE);
+	ActiveItems.RemoveAtSwap(Index, 1, false);
+	//Fix up the index of the item swapped into the removed slot
+	if (ActiveItems.IsValidIndex(Index) && ActiveItems[Index]) ActiveItems[Index]->SetItemUpdateIndex(Index);
+}
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/LootIndexSubsystem.h"
+#include "Items/Item.h"
+#include "Components/BoxComponent.h"
+#include "Engine/World.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_CYCLE_STAT(TEXT("Loot Index Update"), STAT_LootIndexUpdate, STATGROUP_Arcorox);
+DECLARE_CYCLE_STAT(TEXT("Loot Index Query"), STAT_LootIndexQuery, STATGROUP_Arcorox);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Loot Focus Traces"), STAT_LootFocusTraces, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Loot Index Items"), STAT_LootIndexItems, STATGROUP_Arcorox);
+
+void ULootIndexSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_LootIndexItems, ItemCells.Num());
+	Cells.Empty();
+	ItemCells.Empty();
+
+	Super::Deinitialize();
+}
+
+FIntPoint ULootIndexSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+template<typename FuncType>
+void ULootIndexSubsystem::ForEachEntryInRadius(const FVector& Center, float Radius, FuncType Func) const
+{
+	if (Cells.Num() == 0) return;
+	const float RadiusSquared = Radius * Radius;
+	const FIntPoint MinCell{ GetCell(Center - FVector(Radius)) };
+	const FIntPoint MaxCell{ GetCell(Center + FVector(Radius)) };
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			const TArray<FLootEntry>* Entries = Cells.Find(FIntPoint(X, Y));
+			if (Entries == nullptr) continue;
+			for (const FLootEntry& Entry : *Entries)
+			{
+				//Returning false from Func stops the query
+				if (FVector::DistSquared(Entry.Location, Center) <= RadiusSquared && !Func(Entry)) return;
+			}
+		}
+	}
+}
+
+void ULootIndexSubsystem::AddItem(AItem* Item)
+{
+	if (Item == nullptr) return;
+	SCOPE_CYCLE_COUNTER(STAT_LootIndexUpdate);
+	RemoveItem(Item);
+	const FVector Location{ Item->GetActorLocation() };
+	const FIntPoint Cell{ GetCell(Location) };
+	Cells.FindOrAdd(Cell).Add(FLootEntry{ Item, Location });
+	ItemCells.Add(Item, Cell);
+	INC_DWORD_STAT(STAT_LootIndexItems);
+}
+
+void ULootIndexSubsystem::RemoveItem(AItem* Item)
+{
+	FIntPoint Cell;
+	if (!ItemCells.RemoveAndCopyValue(Item, Cell)) return;
+	SCOPE_CYCLE_COUNTER(STAT_LootIndexUpdate);
+	DEC_DWORD_STAT(STAT_LootIndexItems);
+	TArray<FLootEntry>* Entries = Cells.Find(Cell);
+	if (Entries == nullptr) return;
+	const int32 Index = Entries->IndexOfByPredicate([Item](const FLootEntry& Entry) { return Entry.Item == Item; });
+	if (Index != INDEX_NONE) Entries->RemoveAtSwap(Index, 1, false);
+	if (Entries->Num() == 0) Cells.Remove(Cell);
+}
+
+AItem* ULootIndexSubsystem::FindFocusItem(const FVector& Center, float Radius, const FVector& ViewOrigin, const FVector& ViewDirection, float ConeHalfAngle, const AActor* Viewer) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_LootIndexQuery);
+	//Only items whose direction from the view origin is inside the cone are considered
+	const float MinCosine = FMath::Cos(FMath::DegreesToRadians(ConeHalfAngle));
+	TArray<TPair<float, AItem*>, TInlineAllocator<16>> Candidates;
+	ForEachEntryInRadius(Center, Radius, [&](const FLootEntry& Entry)
+	{
+		const float Cosine = FVector::DotProduct((Entry.Location - ViewOrigin).GetSafeNormal(), ViewDirection);
+		if (Cosine >= MinCosine) Candidates.Emplace(Cosine, Entry.Item);
+		return true;
+	});
+	if (Candidates.Num() == 0) return nullptr;
+	Candidates.Sort([](const TPair<float, AItem*>& A, const TPair<float, AItem*>& B) { return A.Key > B.Key; });
+
+	//Items behind walls can't be focused, the trace ends on the item's own collision box when nothing is in the way
+	const FCollisionQueryParams QueryParams{ SCENE_QUERY_STAT(LootFocusVisibility), false, Viewer };
+	const int32 NumTraces = FMath::Min(Candidates.Num(), MaxFocusVisibilityTraces);
+	for (int32 i = 0; i < NumTraces; i++)
+	{
+		AItem* Item = Candidates[i].Value;
+		const FVector Target{ Item->GetCollisionBox() ? Item->GetCollisionBox()->Bounds.Origin : Item->GetActorLocation() };
+		FHitResult Hit;
+		INC_DWORD_STAT(STAT_LootFocusTraces);
+		if (!GetWorld()->LineTraceSingleByChannel(Hit, ViewOrigin, Target, ECollisionChannel::ECC_Visibility, QueryParams) || Hit.GetActor() == Item) return Item;
+	}
+	return nullptr;
+}
@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/PickupPoolSubsystem.h"
+#include "Items/Item.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Arcorox/Arcorox.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pickups Live"), STAT_PickupsLive, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pickups Pooled"), STAT_PickupsPooled, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pickups Spawned"), STAT_PickupsSpawned, STATGROUP_Arcorox);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pickups Destroyed"), STAT_PickupsDestroyed, STATGROUP_Arcorox);
+
+static void LogPickupPoolCommand(UWorld* World)
+{
+	if (UPickupPoolSubsystem* Pool = World ? World->GetSubsystem<UPickupPoolSubsystem>() : nullptr) Pool->LogPoolReport();
+}
+
+static FAutoConsoleCommandWithWorld LogPickupPoolConsoleCommand(
+	TEXT("arcorox.Items.PoolReport"),
+	TEXT("Logs live dropped pickups and pooled pickups per class."),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&LogPickupPoolCommand));
+
+UPickupPoolSubsystem::UPickupPoolSubsystem() :
+	MaxLivePickups(32),
+	MaxPooledPerClass(16)
+{
+
+}
+
+void UPickupPoolSubsystem::Deinitialize()
+{
+	for (const TPair<TSubclassOf<AItem>, FPickupPoolBucket>& Pool : Pools)
+	{
+		DEC_DWORD_STAT_BY(STAT_PickupsPooled, Pool.Value.Items.Num());
+	}
+	DEC_DWORD_STAT_BY(STAT_PickupsLive, LivePickups.Num());
+	Pools.Empty();
+	LivePickups.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UPickupPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+AItem* UPickupPoolSubsystem::AcquirePickup(TSubclassOf<AItem> ItemClass, const FTransform& Transform)
+{
+	if (ItemClass == nullptr) return nullptr;
+	AItem* Item = nullptr;
+	FPickupPoolBucket& Pool = Pools.FindOrAdd(ItemClass);
+	while (Pool.Items.Num() > 0 && Item == nullptr)
+	{
+		AItem* Pooled = Pool.Items.Pop(false);
+		DEC_DWORD_STAT(STAT_PickupsPooled);
+		if (IsValid(Pooled)) Item = Pooled;
+	}
+	if (Item) Item->ActivateFromPool(Transform);
+	else
+	{
+		Item = GetWorld()->SpawnActor<AItem>(ItemClass, Transform);
+		if (Item == nullptr) return nullptr;
+		INC_DWORD_STAT(STAT_PickupsSpawned);
+	}
+	TrackLivePickup(Item);
+	return Item;
+}
+
+void UPickupPoolSubsystem::ReleasePickup(AItem* Item)
+{
+	if (!IsValid(Item) || Item->IsInPool()) return;
+	//First release of a class opens its bucket, so level placed and dropped pickups are recycled like spawned ones
+	FPickupPoolBucket& Pool = Pools.FindOrAdd(Item->GetClass());
+	if (Pool.Items.Num() >= MaxPooledPerClass)
+	{
+		Item->Destroy();
+		INC_DWORD_STAT(STAT_PickupsDestroyed);
+		return;
+	}
+	Item->DeactivateForPool();
+	Pool.Items.Add(Item);
+	INC_DWORD_STAT(STAT_PickupsPooled);
+}
+
+void UPickupPoolSubsystem::TrackLivePickup(AItem* Item)
+{
+	if (!IsValid(Item)) return;
+	if (!LivePickups.Contains(Item))
+	{
+		LivePickups.Add(Item);
+		INC_DWORD_STAT(STAT_PickupsLive);
+	}
+	EnforceLiveCap();
+}
+
+void UPickupPoolSubsystem::EnforceLiveCap()
+{
+	//Only pickups still lying in the world count, anything picked up since has left the cap
+	for (int32 i = LivePickups.Num() - 1; i >= 0; i--)
+	{
+		const AItem* Item = LivePickups[i].Get();
+		const bool bInWorld = Item && !Item->IsInPool() && (Item->GetItemState() == EItemState::EIS_Pickup || Item->GetItemState() == EItemState::EIS_Falling);
+		if (bInWorld) continue;
+		LivePickups.RemoveAt(i, 1, false);
+		DEC_DWORD_STAT(STAT_PickupsLive);
+	}
+	while (LivePickups.Num() > MaxLivePickups)
+	{
+		AItem* Oldest = LivePickups[0].Get();
+		LivePickups.RemoveAt(0, 1, false);
+		DEC_DWORD_STAT(STAT_PickupsLive);
+		ReleasePickup(Oldest);
+	}
+}
+
+void UPickupPoolSubsystem::LogPoolReport() const
+{
+	UE_LOG(LogArcorox, Display, TEXT("Live pickups: %d (cap %d)"), LivePickups.Num(), MaxLivePickups);
+	for (const TPair<TSubclassOf<AItem>, FPickupPoolBucket>& Pool : Pools)
+	{
+		UE_LOG(LogArcorox, Display, TEXT("  %s: %d pooled"), *GetNameSafe(Pool.Key), Pool.Value.Items.Num());
+	}
+}
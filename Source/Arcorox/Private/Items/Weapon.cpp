@@ -2,33 +2,36 @@
 
 
 #include "Items/Weapon.h"
-#include "Items/Weapon.h"
+#include "Combat/CombatDataRegistry.h"
+
+/* Used while a weapon type has no row in the table */
+static const FWeaponTypeTable DefaultWeaponArchetype;
 
 AWeapon::AWeapon():
 	ThrowWeaponTime(0.7f),
 	bIsFalling(false),
 	Ammo(30),
-	MagazineCapacity(30),
 	WeaponType(EWeaponType::EWT_SubmachineGun),
-	AmmoType(EAmmoType::EAT_9mm),
-	ReloadMontageSection(FName(TEXT("Reload SMG"))),
-	ClipBoneName(FName(TEXT("smg_clip"))),
+	WeaponArchetype(nullptr),
 	PistolSlideDisplacement(0.f),
 	PistolSlideTime(0.2f),
 	bDisplacingPistolSlide(false),
 	PistolSlideDistance(4.f),
 	TargetPistolRecoilRotation(20.f),
-	PistolRecoilRotation(0.f),
-	bAutomaticWeapon(true)
+	PistolRecoilRotation(0.f)
 {
-	PrimaryActorTick.bCanEverTick = true;
-
+	PrimaryActorTick.bCanEverTick = false;
+}
 
+bool AWeapon::NeedsItemUpdate() const
+{
+	if (Super::NeedsItemUpdate() || bDisplacingPistolSlide) return true;
+	return GetItemState() == EItemState::EIS_Falling && bIsFalling;
 }
 
-void AWeapon::Tick(float DeltaTime)
+void AWeapon::UpdateItem(float DeltaTime)
 {
-	Super::Tick(DeltaTime);
+	Super::UpdateItem(DeltaTime);
 
 	if (GetItemState() == EItemState::EIS_Falling && bIsFalling)
 	{
@@ -39,12 +42,32 @@ void AWeapon::Tick(float DeltaTime)
 	UpdatePistolSlideDisplacement();
 }
 
+void AWeapon::DeactivateForPool()
+{
+	Super::DeactivateForPool();
+
+	bIsFalling = false;
+	bDisplacingPistolSlide = false;
+	bMovingClip = false;
+	PistolSlideDisplacement = 0.f;
+	PistolRecoilRotation = 0.f;
+}
+
+void AWeapon::ActivateFromPool(const FTransform& Transform)
+{
+	//Only the per-instance part of the weapon type row, the mesh, anim class and material are still applied
+	Ammo = GetWeaponArchetype().AmmoCount;
+
+	Super::ActivateFromPool(Transform);
+}
+
 void AWeapon::BeginPlay()
 {
 	Super::BeginPlay();
 
 	SetItemType(EItemType::EIT_Weapon);
 
+	const FName BoneToHide{ GetWeaponArchetype().BoneToHide };
 	if (BoneToHide != FName()) GetItemMesh()->HideBoneByName(BoneToHide, EPhysBodyOp::PBO_None);
 }
 
@@ -52,53 +75,26 @@ void AWeapon::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
 	GetWeaponTypeDataTableInfo();
-	InitializeDynamicMaterialInstance();
+	InitializeItemMaterial();
+}
+
+const FWeaponTypeTable& AWeapon::GetWeaponArchetype() const
+{
+	return WeaponArchetype ? *WeaponArchetype : DefaultWeaponArchetype;
 }
 
 void AWeapon::GetWeaponTypeDataTableInfo()
 {
-	const FString WeaponTypeDataTablePath(TEXT("/Script/Engine.DataTable'/Game/Dynamic/Blueprints/DataTables/WeaponTypeDataTable.WeaponTypeDataTable'"));
-	UDataTable* WeaponTypeDataTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *WeaponTypeDataTablePath));
-	if (WeaponTypeDataTableObject)
-	{
-		FWeaponTypeTable* WeaponTypeRow = nullptr;
-		switch (WeaponType)
-		{
-		case EWeaponType::EWT_SubmachineGun:
-			WeaponTypeRow = WeaponTypeDataTableObject->FindRow<FWeaponTypeTable>(FName("SubmachineGun"), TEXT(""));
-			break;
-		case EWeaponType::EWT_AssaultRifle:
-			WeaponTypeRow = WeaponTypeDataTableObject->FindRow<FWeaponTypeTable>(FName("AssaultRifle"), TEXT(""));
-			break;
-		case EWeaponType::EWT_Pistol:
-			WeaponTypeRow = WeaponTypeDataTableObject->FindRow<FWeaponTypeTable>(FName("Pistol"), TEXT(""));
-			break;
-		}
-		SetDataTableProperties(WeaponTypeRow);
-	}
+	UCombatDataRegistry* Registry = UCombatDataRegistry::Get();
+	WeaponArchetype = Registry ? Registry->GetWeaponArchetype(WeaponType) : nullptr;
+	SetDataTableProperties(WeaponArchetype);
 }
 
-void AWeapon::SetDataTableProperties(FWeaponTypeTable* WeaponTypeRow)
+void AWeapon::SetDataTableProperties(const FWeaponTypeTable* WeaponTypeRow)
 {
 	if (WeaponTypeRow)
 	{
-		AmmoType = WeaponTypeRow->AmmoType;
 		Ammo = WeaponTypeRow->AmmoCount;
-		MagazineCapacity = WeaponTypeRow->MagazineCapacity;
-		ClipBoneName = WeaponTypeRow->ClipBoneName;
-		ReloadMontageSection = WeaponTypeRow->ReloadMontageSection;
-		TopCrosshair = WeaponTypeRow->TopCrosshair;
-		BottomCrosshair = WeaponTypeRow->BottomCrosshair;
-		MidCrosshair = WeaponTypeRow->MidCrosshair;
-		LeftCrosshair = WeaponTypeRow->LeftCrosshair;
-		RightCrosshair = WeaponTypeRow->RightCrosshair;
-		FireRate = WeaponTypeRow->FireRate;
-		MuzzleFlash = WeaponTypeRow->MuzzleFlash;
-		FireSound = WeaponTypeRow->FireSound;
-		BoneToHide = WeaponTypeRow->BoneToHide;
-		bAutomaticWeapon = WeaponTypeRow->bAutomaticWeapon;
-		Damage = WeaponTypeRow->Damage;
-		HeadshotMultiplier = WeaponTypeRow->HeadshotMultiplier;
 		SetPickupSound(WeaponTypeRow->PickupSound);
 		SetEquipSound(WeaponTypeRow->EquipSound);
 		GetItemMesh()->SetSkeletalMesh(WeaponTypeRow->WeaponMesh);
@@ -130,6 +126,17 @@ void AWeapon::ThrowWeapon()
 	bIsFalling = true;
 	EnableGlowMaterial();
 	GetWorldTimerManager().SetTimer(ThrowWeaponTimer, this, &AWeapon::StopFalling, ThrowWeaponTime);
+	RefreshItemUpdate();
+}
+
+void AWeapon::ApplyBlastImpulse(const FVector& Impulse)
+{
+	if (GetItemState() == EItemState::EIS_Pickup) SetItemState(EItemState::EIS_Falling);
+	else if (GetItemState() != EItemState::EIS_Falling) return;
+	GetItemMesh()->AddImpulse(Impulse, NAME_None, true);
+	bIsFalling = true;
+	GetWorldTimerManager().SetTimer(ThrowWeaponTimer, this, &AWeapon::StopFalling, ThrowWeaponTime);
+	RefreshItemUpdate();
 }
 
 void AWeapon::DecrementAmmo()
@@ -140,26 +147,27 @@ void AWeapon::DecrementAmmo()
 
 void AWeapon::ReloadAmmo(int32 Amount)
 {
-	checkf(Ammo + Amount <= MagazineCapacity, TEXT("Reload with more than magazine capacity"));
+	checkf(Ammo + Amount <= GetMagazineCapacity(), TEXT("Reload with more than magazine capacity"));
 	Ammo += Amount;
 }
 
 bool AWeapon::FullMagazine()
 {
-	return Ammo == MagazineCapacity;
+	return Ammo == GetMagazineCapacity();
 }
 
 void AWeapon::StartPistolSlideTimer()
 {
 	bDisplacingPistolSlide = true;
 	GetWorldTimerManager().SetTimer(PistolSlideTimer, this, &AWeapon::FinishPistolSlideDisplacement, PistolSlideTime);
+	RefreshItemUpdate();
 }
 
 void AWeapon::StopFalling()
 {
 	bIsFalling = false;
 	SetItemState(EItemState::EIS_Pickup);
-	StartMaterialPulseTimer();
+	StartMaterialPulse();
 }
 
 void AWeapon::FinishPistolSlideDisplacement()
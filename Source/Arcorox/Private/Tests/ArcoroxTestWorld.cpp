@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/ArcoroxTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "GameFramework/WorldSettings.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/DefaultPawn.h"
+#include "Components/BoxComponent.h"
+#include "UObject/UObjectGlobals.h"
+#include "HAL/IConsoleManager.h"
+
+FArcoroxTestWorld::FArcoroxTestWorld()
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("ArcoroxTestWorld"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+	//There is no game mode to start play, actors spawned from here on run BeginPlay as they finish spawning
+	World->GetWorldSettings()->NotifyBeginPlay();
+}
+
+FArcoroxTestWorld::~FArcoroxTestWorld()
+{
+	World->BeginTearingDown();
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+double FArcoroxTestWorld::Tick(int32 NumFrames, float DeltaTime)
+{
+	if (NumFrames <= 0) return 0.0;
+	const double StartSeconds = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumFrames; i++)
+	{
+		World->Tick(ELevelTick::LEVELTICK_All, DeltaTime);
+		//Per-frame caches are keyed on the frame counter the engine loop would advance
+		GFrameCounter++;
+	}
+	return (FPlatformTime::Seconds() - StartSeconds) * 1000.0 / NumFrames;
+}
+
+AActor* FArcoroxTestWorld::SpawnBlockingBox(const FVector& Location, const FVector& Extent)
+{
+	AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Location));
+	UBoxComponent* Box = NewObject<UBoxComponent>(Actor);
+	Box->SetBoxExtent(Extent);
+	Box->SetCollisionProfileName(TEXT("BlockAll"));
+	Actor->SetRootComponent(Box);
+	Box->RegisterComponent();
+	Box->SetWorldLocation(Location);
+	return Actor;
+}
+
+APawn* FArcoroxTestWorld::SpawnPlayer(const FVector& Location, TSubclassOf<APawn> PawnClass)
+{
+	APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+	APawn* Pawn = World->SpawnActor<APawn>(PawnClass ? PawnClass.Get() : ADefaultPawn::StaticClass(), FTransform(Location));
+	if (PlayerController && Pawn) PlayerController->Possess(Pawn);
+	return Pawn;
+}
+
+APawn* FArcoroxTestWorld::SpawnAIPawn(TSubclassOf<APawn> PawnClass, const FVector& Location, TSubclassOf<AController> ControllerClass, TFunction<void(APawn*)> BeforeFinishSpawning)
+{
+	APawn* Pawn = World->SpawnActorDeferred<APawn>(PawnClass, FTransform(Location), nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Pawn == nullptr) return nullptr;
+	Pawn->AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+	if (ControllerClass) Pawn->AIControllerClass = ControllerClass;
+	//Runs before the controller possesses the pawn and before BeginPlay
+	if (BeforeFinishSpawning) BeforeFinishSpawning(Pawn);
+	Pawn->FinishSpawning(FTransform(Location));
+	return Pawn;
+}
+
+FArcoroxScopedConsoleVariable::FArcoroxScopedConsoleVariable(const TCHAR* Name, const FString& Value) :
+	Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+{
+	if (Variable == nullptr) return;
+	PreviousValue = Variable->GetString();
+	Set(Value);
+}
+
+FArcoroxScopedConsoleVariable::~FArcoroxScopedConsoleVariable()
+{
+	Set(PreviousValue);
+}
+
+void FArcoroxScopedConsoleVariable::Set(const FString& Value)
+{
+	if (Variable) Variable->Set(*Value, ECVF_SetByCode);
+}
+
+#endif
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SubclassOf.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class UWorld;
+class AActor;
+class APawn;
+class AController;
+class IConsoleVariable;
+
+/* Empty game world for automation tests, game world subsystems exist and play has begun so spawned actors run BeginPlay */
+class FArcoroxTestWorld
+{
+public:
+	FArcoroxTestWorld();
+	~FArcoroxTestWorld();
+
+	FORCEINLINE UWorld* GetWorld() const { return World; }
+
+	/* Ticks the world NumFrames times, returns the average milliseconds per frame */
+	double Tick(int32 NumFrames = 1, float DeltaTime = 1.f / 60.f);
+
+	/* Spawns an actor with a box blocking every channel, Extent is the half size */
+	AActor* SpawnBlockingBox(const FVector& Location, const FVector& Extent);
+
+	/* Spawns a player controller possessing a pawn of PawnClass, or a default pawn when PawnClass is null */
+	APawn* SpawnPlayer(const FVector& Location, TSubclassOf<APawn> PawnClass = nullptr);
+
+	/* Spawns a pawn of PawnClass possessed by an AI controller, as enemies placed or spawned in a level are, ControllerClass overrides the pawn's AI controller class */
+	APawn* SpawnAIPawn(TSubclassOf<APawn> PawnClass, const FVector& Location, TSubclassOf<AController> ControllerClass = nullptr, TFunction<void(APawn*)> BeforeFinishSpawning = nullptr);
+
+private:
+	UWorld* World;
+};
+
+/* Sets a console variable for the lifetime of the scope and restores the previous value after */
+class FArcoroxScopedConsoleVariable
+{
+public:
+	FArcoroxScopedConsoleVariable(const TCHAR* Name, const FString& Value);
+	~FArcoroxScopedConsoleVariable();
+
+	void Set(const FString& Value);
+
+private:
+	IConsoleVariable* Variable;
+	FString PreviousValue;
+};
+
+#endif
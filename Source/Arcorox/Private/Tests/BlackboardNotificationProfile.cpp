@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyController.h"
+#include "Enemy/Enemy.h"
+#include "Interfaces/HitInterface.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Tests/EnemyTestBehaviorTree.h"
+#include "Misc/AutomationTest.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/DamageType.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static const int32 BlackboardProfileEnemies = 20;
+static const int32 BlackboardProfileFrames = 120;
+static const float BlackboardProfileDeltaTime = 1.f / 60.f;
+
+/* Blackboard traffic of all enemies while firing */
+struct FBlackboardFireProfile
+{
+	int32 NumNotifications = 0;
+	int64 NumWrites = 0;
+	int64 NumWritesSkipped = 0;
+	double FireMs = 0.0;
+};
+
+/* Every enemy is shot once per frame, counts the SetValue calls made and skipped and the observer notifications of all enemy blackboards */
+static FBlackboardFireProfile ProfileSustainedFire(FAutomationTestBase& Test, UBehaviorTree* Tree)
+{
+	FBlackboardFireProfile Profile;
+	//Outlives the world, enemies tearing down may still notify
+	int32 NumNotifications = 0;
+	FArcoroxTestWorld TestWorld;
+	TestWorld.SpawnBlockingBox(FVector(0.f, 0.f, -50.f), FVector(5000.f, 5000.f, 50.f));
+	APawn* Player = TestWorld.SpawnPlayer(FVector(0.f, 0.f, 90.f));
+
+	TArray<AEnemy*> Enemies;
+	TArray<AEnemyController*> Controllers;
+	for (int32 i = 0; i < BlackboardProfileEnemies; i++)
+	{
+		//Far outside aggro range so only the shots write to the blackboard, the tree itself never writes
+		const FVector Location{ FRotator(0.f, i * 360.f / BlackboardProfileEnemies, 0.f).Vector() * 4000.f + FVector(0.f, 0.f, 100.f) };
+		AEnemy* Enemy = Cast<AEnemy>(TestWorld.SpawnAIPawn(AEnemy::StaticClass(), Location, AEnemyController::StaticClass(),
+			[Tree](APawn* Pawn) { CastChecked<AEnemy>(Pawn)->SetBehaviorTree(Tree); }));
+		AEnemyController* Controller = Enemy ? Cast<AEnemyController>(Enemy->GetController()) : nullptr;
+		UBlackboardComponent* Blackboard = Controller ? Controller->GetBlackboardComponent() : nullptr;
+		if (!Test.TestNotNull(TEXT("Enemy blackboard"), Blackboard)) return Profile;
+		for (const FBlackboardEntry& Entry : Tree->BlackboardAsset->Keys)
+		{
+			Blackboard->RegisterObserver(Blackboard->GetKeyID(Entry.EntryName), Controller,
+				FOnBlackboardChangeNotification::CreateLambda([&NumNotifications](const UBlackboardComponent&, FBlackboard::FKey)
+			{
+				NumNotifications++;
+				return EBlackboardNotificationResult::ContinueObserving;
+			}));
+		}
+		Enemies.Add(Enemy);
+		Controllers.Add(Controller);
+	}
+	TestWorld.Tick(10, BlackboardProfileDeltaTime);
+	NumNotifications = 0;
+	for (AEnemyController* Controller : Controllers)
+	{
+		Profile.NumWrites -= Controller->GetNumBlackboardWrites();
+		Profile.NumWritesSkipped -= Controller->GetNumBlackboardWritesSkipped();
+	}
+	//Same stun rolls in every run
+	FMath::RandInit(BlackboardProfileEnemies);
+
+	APlayerController* PlayerController = Cast<APlayerController>(Player->GetController());
+	for (int32 Frame = 0; Frame < BlackboardProfileFrames; Frame++)
+	{
+		const double StartSeconds = FPlatformTime::Seconds();
+		for (AEnemy* Enemy : Enemies)
+		{
+			FHitResult HitResult;
+			HitResult.Location = Enemy->GetActorLocation();
+			const FVector ShotDirection{ (Enemy->GetActorLocation() - Player->GetActorLocation()).GetSafeNormal() };
+			//Small enough that nobody dies during the run
+			UGameplayStatics::ApplyPointDamage(Enemy, 0.01f, ShotDirection, HitResult, PlayerController, Player, UDamageType::StaticClass());
+			IHitInterface::Execute_Hit(Enemy, HitResult);
+		}
+		Profile.FireMs += (FPlatformTime::Seconds() - StartSeconds) * 1000.0 + TestWorld.Tick(1, BlackboardProfileDeltaTime);
+	}
+	for (AEnemyController* Controller : Controllers)
+	{
+		Profile.NumWrites += Controller->GetNumBlackboardWrites();
+		Profile.NumWritesSkipped += Controller->GetNumBlackboardWritesSkipped();
+	}
+	Profile.NumNotifications = NumNotifications;
+	return Profile;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlackboardNotificationProfile, "Arcorox.Perf.AI.BlackboardNotificationsSustainedFire",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FBlackboardNotificationProfile::RunTest(const FString& Parameters)
+{
+	UBehaviorTree* Tree = CreateTestEnemyBehaviorTree();
+	Tree->AddToRoot();
+	const float FireSeconds = BlackboardProfileFrames * BlackboardProfileDeltaTime;
+	const int32 NumShots = BlackboardProfileEnemies * BlackboardProfileFrames;
+	const int32 ShotsPerSecond = FMath::RoundToInt(BlackboardProfileEnemies / BlackboardProfileDeltaTime);
+
+	FArcoroxScopedConsoleVariable SkipUnchanged(TEXT("arcorox.AI.SkipUnchangedBlackboardWrites"), TEXT("0"));
+	const FBlackboardFireProfile WriteAll = ProfileSustainedFire(*this, Tree);
+	SkipUnchanged.Set(TEXT("1"));
+	const FBlackboardFireProfile Skipping = ProfileSustainedFire(*this, Tree);
+	Tree->RemoveFromRoot();
+
+	//Key IDs are cached on possess, no shot looks a key up by name in either run
+	AddInfo(FString::Printf(TEXT("%d shots per second, every write: %.2f SetValue calls per shot, %.1f observer notifications per second, %.3f ms per frame"),
+		ShotsPerSecond, static_cast<double>(WriteAll.NumWrites) / NumShots, WriteAll.NumNotifications / FireSeconds, WriteAll.FireMs / BlackboardProfileFrames));
+	AddInfo(FString::Printf(TEXT("%d shots per second, unchanged writes skipped: %.2f SetValue calls per shot, %.2f skipped per shot, %.1f observer notifications per second, %.3f ms per frame"),
+		ShotsPerSecond, static_cast<double>(Skipping.NumWrites) / NumShots, static_cast<double>(Skipping.NumWritesSkipped) / NumShots,
+		Skipping.NumNotifications / FireSeconds, Skipping.FireMs / BlackboardProfileFrames));
+	TestTrue(TEXT("Sustained fire wrote to the blackboards"), WriteAll.NumWrites > 0);
+	TestEqual(TEXT("Nothing skipped with every write"), WriteAll.NumWritesSkipped, static_cast<int64>(0));
+	TestTrue(TEXT("Unchanged writes skipped"), Skipping.NumWritesSkipped > 0);
+	TestTrue(TEXT("Fewer SetValue calls with unchanged writes skipped"), Skipping.NumWrites < WriteAll.NumWrites);
+	//The blackboard itself drops notifications for unchanged values, skipping saves the SetValue calls, not notifications
+	TestEqual(TEXT("Same observer notifications either way"), Skipping.NumNotifications, WriteAll.NumNotifications);
+	return true;
+}
+
+#endif
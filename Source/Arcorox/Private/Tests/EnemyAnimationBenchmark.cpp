@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyAnimInstance.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyController.h"
+#include "Characters/ArcoroxCharacter.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static const int32 AnimationBenchmarkEnemies = 100;
+static const int32 AnimationBenchmarkFrames = 300;
+static const TCHAR* AnimationBenchmarkMesh = TEXT("/Engine/EngineMeshes/SkeletalCube.SkeletalCube");
+
+/* Spawns the enemies circling the player and returns the game thread milliseconds per frame, AnimClass null leaves the enemies without an anim instance */
+static double MeasureEnemyAnimation(FAutomationTestBase& Test, USkeletalMesh* Mesh, TSubclassOf<UAnimInstance> AnimClass)
+{
+	FArcoroxTestWorld TestWorld;
+	TestWorld.SpawnBlockingBox(FVector(0.f, 0.f, -50.f), FVector(10000.f, 10000.f, 50.f));
+	//Only Arcorox characters are players to the proximity subsystem
+	APawn* Player = TestWorld.SpawnPlayer(FVector(0.f, 0.f, 90.f), AArcoroxCharacter::StaticClass());
+	if (!Test.TestNotNull(TEXT("Player character"), Player)) return 0.0;
+
+	TArray<AEnemy*> Enemies;
+	int32 NumAnimated = 0;
+	for (int32 i = 0; i < AnimationBenchmarkEnemies; i++)
+	{
+		//Inside aggro range so every enemy targets the player
+		const FVector Location{ FRotator(0.f, i * 360.f / AnimationBenchmarkEnemies, 0.f).Vector() * (250.f + (i % 4) * 100.f) + FVector(0.f, 0.f, 100.f) };
+		AEnemy* Enemy = Cast<AEnemy>(TestWorld.SpawnAIPawn(AEnemy::StaticClass(), Location, AEnemyController::StaticClass(), [Mesh, AnimClass](APawn* Pawn)
+		{
+			USkeletalMeshComponent* EnemyMesh = CastChecked<AEnemy>(Pawn)->GetMesh();
+			//Nothing renders in the test world, animation would otherwise be skipped as offscreen
+			EnemyMesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+			EnemyMesh->SetSkeletalMeshAsset(Mesh);
+			if (AnimClass) EnemyMesh->SetAnimInstanceClass(AnimClass);
+		}));
+		if (Enemy == nullptr) continue;
+		Enemies.Add(Enemy);
+		if (AnimClass == nullptr || Cast<UEnemyAnimInstance>(Enemy->GetMesh()->GetAnimInstance())) NumAnimated++;
+	}
+	Test.TestEqual(TEXT("Enemies spawned with their anim instance"), NumAnimated, AnimationBenchmarkEnemies);
+
+	//The test world has no nav mesh to chase on, circling the player keeps every enemy moving so the animation has speed to derive
+	auto TickCircling = [&TestWorld, &Enemies, Player](int32 NumFrames)
+	{
+		double TotalMs = 0.0;
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			for (AEnemy* Enemy : Enemies)
+			{
+				const FVector ToPlayer{ (Player->GetActorLocation() - Enemy->GetActorLocation()).GetSafeNormal2D() };
+				Enemy->AddMovementInput(FVector::CrossProduct(ToPlayer, FVector::UpVector));
+			}
+			TotalMs += TestWorld.Tick();
+		}
+		return TotalMs / FMath::Max(NumFrames, 1);
+	};
+	TickCircling(30);
+	int32 NumTargeting = 0;
+	int32 NumMoving = 0;
+	for (AEnemy* Enemy : Enemies)
+	{
+		if (Enemy->GetTarget() == Player) NumTargeting++;
+		if (Enemy->GetVelocity().SizeSquared2D() > 1.f) NumMoving++;
+		Test.TestFalse(TEXT("Enemy mesh left to the animation budget allocator"), Enemy->GetMesh()->IsUsingExternalTickRateControl());
+	}
+	Test.TestEqual(TEXT("Enemies targeting the player"), NumTargeting, Enemies.Num());
+	Test.TestEqual(TEXT("Enemies moving"), NumMoving, Enemies.Num());
+	return TickCircling(AnimationBenchmarkFrames);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnemyAnimationBenchmark, "Arcorox.Perf.Anim.ThreadSafeUpdate100Enemies",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FEnemyAnimationBenchmark::RunTest(const FString& Parameters)
+{
+	USkeletalMesh* Mesh = LoadObject<USkeletalMesh>(nullptr, AnimationBenchmarkMesh);
+	if (!TestNotNull(TEXT("Engine skeletal cube"), Mesh)) return false;
+	//Native brains give every enemy movement without a behavior tree asset, full rate tier so no animation is throttled
+	FArcoroxScopedConsoleVariable ForceBrainMode(TEXT("arcorox.AI.ForceBrainMode"), TEXT("1"));
+	FArcoroxScopedConsoleVariable ForceTier(TEXT("arcorox.Enemy.ForceSignificanceTier"), TEXT("0"));
+	//Throttled offscreen meshes would measure the allocator budget instead of the update
+	FArcoroxScopedConsoleVariable AnimationBudget(TEXT("arcorox.Enemy.AnimationBudget"), TEXT("0"));
+	FArcoroxScopedConsoleVariable ThreadSafeUpdate(TEXT("arcorox.Anim.ThreadSafeUpdate"), TEXT("0"));
+
+	//Frame cost without any anim instance, the difference to it is the animation update left on the game thread
+	const double BaselineMs = MeasureEnemyAnimation(*this, Mesh, nullptr);
+	const double GameThreadMs = MeasureEnemyAnimation(*this, Mesh, UEnemyAnimInstance::StaticClass());
+	ThreadSafeUpdate.Set(TEXT("1"));
+	const double ThreadSafeMs = MeasureEnemyAnimation(*this, Mesh, UEnemyAnimInstance::StaticClass());
+
+	AddInfo(FString::Printf(TEXT("%d enemies without animation: game thread %.3f ms per frame"), AnimationBenchmarkEnemies, BaselineMs));
+	AddInfo(FString::Printf(TEXT("%d enemies, update on the game thread: %.3f ms per frame, %.3f ms animation"),
+		AnimationBenchmarkEnemies, GameThreadMs, GameThreadMs - BaselineMs));
+	AddInfo(FString::Printf(TEXT("%d enemies, thread-safe update: %.3f ms per frame, %.3f ms animation, %.3f ms saved"),
+		AnimationBenchmarkEnemies, ThreadSafeMs, ThreadSafeMs - BaselineMs, GameThreadMs - ThreadSafeMs));
+	return true;
+}
+
+#endif
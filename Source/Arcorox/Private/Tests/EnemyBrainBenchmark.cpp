@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyBrainSubsystem.h"
+#include "Enemy/EnemyController.h"
+#include "Enemy/Enemy.h"
+#include "Characters/ArcoroxCharacter.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Tests/EnemyTestBehaviorTree.h"
+#include "Misc/AutomationTest.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static const int32 BrainBenchmarkEnemies = 200;
+static const int32 BrainBenchmarkFrames = 300;
+static const float BrainBenchmarkInnerRadius = 90.f;
+static const float BrainBenchmarkOuterRadius = 550.f;
+
+/* Runs 200 enemies with the forced brain mode around the player, all chasing or attacking it, returns the average frame milliseconds */
+static double RunBrainBenchmark(FAutomationTestBase& Test, UBehaviorTree* Tree, bool bNativeBrain, int32& OutNumRunning)
+{
+	FArcoroxScopedConsoleVariable ForceBrainMode(TEXT("arcorox.AI.ForceBrainMode"), bNativeBrain ? TEXT("1") : TEXT("0"));
+	FArcoroxTestWorld TestWorld;
+	TestWorld.SpawnBlockingBox(FVector(0.f, 0.f, -50.f), FVector(10000.f, 10000.f, 50.f));
+	//Only Arcorox characters are players to the proximity subsystem
+	TestWorld.SpawnPlayer(FVector(0.f, 0.f, 90.f), AArcoroxCharacter::StaticClass());
+
+	TArray<AEnemyController*> Controllers;
+	TArray<AEnemy*> Enemies;
+	for (int32 i = 0; i < BrainBenchmarkEnemies; i++)
+	{
+		//Evenly spread over a disc inside aggro range, the innermost ones inside attack range
+		const float Radius = FMath::Sqrt(FMath::Lerp(FMath::Square(BrainBenchmarkInnerRadius), FMath::Square(BrainBenchmarkOuterRadius), (i + 0.5f) / BrainBenchmarkEnemies));
+		const FVector Location{ FRotator(0.f, i * 137.508f, 0.f).Vector() * Radius + FVector(0.f, 0.f, 100.f) };
+		APawn* Pawn = TestWorld.SpawnAIPawn(AEnemy::StaticClass(), Location, AEnemyController::StaticClass(),
+			[Tree](APawn* Spawned) { CastChecked<AEnemy>(Spawned)->SetBehaviorTree(Tree); });
+		if (AEnemyController* Controller = Pawn ? Cast<AEnemyController>(Pawn->GetController()) : nullptr)
+		{
+			Controllers.Add(Controller);
+			Enemies.Add(CastChecked<AEnemy>(Pawn));
+		}
+	}
+	Test.TestEqual(TEXT("Possessed enemies"), Controllers.Num(), BrainBenchmarkEnemies);
+	//Settle aggro and the first brain updates before measuring
+	TestWorld.Tick(30);
+	//The test world has no nav mesh, chasing enemies keep requesting moves as they do when their path is blocked
+	int32 NumChasing = 0;
+	int32 NumAttacking = 0;
+	for (AEnemy* Enemy : Enemies)
+	{
+		if (Enemy->GetTarget() == nullptr) continue;
+		if (Enemy->IsInAttackRange()) NumAttacking++;
+		else NumChasing++;
+	}
+	const TCHAR* Mode = bNativeBrain ? TEXT("native brain") : TEXT("behavior tree");
+	Test.TestEqual(*FString::Printf(TEXT("%s: enemies chasing or attacking the player"), Mode), NumChasing + NumAttacking, BrainBenchmarkEnemies);
+	Test.TestTrue(*FString::Printf(TEXT("%s: enemies attacking the player"), Mode), NumAttacking > 0);
+	Test.AddInfo(FString::Printf(TEXT("%s: %d enemies chasing, %d attacking"), Mode, NumChasing, NumAttacking));
+	const double FrameMs = TestWorld.Tick(BrainBenchmarkFrames);
+
+	OutNumRunning = 0;
+	for (AEnemyController* Controller : Controllers)
+	{
+		const bool bTreeRunning = Controller->GetBehaviorTreeComponent() && Controller->GetBehaviorTreeComponent()->IsRunning();
+		if (bNativeBrain ? Controller->GetBrain().bRunning : bTreeRunning) OutNumRunning++;
+	}
+	return FrameMs;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnemyBrainBenchmark, "Arcorox.Perf.AI.BehaviorTreeVsNativeBrain200Enemies",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FEnemyBrainBenchmark::RunTest(const FString& Parameters)
+{
+	UBehaviorTree* Tree = CreateTestEnemyBehaviorTree();
+	Tree->AddToRoot();
+	int32 NumTreesRunning = 0;
+	const double TreeMs = RunBrainBenchmark(*this, Tree, false, NumTreesRunning);
+	int32 NumBrainsRunning = 0;
+	const double NativeMs = RunBrainBenchmark(*this, Tree, true, NumBrainsRunning);
+	Tree->RemoveFromRoot();
+
+	TestEqual(TEXT("Enemies running the behavior tree"), NumTreesRunning, BrainBenchmarkEnemies);
+	TestEqual(TEXT("Enemies running the native brain"), NumBrainsRunning, BrainBenchmarkEnemies);
+	AddInfo(FString::Printf(TEXT("%d enemies, behavior tree: %.3f ms per frame"), BrainBenchmarkEnemies, TreeMs));
+	AddInfo(FString::Printf(TEXT("%d enemies, native brain: %.3f ms per frame (%.1f%% of the behavior tree)"), BrainBenchmarkEnemies, NativeMs, TreeMs > 0.0 ? NativeMs / TreeMs * 100.0 : 0.0));
+	return true;
+}
+
+#endif
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemyHordeSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static const int32 HordeBenchmarkAgents = 2000;
+static const float HordeBenchmarkRadius = 20000.f;
+static const int32 HordeBenchmarkFrames = 600;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnemyHordeBenchmark, "Arcorox.Perf.Enemy.Horde2000Agents",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FEnemyHordeBenchmark::RunTest(const FString& Parameters)
+{
+	FArcoroxTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+	UEnemyHordeSubsystem* Horde = World->GetSubsystem<UEnemyHordeSubsystem>();
+	if (!TestNotNull(TEXT("Enemy horde subsystem"), Horde)) return false;
+	TestWorld.SpawnBlockingBox(FVector(0.f, 0.f, -50.f), FVector(HordeBenchmarkRadius * 1.5f, HordeBenchmarkRadius * 1.5f, 50.f));
+	APawn* Player = TestWorld.SpawnPlayer(FVector(0.f, 0.f, 90.f));
+
+	double StartSeconds = FPlatformTime::Seconds();
+	Horde->SpawnHorde(HordeBenchmarkAgents, FVector::ZeroVector, HordeBenchmarkRadius, AEnemy::StaticClass());
+	const double SpawnMs = (FPlatformTime::Seconds() - StartSeconds) * 1000.0;
+	if (!TestEqual(TEXT("Horde agents"), Horde->GetNumAgents(), HordeBenchmarkAgents)) return false;
+
+	//The player circles through the horde so agents are promoted and demoted throughout the run
+	double TotalMs = 0.0;
+	double MaxMs = 0.0;
+	int32 MaxPromoted = 0;
+	for (int32 Frame = 0; Frame < HordeBenchmarkFrames; Frame++)
+	{
+		const float Angle = 2.f * PI * Frame / HordeBenchmarkFrames;
+		Player->SetActorLocation(FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f) * HordeBenchmarkRadius * 0.5f + FVector(0.f, 0.f, 90.f));
+		const double FrameMs = TestWorld.Tick();
+		TotalMs += FrameMs;
+		MaxMs = FMath::Max(MaxMs, FrameMs);
+		MaxPromoted = FMath::Max(MaxPromoted, Horde->GetNumPromoted());
+	}
+	TestTrue(TEXT("Agents were promoted near the player"), MaxPromoted > 0);
+	TestTrue(TEXT("Most of the horde stayed simulated as data"), MaxPromoted < HordeBenchmarkAgents / 4);
+	AddInfo(FString::Printf(TEXT("%d agents: spawn %.2f ms, frame %.3f ms average, %.3f ms worst, at most %d promoted actors"),
+		Horde->GetNumAgents(), SpawnMs, TotalMs / HordeBenchmarkFrames, MaxMs, MaxPromoted));
+	return true;
+}
+
+#endif
@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Enemy/EnemySignificanceSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyController.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static const int32 SignificanceBenchmarkEnemies = 300;
+static const int32 SignificanceBenchmarkFrames = 120;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnemySignificanceBenchmark, "Arcorox.Perf.Enemy.Significance300Enemies",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FEnemySignificanceBenchmark::RunTest(const FString& Parameters)
+{
+	//Native brains give every enemy AI work without a behavior tree asset
+	FArcoroxScopedConsoleVariable ForceBrainMode(TEXT("arcorox.AI.ForceBrainMode"), TEXT("1"));
+	FArcoroxScopedConsoleVariable ForceTier(TEXT("arcorox.Enemy.ForceSignificanceTier"), TEXT("-1"));
+
+	FArcoroxTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+	UEnemySignificanceSubsystem* Significance = World->GetSubsystem<UEnemySignificanceSubsystem>();
+	if (!TestNotNull(TEXT("Enemy significance subsystem"), Significance)) return false;
+	TestWorld.SpawnBlockingBox(FVector(0.f, 0.f, -50.f), FVector(20000.f, 20000.f, 50.f));
+	TestWorld.SpawnPlayer(FVector(0.f, 0.f, 90.f));
+
+	//Rings from next to the player out past the last tier distance so every tier is populated when scored normally
+	int32 NumEnemies = 0;
+	for (int32 i = 0; i < SignificanceBenchmarkEnemies; i++)
+	{
+		const float Distance = 500.f + 15000.f * i / SignificanceBenchmarkEnemies;
+		const FVector Location{ FRotator(0.f, i * 137.5f, 0.f).Vector() * Distance + FVector(0.f, 0.f, 100.f) };
+		if (TestWorld.SpawnAIPawn(AEnemy::StaticClass(), Location, AEnemyController::StaticClass())) NumEnemies++;
+	}
+	if (!TestEqual(TEXT("Spawned enemies"), NumEnemies, SignificanceBenchmarkEnemies)) return false;
+
+	const int32 NumTiers = Significance->GetTiers().Num();
+	for (int32 Tier = -1; Tier < NumTiers; Tier++)
+	{
+		ForceTier.Set(FString::FromInt(Tier));
+		//Past one significance pass so the tier is applied to every enemy before measuring
+		TestWorld.Tick(30);
+		const double FrameMs = TestWorld.Tick(SignificanceBenchmarkFrames);
+		if (Tier < 0) AddInfo(FString::Printf(TEXT("%d enemies, scored tiers: game thread %.3f ms per frame"), NumEnemies, FrameMs));
+		else AddInfo(FString::Printf(TEXT("%d enemies, forced tier %d: game thread %.3f ms per frame"), NumEnemies, Tier, FrameMs));
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/EnemyTestBehaviorTree.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/BlackboardKeyType_Object.h"
+#include "BehaviorTree/BlackboardKeyType_Vector.h"
+#include "BehaviorTree/Composites/BTComposite_Selector.h"
+#include "BehaviorTree/Composites/BTComposite_Sequence.h"
+#include "BehaviorTree/Decorators/BTDecorator_Blackboard.h"
+#include "BehaviorTree/Tasks/BTTask_MoveTo.h"
+#include "BehaviorTree/Tasks/BTTask_Wait.h"
+#include "UObject/UnrealType.h"
+
+/* Key selectors and abort modes are editor-only settings without native setters */
+static void SetNodeBlackboardKey(UBTNode* Node, const FName& KeyName)
+{
+	FStructProperty* Property = FindFProperty<FStructProperty>(Node->GetClass(), TEXT("BlackboardKey"));
+	if (Property) Property->ContainerPtrToValuePtr<FBlackboardKeySelector>(Node)->SelectedKeyName = KeyName;
+}
+
+static UBTDecorator_Blackboard* MakeKeySetDecorator(UBehaviorTree* Tree, const FName& KeyName)
+{
+	UBTDecorator_Blackboard* Decorator = NewObject<UBTDecorator_Blackboard>(Tree);
+	SetNodeBlackboardKey(Decorator, KeyName);
+	//Lower priority branches abort as soon as the key is set, like the observers of the enemy tree
+	if (FByteProperty* Property = FindFProperty<FByteProperty>(UBTDecorator::StaticClass(), TEXT("FlowAbortMode")))
+	{
+		*Property->ContainerPtrToValuePtr<uint8>(Decorator) = EBTFlowAbortMode::LowerPriority;
+	}
+	return Decorator;
+}
+
+static UBTTask_Wait* MakeWait(UBehaviorTree* Tree, float WaitTime)
+{
+	UBTTask_Wait* Wait = NewObject<UBTTask_Wait>(Tree);
+	Wait->WaitTime = WaitTime;
+	return Wait;
+}
+
+static UBTTask_MoveTo* MakeMoveTo(UBehaviorTree* Tree, const FName& KeyName)
+{
+	UBTTask_MoveTo* MoveTo = NewObject<UBTTask_MoveTo>(Tree);
+	SetNodeBlackboardKey(MoveTo, KeyName);
+	return MoveTo;
+}
+
+static void AddChild(UBTCompositeNode* Parent, UBTNode* Child, UBTDecorator* Decorator = nullptr)
+{
+	FBTCompositeChild& Entry = Parent->Children.AddDefaulted_GetRef();
+	Entry.ChildComposite = Cast<UBTCompositeNode>(Child);
+	Entry.ChildTask = Cast<UBTTaskNode>(Child);
+	if (Decorator) Entry.Decorators.Add(Decorator);
+}
+
+UBehaviorTree* CreateTestEnemyBehaviorTree()
+{
+	UBehaviorTree* Tree = NewObject<UBehaviorTree>();
+	UBlackboardData* Blackboard = NewObject<UBlackboardData>(Tree);
+	Blackboard->UpdatePersistentKey<UBlackboardKeyType_Object>(TEXT("Target"));
+	Blackboard->UpdatePersistentKey<UBlackboardKeyType_Vector>(TEXT("PatrolPoint"));
+	Blackboard->UpdatePersistentKey<UBlackboardKeyType_Vector>(TEXT("PatrolPoint2"));
+	const TCHAR* BoolKeys[] = { TEXT("CanAttack"), TEXT("InAttackRange"), TEXT("Stunned"), TEXT("Dead"), TEXT("PlayerDead") };
+	for (const TCHAR* Key : BoolKeys) Blackboard->UpdatePersistentKey<UBlackboardKeyType_Bool>(Key);
+	Tree->BlackboardAsset = Blackboard;
+
+	UBTComposite_Selector* Root = NewObject<UBTComposite_Selector>(Tree);
+	AddChild(Root, MakeWait(Tree, 1000.f), MakeKeySetDecorator(Tree, TEXT("Dead")));
+	AddChild(Root, MakeWait(Tree, 0.5f), MakeKeySetDecorator(Tree, TEXT("Stunned")));
+	UBTComposite_Sequence* Chase = NewObject<UBTComposite_Sequence>(Tree);
+	AddChild(Chase, MakeMoveTo(Tree, TEXT("Target")));
+	AddChild(Chase, MakeWait(Tree, 0.5f));
+	AddChild(Root, Chase, MakeKeySetDecorator(Tree, TEXT("Target")));
+	UBTComposite_Sequence* Patrol = NewObject<UBTComposite_Sequence>(Tree);
+	AddChild(Patrol, MakeMoveTo(Tree, TEXT("PatrolPoint")));
+	AddChild(Patrol, MakeWait(Tree, 1.f));
+	AddChild(Patrol, MakeMoveTo(Tree, TEXT("PatrolPoint2")));
+	AddChild(Patrol, MakeWait(Tree, 1.f));
+	AddChild(Root, Patrol);
+	Tree->RootNode = Root;
+	return Tree;
+}
+
+#endif
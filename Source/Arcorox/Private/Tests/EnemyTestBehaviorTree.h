@@ -0,0 +1,14 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class UBehaviorTree;
+
+/* Transient tree over the enemy blackboard keys with the branches of the enemy tree: dead, stunned, chase the target and patrol */
+UBehaviorTree* CreateTestEnemyBehaviorTree();
+
+#endif
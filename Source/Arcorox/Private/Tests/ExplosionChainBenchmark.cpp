@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/ExplosionSubsystem.h"
+#include "Explosive/Explosive.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static const int32 ExplosionChainBarrels = 500;
+static const float ExplosionChainSpacing = 300.f;
+static const int32 ExplosionChainMaxFrames = 3000;
+static const double ExplosionChainHitchMs = 100.0;
+
+/* Spawns a native explosive with a small collision sphere as root, the Blueprint barrel mesh is not available to tests */
+static AExplosive* SpawnBarrel(UWorld* World, const FVector& Location)
+{
+	AExplosive* Explosive = World->SpawnActorDeferred<AExplosive>(AExplosive::StaticClass(), FTransform(Location));
+	if (Explosive == nullptr) return nullptr;
+	USphereComponent* Sphere = NewObject<USphereComponent>(Explosive);
+	Sphere->SetSphereRadius(40.f);
+	Sphere->SetCollisionProfileName(TEXT("PhysicsActor"));
+	Explosive->SetRootComponent(Sphere);
+	Sphere->RegisterComponent();
+	Explosive->FinishSpawning(FTransform(Location));
+	return Explosive;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExplosionChainBenchmark, "Arcorox.Perf.Explosion.Chain500Barrels",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FExplosionChainBenchmark::RunTest(const FString& Parameters)
+{
+	FArcoroxTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+	UExplosionSubsystem* Explosions = World->GetSubsystem<UExplosionSubsystem>();
+	if (!TestNotNull(TEXT("Explosion subsystem"), Explosions)) return false;
+	const int32 Side = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(ExplosionChainBarrels)));
+	TestWorld.SpawnBlockingBox(FVector(0.f, 0.f, -50.f), FVector(Side * ExplosionChainSpacing, Side * ExplosionChainSpacing, 50.f));
+	APawn* Player = TestWorld.SpawnPlayer(FVector(-1000.f, 0.f, 90.f));
+
+	//Grid spacing inside the blast radius so every barrel is set off by its neighbours
+	TArray<AExplosive*> Barrels;
+	for (int32 i = 0; i < ExplosionChainBarrels; i++)
+	{
+		const FVector Location{ (i / Side) * ExplosionChainSpacing, (i % Side - Side / 2) * ExplosionChainSpacing, 50.f };
+		if (AExplosive* Explosive = SpawnBarrel(World, Location)) Barrels.Add(Explosive);
+	}
+	if (!TestEqual(TEXT("Spawned barrels"), Barrels.Num(), ExplosionChainBarrels)) return false;
+	TestWorld.Tick();
+
+	Explosions->QueueDetonation(Barrels[0], Barrels[0]->GetActorLocation(), Player, 0.f);
+	double TotalMs = 0.0;
+	double MaxMs = 0.0;
+	int32 Frames = 0;
+	while (Frames < ExplosionChainMaxFrames && (Explosions->GetNumQueued() > 0 || Frames == 0))
+	{
+		const double FrameMs = TestWorld.Tick();
+		TotalMs += FrameMs;
+		MaxMs = FMath::Max(MaxMs, FrameMs);
+		Frames++;
+	}
+
+	TestEqual(TEXT("Barrels detonated by the chain"), Explosions->GetNumDetonations(), static_cast<uint64>(ExplosionChainBarrels));
+	TestTrue(*FString::Printf(TEXT("Worst frame below %.0f ms"), ExplosionChainHitchMs), MaxMs < ExplosionChainHitchMs);
+	AddInfo(FString::Printf(TEXT("%d barrels: chain took %d frames, frame %.3f ms average, %.3f ms worst, wave %.3f ms worst"),
+		ExplosionChainBarrels, Frames, TotalMs / FMath::Max(Frames, 1), MaxMs, Explosions->GetMaxWaveMs()));
+	return true;
+}
+
+#endif
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HUD/HealthBarSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Interfaces/HitInterface.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Blueprint/UserWidget.h"
+#include "Components/WidgetComponent.h"
+#include "UObject/UObjectIterator.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/* Widgets and widget components that belong to the world */
+static int32 CountWorldWidgets(UWorld* World)
+{
+	int32 NumWidgets = 0;
+	for (TObjectIterator<UUserWidget> It; It; ++It) if (It->GetWorld() == World) NumWidgets++;
+	for (TObjectIterator<UWidgetComponent> It; It; ++It) if (It->GetWorld() == World) NumWidgets++;
+	return NumWidgets;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHealthBarWidgetCountTest, "Arcorox.HUD.HealthBars.WidgetCountIndependentOfEnemies",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHealthBarWidgetCountTest::RunTest(const FString& Parameters)
+{
+	const int32 EnemyCounts[] = { 10, 100 };
+	TArray<int32> AddedWidgets;
+	for (const int32 NumEnemies : EnemyCounts)
+	{
+		FArcoroxTestWorld TestWorld;
+		UWorld* World = TestWorld.GetWorld();
+		UHealthBarSubsystem* HealthBars = World->GetSubsystem<UHealthBarSubsystem>();
+		if (!TestNotNull(TEXT("Health bar subsystem"), HealthBars)) return false;
+
+		TArray<AEnemy*> Enemies;
+		for (int32 i = 0; i < NumEnemies; i++)
+		{
+			AEnemy* Enemy = World->SpawnActor<AEnemy>(AEnemy::StaticClass(), FTransform(FVector((i % 10) * 300.f, (i / 10) * 300.f, 100.f)));
+			if (Enemy) Enemies.Add(Enemy);
+		}
+		if (!TestEqual(TEXT("Spawned enemies"), Enemies.Num(), NumEnemies)) return false;
+		TestWorld.Tick();
+
+		//Every enemy is damaged and shows its health bar at once
+		const int32 WidgetsBeforeHits = CountWorldWidgets(World);
+		for (AEnemy* Enemy : Enemies)
+		{
+			FHitResult HitResult;
+			HitResult.Location = Enemy->GetActorLocation();
+			IHitInterface::Execute_Hit(Enemy, HitResult);
+		}
+		TestWorld.Tick(10);
+
+		TestEqual(*FString::Printf(TEXT("Health bars shown with %d enemies"), NumEnemies), HealthBars->GetNumHealthBars(), NumEnemies);
+		AddedWidgets.Add(CountWorldWidgets(World) - WidgetsBeforeHits);
+		AddInfo(FString::Printf(TEXT("%d damaged enemies: %d widgets before hits, %d added"), NumEnemies, WidgetsBeforeHits, AddedWidgets.Last()));
+	}
+	TestEqual(TEXT("Widgets added for 10 damaged enemies"), AddedWidgets[0], 0);
+	TestEqual(TEXT("Widgets added for 100 damaged enemies"), AddedWidgets[1], AddedWidgets[0]);
+	return true;
+}
+
+#endif
@@ -0,0 +1,247 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/CombatDataRegistry.h"
+#include "Combat/HitZone.h"
+#include "Combat/CombatDamageSubsystem.h"
+#include "Characters/ArcoroxCharacter.h"
+#include "Enemy/Enemy.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "ReferenceSkeleton.h"
+#include "HAL/MemoryBase.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static const int32 HitZoneAllocationHitsPerFrame = 100;
+static const int32 HitZoneAllocationFrames = 100;
+//Low enough that the enemy survives every hit of the test
+static const float HitZoneAllocationDamage = 0.001f;
+
+/* Small humanoid hierarchy: pelvis > spine > neck > head > head_end, spine > clavicle_l > upperarm_l > hand_l, pelvis > thigh_l > foot_l */
+static void BuildTestSkeleton(FReferenceSkeleton& OutRefSkeleton)
+{
+	FReferenceSkeletonModifier Modifier(OutRefSkeleton, nullptr);
+	const TPair<const TCHAR*, const TCHAR*> Bones[] = {
+		{ TEXT("pelvis"), nullptr },
+		{ TEXT("spine"), TEXT("pelvis") },
+		{ TEXT("neck"), TEXT("spine") },
+		{ TEXT("head"), TEXT("neck") },
+		{ TEXT("head_end"), TEXT("head") },
+		{ TEXT("clavicle_l"), TEXT("spine") },
+		{ TEXT("upperarm_l"), TEXT("clavicle_l") },
+		{ TEXT("hand_l"), TEXT("upperarm_l") },
+		{ TEXT("thigh_l"), TEXT("pelvis") },
+		{ TEXT("foot_l"), TEXT("thigh_l") }
+	};
+	for (const TPair<const TCHAR*, const TCHAR*>& Bone : Bones)
+	{
+		const int32 ParentIndex = Bone.Value ? Modifier.FindBoneIndex(Bone.Value) : INDEX_NONE;
+		Modifier.Add(FMeshBoneInfo(Bone.Key, Bone.Key, ParentIndex), FTransform::Identity);
+	}
+}
+
+/* Checks the zone and combined multiplier of one bone */
+static void TestBoneZone(FAutomationTestBase& Test, const FCompiledHitZones& HitZones, const FReferenceSkeleton& RefSkeleton, const TCHAR* BoneName,
+	const FHitZoneMultipliers& WeaponMultipliers, EHitZone ExpectedZone, float ExpectedMultiplier)
+{
+	EHitZone Zone;
+	const float Multiplier = HitZones.GetMultiplier(RefSkeleton.FindBoneIndex(BoneName), WeaponMultipliers, Zone);
+	Test.TestEqual(*FString::Printf(TEXT("%s zone"), BoneName), static_cast<int32>(Zone), static_cast<int32>(ExpectedZone));
+	Test.TestEqual(*FString::Printf(TEXT("%s multiplier"), BoneName), Multiplier, ExpectedMultiplier);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitZoneTableMultipliersTest, "Arcorox.Combat.HitZones.TableZoneMultipliers",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHitZoneTableMultipliersTest::RunTest(const FString& Parameters)
+{
+	FReferenceSkeleton RefSkeleton;
+	BuildTestSkeleton(RefSkeleton);
+	FHitZoneTable Row;
+	Row.HeadBones.Add(TEXT("head"));
+	Row.ArmBones.Add(TEXT("clavicle_l"));
+	Row.LegBones.Add(TEXT("thigh_l"));
+	Row.HeadMultiplier = 4.f;
+	Row.TorsoMultiplier = 1.f;
+	Row.ArmMultiplier = 0.75f;
+	Row.LegMultiplier = 0.5f;
+	FCompiledHitZones HitZones;
+	UCombatDataRegistry::CompileBoneZones(HitZones, RefSkeleton, &Row);
+	TestTrue(TEXT("Compiled from the table"), HitZones.bFromTable);
+	TestEqual(TEXT("One entry per bone"), HitZones.Bones.Num(), RefSkeleton.GetNum());
+
+	//Skeleton multipliers alone, then combined with a weapon's
+	const FHitZoneMultipliers NoWeapon;
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("pelvis"), NoWeapon, EHitZone::EHZ_Torso, 1.f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("neck"), NoWeapon, EHitZone::EHZ_Torso, 1.f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("head"), NoWeapon, EHitZone::EHZ_Head, 4.f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("head_end"), NoWeapon, EHitZone::EHZ_Head, 4.f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("clavicle_l"), NoWeapon, EHitZone::EHZ_Arms, 0.75f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("hand_l"), NoWeapon, EHitZone::EHZ_Arms, 0.75f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("thigh_l"), NoWeapon, EHitZone::EHZ_Legs, 0.5f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("foot_l"), NoWeapon, EHitZone::EHZ_Legs, 0.5f);
+
+	FHitZoneMultipliers Weapon;
+	Weapon.Set(EHitZone::EHZ_Head, 2.f);
+	Weapon.Set(EHitZone::EHZ_Torso, 1.5f);
+	Weapon.Set(EHitZone::EHZ_Arms, 0.8f);
+	Weapon.Set(EHitZone::EHZ_Legs, 0.6f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("spine"), Weapon, EHitZone::EHZ_Torso, 1.5f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("head"), Weapon, EHitZone::EHZ_Head, 8.f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("upperarm_l"), Weapon, EHitZone::EHZ_Arms, 0.6f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("foot_l"), Weapon, EHitZone::EHZ_Legs, 0.3f);
+
+	//Bones the mesh does not have count as torso
+	EHitZone Zone;
+	TestEqual(TEXT("Unknown bone multiplier"), HitZones.GetMultiplier(INDEX_NONE, Weapon, Zone), 1.5f);
+	TestEqual(TEXT("Unknown bone zone"), static_cast<int32>(Zone), static_cast<int32>(EHitZone::EHZ_Torso));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitZoneFallbackHeadBoneTest, "Arcorox.Combat.HitZones.FallbackHeadBoneOnly",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHitZoneFallbackHeadBoneTest::RunTest(const FString& Parameters)
+{
+	FReferenceSkeleton RefSkeleton;
+	BuildTestSkeleton(RefSkeleton);
+	FCompiledHitZones HitZones;
+	HitZones.FallbackHeadBone = TEXT("head");
+	UCombatDataRegistry::CompileBoneZones(HitZones, RefSkeleton, nullptr);
+	TestFalse(TEXT("Compiled without a table row"), HitZones.bFromTable);
+
+	//Only the exact head bone is head, as the bone name check it replaces
+	FHitZoneMultipliers Weapon;
+	Weapon.Set(EHitZone::EHZ_Head, 2.f);
+	Weapon.Set(EHitZone::EHZ_Arms, 0.8f);
+	Weapon.Set(EHitZone::EHZ_Legs, 0.8f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("head"), Weapon, EHitZone::EHZ_Head, 2.f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("head_end"), Weapon, EHitZone::EHZ_Torso, 1.f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("neck"), Weapon, EHitZone::EHZ_Torso, 1.f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("hand_l"), Weapon, EHitZone::EHZ_Torso, 1.f);
+	TestBoneZone(*this, HitZones, RefSkeleton, TEXT("foot_l"), Weapon, EHitZone::EHZ_Torso, 1.f);
+	return true;
+}
+
+/* Forwards to the allocator it wraps and counts the game thread allocations passing through while counting is on */
+class FArcoroxCountingMalloc : public FMalloc
+{
+public:
+	explicit FArcoroxCountingMalloc(FMalloc* InInner) : Inner(InInner), bCounting(false), NumAllocations(0) {}
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		if (bCounting.load(std::memory_order_relaxed) && IsInGameThread()) NumAllocations++;
+		return Inner->Malloc(Count, Alignment);
+	}
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		if (Count > 0 && bCounting.load(std::memory_order_relaxed) && IsInGameThread()) NumAllocations++;
+		return Inner->Realloc(Original, Count, Alignment);
+	}
+	virtual void Free(void* Original) override { Inner->Free(Original); }
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+	virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+	virtual void UpdateStats() override { Inner->UpdateStats(); }
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+	virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+
+	FMalloc* const Inner;
+	std::atomic<bool> bCounting;
+	std::atomic<int64> NumAllocations;
+};
+
+/* Wraps GMalloc on first use and stays installed for the rest of the process, so a thread that read GMalloc at any point always calls into a live allocator */
+static FArcoroxCountingMalloc& GetCountingMalloc()
+{
+	static FArcoroxCountingMalloc* CountingMalloc = nullptr;
+	if (CountingMalloc == nullptr)
+	{
+		//Never freed, it must outlive every thread that may still hold it
+		CountingMalloc = new FArcoroxCountingMalloc(GMalloc);
+		GMalloc = CountingMalloc;
+	}
+	return *CountingMalloc;
+}
+
+/* Fires one frame of hits from the shooter through ApplyBulletHit, counting the game thread allocations they make */
+static int64 FireCountedHits(AArcoroxCharacter* Shooter, const TArray<FHitResult>& Hits, const FHitZoneMultipliers& Weapon, int32 NumHits)
+{
+	FArcoroxCountingMalloc& CountingMalloc = GetCountingMalloc();
+	const int64 StartAllocations = CountingMalloc.NumAllocations;
+	CountingMalloc.bCounting = true;
+	for (int32 Hit = 0; Hit < NumHits; Hit++)
+	{
+		Shooter->ApplyBulletHit(FTransform::Identity, Hits[Hit % Hits.Num()], HitZoneAllocationDamage, Weapon);
+	}
+	CountingMalloc.bCounting = false;
+	return CountingMalloc.NumAllocations - StartAllocations;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitZoneAllocationsPerHitTest, "Arcorox.Perf.Combat.HitZoneAllocationsPerHit",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FHitZoneAllocationsPerHitTest::RunTest(const FString& Parameters)
+{
+	USkeletalMesh* Mesh = LoadObject<USkeletalMesh>(nullptr, TEXT("/Engine/EngineMeshes/SkeletalCube.SkeletalCube"));
+	if (!TestNotNull(TEXT("Engine skeletal cube"), Mesh)) return false;
+	FArcoroxScopedConsoleVariable Batched(TEXT("arcorox.Damage.Batched"), TEXT("1"));
+	FArcoroxTestWorld TestWorld;
+	UCombatDamageSubsystem* CombatDamage = TestWorld.GetWorld()->GetSubsystem<UCombatDamageSubsystem>();
+	if (!TestNotNull(TEXT("Combat damage subsystem"), CombatDamage)) return false;
+	AArcoroxCharacter* Shooter = Cast<AArcoroxCharacter>(TestWorld.SpawnPlayer(FVector(-500.f, 0.f, 100.f), AArcoroxCharacter::StaticClass()));
+	if (!TestNotNull(TEXT("Shooter"), Shooter)) return false;
+	//The mesh is set before BeginPlay, where the enemy takes its compiled hit zones from the registry
+	AEnemy* Enemy = Cast<AEnemy>(TestWorld.SpawnAIPawn(AEnemy::StaticClass(), FVector(0.f, 0.f, 100.f), nullptr,
+		[Mesh](APawn* Pawn) { CastChecked<AEnemy>(Pawn)->GetMesh()->SetSkeletalMeshAsset(Mesh); }));
+	if (!TestNotNull(TEXT("Enemy"), Enemy) || !TestTrue(TEXT("Enemy damage is batched"), Enemy->UsesBatchedDamage())) return false;
+
+	//One hit result per bone of the mesh and one on a bone it does not have, made up front as the trace would
+	TArray<FHitResult> Hits;
+	for (int32 BoneIndex = 0; BoneIndex <= Mesh->GetRefSkeleton().GetNum(); BoneIndex++)
+	{
+		FHitResult& Hit = Hits.AddDefaulted_GetRef();
+		Hit.bBlockingHit = true;
+		Hit.HitObjectHandle = FActorInstanceHandle(Enemy);
+		Hit.Component = Enemy->GetMesh();
+		Hit.Location = Hit.ImpactPoint = Enemy->GetActorLocation();
+		Hit.BoneName = BoneIndex < Mesh->GetRefSkeleton().GetNum() ? Mesh->GetRefSkeleton().GetBoneName(BoneIndex) : FName(TEXT("not_a_bone"));
+	}
+	FHitZoneMultipliers Weapon;
+	Weapon.Set(EHitZone::EHZ_Head, 2.f);
+
+	//The first frame grows the damage queue and health bar bookkeeping, later frames reuse them
+	FireCountedHits(Shooter, Hits, Weapon, HitZoneAllocationHitsPerFrame);
+	TestWorld.Tick();
+	int64 NumAllocations = 0;
+	int32 NumQueued = 0;
+	double HitsMs = 0.0;
+	for (int32 Frame = 0; Frame < HitZoneAllocationFrames; Frame++)
+	{
+		const double StartSeconds = FPlatformTime::Seconds();
+		NumAllocations += FireCountedHits(Shooter, Hits, Weapon, HitZoneAllocationHitsPerFrame);
+		HitsMs += (FPlatformTime::Seconds() - StartSeconds) * 1000.0;
+		NumQueued += CombatDamage->GetNumQueued();
+		TestWorld.Tick();
+	}
+
+	const int32 NumHits = HitZoneAllocationHitsPerFrame * HitZoneAllocationFrames;
+	TestEqual(TEXT("Heap allocations applying hits"), NumAllocations, static_cast<int64>(0));
+	TestEqual(TEXT("Every hit reached the damage queue"), NumQueued, NumHits);
+	TestFalse(TEXT("Enemy survived the hits"), Enemy->IsDead());
+	AddInfo(FString::Printf(TEXT("%d hits over %d bones through ApplyBulletHit: %.3f allocations per hit, %.4f us per hit"),
+		NumHits, Hits.Num(), static_cast<double>(NumAllocations) / NumHits, HitsMs * 1000.0 / NumHits));
+	return true;
+}
+
+#endif
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/HitscanSubsystem.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitscanSyncMatchesAsyncTest, "Arcorox.Combat.Hitscan.SyncMatchesAsync",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHitscanSyncMatchesAsyncTest::RunTest(const FString& Parameters)
+{
+	FArcoroxTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+
+	//A ring of boxes at increasing distances, shots fanned around the ring hit some and pass between others
+	for (int32 i = 0; i < 8; i++)
+	{
+		const FVector Direction{ FRotator(0.f, i * 45.f, 0.f).Vector() };
+		TestWorld.SpawnBlockingBox(Direction * (500.f + i * 150.f), FVector(60.f));
+	}
+	TArray<FHitscanShot> Shots;
+	for (int32 i = 0; i < 64; i++)
+	{
+		FHitscanShot& Shot = Shots.AddDefaulted_GetRef();
+		Shot.SocketTransform = FTransform(FVector(0.f, 0.f, (i % 4) * 20.f - 30.f));
+		Shot.BeamEnd = FRotator(0.f, i * 5.625f, 0.f).Vector() * 2000.f;
+	}
+
+	TArray<FHitResult> SyncHits;
+	SyncHits.SetNum(Shots.Num());
+	for (int32 i = 0; i < Shots.Num(); i++) UHitscanSubsystem::TraceBarrel(World, Shots[i], SyncHits[i]);
+
+	TArray<FHitResult> AsyncHits;
+	AsyncHits.SetNum(Shots.Num());
+	TBitArray<> Resolved(false, Shots.Num());
+	FTraceDelegate Delegate = FTraceDelegate::CreateLambda([&AsyncHits, &Resolved](const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+	{
+		if (TraceDatum.OutHits.Num() > 0) AsyncHits[TraceDatum.UserData] = TraceDatum.OutHits[0];
+		Resolved[TraceDatum.UserData] = true;
+	});
+	for (int32 i = 0; i < Shots.Num(); i++) UHitscanSubsystem::SubmitBarrelTrace(World, Shots[i], &Delegate, i);
+	//Async results arrive at the start of a later frame
+	for (int32 Frame = 0; Frame < 4 && Resolved.Find(false) != INDEX_NONE; Frame++) TestWorld.Tick();
+	if (!TestTrue(TEXT("Every async barrel trace resolved"), Resolved.Find(false) == INDEX_NONE)) return false;
+
+	int32 NumBlocking = 0;
+	for (int32 i = 0; i < Shots.Num(); i++)
+	{
+		TestTrue(*FString::Printf(TEXT("Shot %d blocking hit"), i), AsyncHits[i].bBlockingHit == SyncHits[i].bBlockingHit);
+		TestTrue(*FString::Printf(TEXT("Shot %d hit actor"), i), AsyncHits[i].GetActor() == SyncHits[i].GetActor());
+		TestEqual(*FString::Printf(TEXT("Shot %d impact point"), i), AsyncHits[i].ImpactPoint, SyncHits[i].ImpactPoint, 0.1f);
+		if (SyncHits[i].bBlockingHit) NumBlocking++;
+	}
+	//Guards against a scene where nothing is hit, which would make the comparison meaningless
+	TestTrue(TEXT("Some shots hit a box"), NumBlocking > 0 && NumBlocking < Shots.Num());
+	return true;
+}
+
+#endif
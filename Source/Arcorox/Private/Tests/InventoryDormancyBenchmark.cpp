@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Characters/ArcoroxCharacter.h"
+#include "Items/Weapon.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Animation/AnimInstance.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static const int32 InventoryBenchmarkSlots = 6;
+static const int32 InventoryBenchmarkFrames = 300;
+static const TCHAR* InventoryBenchmarkMesh = TEXT("/Engine/EngineMeshes/SkeletalCube.SkeletalCube");
+
+/* Cost of a full inventory for one dormancy setting */
+struct FInventoryBenchmarkResult
+{
+	double FrameMs = 0.0;
+	int32 NumDormant = 0;
+	int32 NumTicking = 0;
+	int32 NumPhysicsStates = 0;
+	int64 TotalBytes = 0;
+};
+
+/* Picks up six weapons with the player, ticks the world and counts what the carried items keep alive, as arcorox.Items.DormancyReport does */
+static bool MeasureInventory(FAutomationTestBase& Test, USkeletalMesh* Mesh, FInventoryBenchmarkResult& OutResult)
+{
+	FArcoroxTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+	TestWorld.SpawnBlockingBox(FVector(0.f, 0.f, -50.f), FVector(5000.f, 5000.f, 50.f));
+	AArcoroxCharacter* Character = Cast<AArcoroxCharacter>(TestWorld.SpawnPlayer(FVector(0.f, 0.f, 90.f), AArcoroxCharacter::StaticClass()));
+	if (!Test.TestNotNull(TEXT("Player character"), Character)) return false;
+
+	//The Blueprint weapons are not available to tests, native weapons with an animated engine mesh stand in for them
+	for (int32 i = 0; i < InventoryBenchmarkSlots; i++)
+	{
+		AWeapon* Weapon = World->SpawnActor<AWeapon>(AWeapon::StaticClass(), FTransform(FVector(200.f * i, 300.f, 50.f)));
+		if (Weapon == nullptr) continue;
+		USkeletalMeshComponent* WeaponMesh = Weapon->GetItemMesh();
+		//Nothing renders in the test world, animation would otherwise be skipped as offscreen
+		WeaponMesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+		WeaponMesh->SetSkeletalMeshAsset(Mesh);
+		WeaponMesh->SetAnimInstanceClass(UAnimInstance::StaticClass());
+		Character->GetPickupItem(Weapon);
+	}
+	if (!Test.TestEqual(TEXT("Inventory slots filled"), Character->GetInventory().Num(), InventoryBenchmarkSlots)) return false;
+	TestWorld.Tick(30);
+	OutResult.FrameMs = TestWorld.Tick(InventoryBenchmarkFrames);
+
+	for (AItem* Item : Character->GetInventory())
+	{
+		if (Item == nullptr) continue;
+		Item->ForEachComponent(false, [&OutResult](UActorComponent* Component)
+		{
+			if (Component->IsComponentTickEnabled()) OutResult.NumTicking++;
+			if (Component->IsPhysicsStateCreated()) OutResult.NumPhysicsStates++;
+			OutResult.TotalBytes += Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		});
+		if (UAnimInstance* AnimInstance = Item->GetItemMesh()->GetAnimInstance()) OutResult.TotalBytes += AnimInstance->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		if (Item->IsDormant()) OutResult.NumDormant++;
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryDormancyBenchmark, "Arcorox.Perf.Items.InventoryDormancySixSlots",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FInventoryDormancyBenchmark::RunTest(const FString& Parameters)
+{
+	USkeletalMesh* Mesh = LoadObject<USkeletalMesh>(nullptr, InventoryBenchmarkMesh);
+	if (!TestNotNull(TEXT("Engine skeletal cube"), Mesh)) return false;
+	FArcoroxScopedConsoleVariable Dormancy(TEXT("arcorox.Items.Dormancy"), TEXT("0"));
+
+	FInventoryBenchmarkResult Awake;
+	if (!MeasureInventory(*this, Mesh, Awake)) return false;
+	Dormancy.Set(TEXT("1"));
+	FInventoryBenchmarkResult Dormant;
+	if (!MeasureInventory(*this, Mesh, Dormant)) return false;
+
+	TestEqual(TEXT("No items dormant with dormancy off"), Awake.NumDormant, 0);
+	TestEqual(TEXT("Every carried item dormant"), Dormant.NumDormant, InventoryBenchmarkSlots);
+	TestTrue(TEXT("Dormant items tick less"), Dormant.NumTicking < Awake.NumTicking);
+	AddInfo(FString::Printf(TEXT("%d items awake: frame %.3f ms, %d ticking components, %d physics states, %lld bytes"),
+		InventoryBenchmarkSlots, Awake.FrameMs, Awake.NumTicking, Awake.NumPhysicsStates, Awake.TotalBytes));
+	AddInfo(FString::Printf(TEXT("%d items dormant: frame %.3f ms, %d ticking components, %d physics states, %lld bytes, %.3f ms saved per frame"),
+		InventoryBenchmarkSlots, Dormant.FrameMs, Dormant.NumTicking, Dormant.NumPhysicsStates, Dormant.TotalBytes, Awake.FrameMs - Dormant.FrameMs));
+	return true;
+}
+
+#endif
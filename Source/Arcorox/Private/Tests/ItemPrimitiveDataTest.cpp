@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/Item.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "UObject/UnrealType.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/* Spawns an item sharing Material, bUsesPrimitiveData has no native setter since only the material asset decides it */
+static AItem* SpawnMaterialItem(UWorld* World, UMaterialInstance* Material, bool bUsesPrimitiveData, const FVector& Location)
+{
+	AItem* Item = World->SpawnActorDeferred<AItem>(AItem::StaticClass(), FTransform(Location));
+	if (Item == nullptr) return nullptr;
+	Item->SetMaterialInstance(Material);
+	if (FBoolProperty* Property = FindFProperty<FBoolProperty>(AItem::StaticClass(), TEXT("bMaterialUsesPrimitiveData")))
+	{
+		Property->SetPropertyValue_InContainer(Item, bUsesPrimitiveData);
+	}
+	Item->FinishSpawning(FTransform(Location));
+	return Item;
+}
+
+static float GetPrimitiveData(const AItem* Item, int32 Index)
+{
+	const TArray<float>& Data = Item->GetItemMesh()->GetCustomPrimitiveData().Data;
+	return Data.IsValidIndex(Index) ? Data[Index] : -1.f;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemPrimitiveDataTest, "Arcorox.Items.Material.PrimitiveDataSharesMaterial",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FItemPrimitiveDataTest::RunTest(const FString& Parameters)
+{
+	FArcoroxTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+	//Stands in for the item material instance, no item material in the project reads primitive data yet
+	UMaterialInstance* Material = UMaterialInstanceDynamic::Create(UMaterial::GetDefaultMaterial(MD_Surface), nullptr);
+
+	AItem* First = SpawnMaterialItem(World, Material, true, FVector(0.f, 0.f, 50.f));
+	AItem* Second = SpawnMaterialItem(World, Material, true, FVector(200.f, 0.f, 50.f));
+	AItem* Named = SpawnMaterialItem(World, Material, false, FVector(400.f, 0.f, 50.f));
+	if (!TestNotNull(TEXT("First item"), First) || !TestNotNull(TEXT("Second item"), Second) || !TestNotNull(TEXT("Named parameter item"), Named)) return false;
+	TestWorld.Tick(10);
+
+	//Primitive data items batch on the one shared instance and animate in the material, nothing updates them per frame
+	for (AItem* Item : { First, Second })
+	{
+		TestEqual(TEXT("Item mesh uses the shared material"), Item->GetItemMesh()->GetMaterial(Item->GetMaterialIndex()), static_cast<UMaterialInterface*>(Material));
+		TestEqual(TEXT("Glow amount slot"), GetPrimitiveData(Item, ItemPrimitiveData::GlowAmount), 150.f);
+		TestEqual(TEXT("Glow enabled on pickup"), GetPrimitiveData(Item, ItemPrimitiveData::GlowBlendAlpha), 0.f);
+		TestEqual(TEXT("Pickup pulse slot"), GetPrimitiveData(Item, ItemPrimitiveData::PulseType), static_cast<float>(EItemMaterialPulse::EIMP_Pickup));
+		TestEqual(TEXT("Pulse duration slot"), GetPrimitiveData(Item, ItemPrimitiveData::PulseDuration), 5.f);
+		TestEqual(TEXT("Not updated by the item update subsystem"), Item->GetItemUpdateIndex(), static_cast<int32>(INDEX_NONE));
+	}
+
+	First->DisableGlowMaterial();
+	TestEqual(TEXT("Glow disabled through primitive data"), GetPrimitiveData(First, ItemPrimitiveData::GlowBlendAlpha), 1.f);
+	TestEqual(TEXT("Other item keeps its glow"), GetPrimitiveData(Second, ItemPrimitiveData::GlowBlendAlpha), 0.f);
+
+	//The default path still gives every item its own instance
+	UMaterialInterface* NamedMaterial = Named->GetItemMesh()->GetMaterial(Named->GetMaterialIndex());
+	TestTrue(TEXT("Named parameter item has its own dynamic instance"), NamedMaterial != Material && Cast<UMaterialInstanceDynamic>(NamedMaterial) != nullptr);
+	return true;
+}
+
+#endif
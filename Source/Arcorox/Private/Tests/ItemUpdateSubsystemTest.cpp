@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/ItemUpdateSubsystem.h"
+#include "Items/Item.h"
+#include "Items/Weapon.h"
+#include "Items/Ammo.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FIdleItemsRegisterNoTicksTest, "Arcorox.Items.ItemUpdate.IdleItemsRegisterNoTicks",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FIdleItemsRegisterNoTicksTest::RunTest(const FString& Parameters)
+{
+	FArcoroxTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+	UItemUpdateSubsystem* ItemUpdate = World->GetSubsystem<UItemUpdateSubsystem>();
+	if (!TestNotNull(TEXT("Item update subsystem"), ItemUpdate)) return false;
+
+	//Every item class in each state that has nothing to animate
+	UClass* ItemClasses[] = { AItem::StaticClass(), AWeapon::StaticClass(), AAmmo::StaticClass() };
+	const EItemState IdleStates[] = { EItemState::EIS_Pickup, EItemState::EIS_PickedUp, EItemState::EIS_Equipped };
+	TArray<AItem*> Items;
+	for (UClass* ItemClass : ItemClasses)
+	{
+		for (const EItemState State : IdleStates)
+		{
+			AItem* Item = World->SpawnActor<AItem>(ItemClass, FTransform(FVector(Items.Num() * 200.f, 0.f, 0.f)));
+			if (!TestNotNull(*FString::Printf(TEXT("Spawned %s"), *ItemClass->GetName()), Item)) continue;
+			Item->SetItemState(State);
+			Items.Add(Item);
+		}
+	}
+	TestWorld.Tick(10);
+
+	for (AItem* Item : Items)
+	{
+		const FString Name{ FString::Printf(TEXT("%s in state %d"), *Item->GetClass()->GetName(), static_cast<int32>(Item->GetItemState())) };
+		TestFalse(*(Name + TEXT(" registered an actor tick")), Item->PrimaryActorTick.IsTickFunctionRegistered());
+		TestFalse(*(Name + TEXT(" needs an item update")), Item->NeedsItemUpdate());
+		TestEqual(*(Name + TEXT(" item update index")), Item->GetItemUpdateIndex(), static_cast<int32>(INDEX_NONE));
+	}
+	TestEqual(TEXT("Items updated by the item update subsystem"), ItemUpdate->GetNumActiveItems(), 0);
+	return true;
+}
+
+#endif
@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/LootIndexSubsystem.h"
+#include "Items/Item.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static const int32 LootBenchmarkPickups = 5000;
+static const int32 LootBenchmarkColumns = 100;
+static const float LootBenchmarkSpacing = 200.f;
+static const int32 LootBenchmarkFrames = 300;
+static const int32 LootBenchmarkQueries = 1000;
+
+/* Lays the pickups out on a grid the player walks across */
+static void SpawnLootGrid(UWorld* World, TArray<AItem*>& OutItems)
+{
+	for (int32 i = 0; i < LootBenchmarkPickups; i++)
+	{
+		const FVector Location{ (i % LootBenchmarkColumns) * LootBenchmarkSpacing, (i / LootBenchmarkColumns) * LootBenchmarkSpacing, 0.f };
+		if (AItem* Item = World->SpawnActor<AItem>(AItem::StaticClass(), FTransform(Location))) OutItems.Add(Item);
+	}
+}
+
+/* Player path across the middle of the grid, one step per frame at running speed */
+static FVector GetLootBenchmarkPlayerLocation(int32 Frame)
+{
+	return FVector(Frame * 10.f, LootBenchmarkPickups / LootBenchmarkColumns * LootBenchmarkSpacing * 0.5f, 90.f);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLootIndexBenchmark, "Arcorox.Perf.Items.LootIndex5000Pickups",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FLootIndexBenchmark::RunTest(const FString& Parameters)
+{
+	//Loot index: pickups only carry their box, focus is a cone query plus one visibility trace
+	double IndexFrameMs = 0.0;
+	{
+		FArcoroxTestWorld TestWorld;
+		UWorld* World = TestWorld.GetWorld();
+		TArray<AItem*> Items;
+		SpawnLootGrid(World, Items);
+		ULootIndexSubsystem* LootIndex = World->GetSubsystem<ULootIndexSubsystem>();
+		if (!TestNotNull(TEXT("Loot index subsystem"), LootIndex)) return false;
+		TestEqual(TEXT("Every pickup is indexed"), LootIndex->GetNumItems(), Items.Num());
+
+		double StartSeconds = FPlatformTime::Seconds();
+		for (AItem* Item : Items) LootIndex->AddItem(Item);
+		const double ReindexMs = (FPlatformTime::Seconds() - StartSeconds) * 1000.0;
+
+		FRandomStream Random(LootBenchmarkPickups);
+		const FBox Field{ FVector(0.f), FVector(LootBenchmarkColumns * LootBenchmarkSpacing, LootBenchmarkPickups / LootBenchmarkColumns * LootBenchmarkSpacing, 0.f) };
+		int32 NumFocused = 0;
+		StartSeconds = FPlatformTime::Seconds();
+		for (int32 i = 0; i < LootBenchmarkQueries; i++)
+		{
+			const FVector Center{ Random.FRandRange(Field.Min.X, Field.Max.X), Random.FRandRange(Field.Min.Y, Field.Max.Y), 0.f };
+			const FVector Direction{ FRotator(-20.f, Random.FRandRange(0.f, 360.f), 0.f).Vector() };
+			if (LootIndex->FindFocusItem(Center, 250.f, Center + FVector(0.f, 0.f, 150.f) - Direction * 200.f, Direction, 10.f)) NumFocused++;
+		}
+		const double QueryUs = (FPlatformTime::Seconds() - StartSeconds) * 1000000.0 / LootBenchmarkQueries;
+
+		APawn* Player = TestWorld.SpawnPlayer(GetLootBenchmarkPlayerLocation(0));
+		for (int32 Frame = 0; Frame < LootBenchmarkFrames; Frame++)
+		{
+			const FVector PlayerLocation{ GetLootBenchmarkPlayerLocation(Frame) };
+			Player->SetActorLocation(PlayerLocation);
+			StartSeconds = FPlatformTime::Seconds();
+			LootIndex->FindFocusItem(PlayerLocation, 250.f, PlayerLocation - FVector(200.f, 0.f, -60.f), FRotator(-20.f, 0.f, 0.f).Vector(), 10.f, Player);
+			IndexFrameMs += (FPlatformTime::Seconds() - StartSeconds) * 1000.0 + TestWorld.Tick();
+		}
+		IndexFrameMs /= LootBenchmarkFrames;
+		AddInfo(FString::Printf(TEXT("Loot index, %d pickups: re-index all %.3f ms, focus query %.2f us (%d/%d focused), frame %.3f ms"),
+			Items.Num(), ReindexMs, QueryUs, NumFocused, LootBenchmarkQueries, IndexFrameMs));
+	}
+
+	//Previous setup: an overlap sphere per pickup and a 50000 unit crosshair trace every frame while one overlaps
+	double SphereFrameMs = 0.0;
+	{
+		FArcoroxTestWorld TestWorld;
+		UWorld* World = TestWorld.GetWorld();
+		TArray<AItem*> Items;
+		SpawnLootGrid(World, Items);
+		for (AItem* Item : Items)
+		{
+			USphereComponent* OverlapSphere = NewObject<USphereComponent>(Item);
+			OverlapSphere->SetupAttachment(Item->GetRootComponent());
+			OverlapSphere->SetSphereRadius(250.f);
+			OverlapSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+			OverlapSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
+			OverlapSphere->SetGenerateOverlapEvents(true);
+			OverlapSphere->RegisterComponent();
+		}
+
+		APawn* Player = TestWorld.SpawnPlayer(GetLootBenchmarkPlayerLocation(0));
+		const FCollisionQueryParams QueryParams{ SCENE_QUERY_STAT(LootBenchmarkCrosshair), false, Player };
+		for (int32 Frame = 0; Frame < LootBenchmarkFrames; Frame++)
+		{
+			const FVector PlayerLocation{ GetLootBenchmarkPlayerLocation(Frame) };
+			const double StartSeconds = FPlatformTime::Seconds();
+			//Moving the pawn updates its overlaps against every sphere it passes
+			Player->SetActorLocation(PlayerLocation);
+			FHitResult Hit;
+			World->LineTraceSingleByChannel(Hit, PlayerLocation, PlayerLocation + FRotator(-20.f, 0.f, 0.f).Vector() * 50000.f, ECollisionChannel::ECC_Visibility, QueryParams);
+			SphereFrameMs += (FPlatformTime::Seconds() - StartSeconds) * 1000.0 + TestWorld.Tick();
+		}
+		SphereFrameMs /= LootBenchmarkFrames;
+		AddInfo(FString::Printf(TEXT("Overlap spheres, %d pickups: frame %.3f ms"), Items.Num(), SphereFrameMs));
+	}
+
+	AddInfo(FString::Printf(TEXT("Frame cost with the loot index is %.1f%% of the overlap sphere setup"), SphereFrameMs > 0.0 ? IndexFrameMs / SphereFrameMs * 100.0 : 0.0));
+	return true;
+}
+
+#endif
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Items/PickupPoolSubsystem.h"
+#include "Items/Ammo.h"
+#include "Items/Weapon.h"
+#include "Characters/ArcoroxCharacter.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPickupPoolReusesAmmoTest, "Arcorox.Items.PickupPool.AmmoPickupRespawnReusesActor",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FPickupPoolReusesAmmoTest::RunTest(const FString& Parameters)
+{
+	FArcoroxTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+	UPickupPoolSubsystem* PickupPool = World->GetSubsystem<UPickupPoolSubsystem>();
+	if (!TestNotNull(TEXT("Pickup pool subsystem"), PickupPool)) return false;
+	AArcoroxCharacter* Character = Cast<AArcoroxCharacter>(TestWorld.SpawnPlayer(FVector(0.f, 0.f, 90.f), AArcoroxCharacter::StaticClass()));
+	if (!TestNotNull(TEXT("Player character"), Character)) return false;
+
+	//Placed like level ammo, never acquired through the pool
+	AAmmo* Ammo = World->SpawnActor<AAmmo>(AAmmo::StaticClass(), FTransform(FVector(300.f, 0.f, 50.f)));
+	if (!TestNotNull(TEXT("Level ammo"), Ammo)) return false;
+	TestWorld.Tick();
+	Character->GetPickupItem(Ammo);
+	TestTrue(TEXT("Picked up ammo kept alive"), IsValid(Ammo));
+	TestTrue(TEXT("Picked up ammo in the pool"), Ammo->IsInPool());
+
+	const FTransform RespawnTransform{ FVector(600.f, 0.f, 50.f) };
+	AItem* Respawned = PickupPool->AcquirePickup(AAmmo::StaticClass(), RespawnTransform);
+	TestEqual(TEXT("Respawned ammo is the picked up actor"), Respawned, static_cast<AItem*>(Ammo));
+	TestFalse(TEXT("Respawned ammo left the pool"), Ammo->IsInPool());
+	TestEqual(TEXT("Respawned ammo state"), Ammo->GetItemState(), EItemState::EIS_Pickup);
+	TestEqual(TEXT("Respawned ammo location"), Ammo->GetActorLocation(), RespawnTransform.GetLocation());
+
+	//A dropped weapon of a class the pool never spawned is recycled too
+	AWeapon* Weapon = World->SpawnActor<AWeapon>(AWeapon::StaticClass(), FTransform(FVector(900.f, 0.f, 50.f)));
+	if (!TestNotNull(TEXT("Level weapon"), Weapon)) return false;
+	PickupPool->ReleasePickup(Weapon);
+	TestTrue(TEXT("Released weapon kept alive"), IsValid(Weapon));
+	TestEqual(TEXT("Reacquired weapon is the released actor"), PickupPool->AcquirePickup(AWeapon::StaticClass(), RespawnTransform), static_cast<AItem*>(Weapon));
+	return true;
+}
+
+#endif
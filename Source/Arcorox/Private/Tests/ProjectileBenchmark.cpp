@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/ProjectileSubsystem.h"
+#include "Tests/ArcoroxTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static const int32 ProjectileBenchmarkCount = 10000;
+static const float ProjectileBenchmarkSpeed = 20000.f;
+static const int32 ProjectileBenchmarkFrames = 300;
+//Half size of the box the enclosed run fires into, even with drag every projectile reaches a wall, the floor or the ceiling in under four seconds
+static const float ProjectileBenchmarkEnclosure = 30000.f;
+//Headless subsystem cost per frame, the average leaves room for the rest of the game thread and the worst stays within one 60 Hz frame
+static const double ProjectileBenchmarkAverageBudgetMs = 4.0;
+static const double ProjectileBenchmarkWorstBudgetMs = 16.0;
+
+/* Subsystem cost of one run */
+struct FProjectileBenchmarkResult
+{
+	double AverageMs = 0.0;
+	double MaxMs = 0.0;
+	int32 NumFlying = 0;
+};
+
+/* Flies the projectiles for the benchmark frames, in open sky or inside a blocking box they all impact, returns false if the subsystem is missing */
+static bool MeasureProjectiles(FAutomationTestBase& Test, UStaticMesh* Mesh, bool bEnclosed, const TCHAR* Label, FProjectileBenchmarkResult& OutResult)
+{
+	FArcoroxTestWorld TestWorld;
+	UProjectileSubsystem* Projectiles = TestWorld.GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	if (!Test.TestNotNull(TEXT("Projectile subsystem"), Projectiles)) return false;
+	if (bEnclosed)
+	{
+		const float Half = ProjectileBenchmarkEnclosure;
+		TestWorld.SpawnBlockingBox(FVector(0.f, 0.f, -50.f), FVector(Half, Half, 50.f));
+		TestWorld.SpawnBlockingBox(FVector(0.f, 0.f, Half + 50.f), FVector(Half, Half, 50.f));
+		TestWorld.SpawnBlockingBox(FVector(Half + 50.f, 0.f, Half * 0.5f), FVector(50.f, Half, Half * 0.5f));
+		TestWorld.SpawnBlockingBox(FVector(-Half - 50.f, 0.f, Half * 0.5f), FVector(50.f, Half, Half * 0.5f));
+		TestWorld.SpawnBlockingBox(FVector(0.f, Half + 50.f, Half * 0.5f), FVector(Half, 50.f, Half * 0.5f));
+		TestWorld.SpawnBlockingBox(FVector(0.f, -Half - 50.f, Half * 0.5f), FVector(Half, 50.f, Half * 0.5f));
+	}
+
+	//Same directions in every run
+	FMath::RandInit(ProjectileBenchmarkCount);
+	Projectiles->SpawnTestProjectiles(ProjectileBenchmarkCount, FVector::ZeroVector, ProjectileBenchmarkSpeed, Mesh);
+	Test.TestEqual(*FString::Printf(TEXT("%s: live projectiles"), Label), Projectiles->GetNumProjectiles(), ProjectileBenchmarkCount);
+	const double FrameMs = TestWorld.Tick(ProjectileBenchmarkFrames);
+	OutResult.AverageMs = Projectiles->GetAverageFrameMs();
+	OutResult.MaxMs = Projectiles->GetMaxFrameMs();
+	OutResult.NumFlying = Projectiles->GetNumProjectiles();
+	Test.AddInfo(FString::Printf(TEXT("%d projectiles, %s: subsystem %.3f ms average, %.3f ms worst, world frame %.3f ms, %d still flying after %d frames"),
+		ProjectileBenchmarkCount, Label, OutResult.AverageMs, OutResult.MaxMs, FrameMs, OutResult.NumFlying, ProjectileBenchmarkFrames));
+	return true;
+}
+
+/* Fails the test when a headless run went over the frame budget */
+static void TestProjectileBudget(FAutomationTestBase& Test, const FProjectileBenchmarkResult& Result, const TCHAR* Label)
+{
+	Test.TestTrue(*FString::Printf(TEXT("%s: average %.3f ms within %.1f ms"), Label, Result.AverageMs, ProjectileBenchmarkAverageBudgetMs), Result.AverageMs <= ProjectileBenchmarkAverageBudgetMs);
+	Test.TestTrue(*FString::Printf(TEXT("%s: worst %.3f ms within %.1f ms"), Label, Result.MaxMs, ProjectileBenchmarkWorstBudgetMs), Result.MaxMs <= ProjectileBenchmarkWorstBudgetMs);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FProjectileBenchmark, "Arcorox.Perf.Combat.Projectiles10000",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FProjectileBenchmark::RunTest(const FString& Parameters)
+{
+	UStaticMesh* Mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!TestNotNull(TEXT("Engine cube"), Mesh)) return false;
+	FArcoroxScopedConsoleVariable Visuals(TEXT("arcorox.Projectile.Visuals"), TEXT("1"));
+
+	//Nothing to hit, all of them stay alive for the whole run
+	FProjectileBenchmarkResult Open;
+	if (!MeasureProjectiles(*this, nullptr, false, TEXT("headless in open sky"), Open)) return false;
+	TestEqual(TEXT("Every projectile sustained"), Open.NumFlying, ProjectileBenchmarkCount);
+	TestProjectileBudget(*this, Open, TEXT("Headless in open sky"));
+
+	//Lifetime outlasts the run, so none left means every projectile was resolved as an impact
+	FProjectileBenchmarkResult Enclosed;
+	if (!MeasureProjectiles(*this, nullptr, true, TEXT("headless impacting"), Enclosed)) return false;
+	TestEqual(TEXT("Every projectile impacted"), Enclosed.NumFlying, 0);
+	TestProjectileBudget(*this, Enclosed, TEXT("Headless impacting"));
+
+	FProjectileBenchmarkResult Drawn;
+	return MeasureProjectiles(*this, Mesh, false, TEXT("drawn in flight"), Drawn);
+}
+
+#endif
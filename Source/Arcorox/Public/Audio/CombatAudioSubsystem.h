@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatAudioSubsystem.generated.h"
+
+class USoundBase;
+class UAudioComponent;
+
+UENUM(BlueprintType)
+enum class ECombatSoundCategory : uint8
+{
+	ECSC_WeaponFire UMETA(DisplayName = "WeaponFire"),
+	ECSC_Impact UMETA(DisplayName = "Impact"),
+	ECSC_Melee UMETA(DisplayName = "Melee"),
+	ECSC_Explosion UMETA(DisplayName = "Explosion"),
+	ECSC_Pickup UMETA(DisplayName = "Pickup"),
+	ECSC_Equip UMETA(DisplayName = "Equip"),
+
+	ECSC_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/* Voice limit, priority and throttle of one sound category */
+USTRUCT(BlueprintType)
+struct FCombatSoundCategorySettings
+{
+	GENERATED_BODY()
+
+	/* Voices of this category playing at once */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxVoices = 4;
+
+	/* Higher priority categories take voices from lower ones when the global limit is reached */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Priority = 1.f;
+
+	/* Minimum seconds between two sounds of this category, 0 never throttles */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MinInterval = 0.f;
+
+	/* Identical sounds requested in the same frame within this distance play once */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MergeRadius = 0.f;
+
+	/* Stop the oldest voice of the category when it is full instead of dropping the new sound */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bStealOldest = false;
+};
+
+/* Single entry point for combat sounds that merges same-frame duplicates, throttles categories and enforces voice limits */
+UCLASS(Config = Game)
+class ARCOROX_API UCombatAudioSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UCombatAudioSubsystem();
+
+	virtual void Deinitialize() override;
+
+	/* Plays Sound in Category at Location, or non-spatialized when b2D, returns false if merged, throttled or out of voices */
+	bool PlayCombatSound(ECombatSoundCategory Category, USoundBase* Sound, const FVector& Location, bool b2D, bool bIgnoreThrottle = false);
+
+	/* Plays through the world's combat audio subsystem, falling back to an unmanaged sound without one */
+	static bool PlayCombatSoundAtLocation(const UObject* WorldContextObject, ECombatSoundCategory Category, USoundBase* Sound, const FVector& Location);
+	static bool PlayCombatSound2D(const UObject* WorldContextObject, ECombatSoundCategory Category, USoundBase* Sound, bool bIgnoreThrottle = false);
+
+	/* Logs requested and played sound totals and the active voices per category */
+	void LogAudioReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FCombatVoice
+	{
+		TWeakObjectPtr<UAudioComponent> Component;
+		float StartTime;
+	};
+
+	struct FFrameSound
+	{
+		USoundBase* Sound;
+		FVector Location;
+	};
+
+	/* Drops voices that finished playing */
+	void PruneVoices(int32 CategoryIndex);
+
+	/* Stops the oldest voice of the lowest priority category below Priority, false if there is none */
+	bool StealVoice(float Priority);
+
+	/* Settings indexed by ECombatSoundCategory */
+	UPROPERTY(Config)
+	TArray<FCombatSoundCategorySettings> Categories;
+
+	/* Combat voices playing at once across all categories */
+	UPROPERTY(Config)
+	int32 MaxVoicesTotal;
+
+	/* Playing voices per category, oldest first */
+	TArray<TArray<FCombatVoice>> Voices;
+
+	/* Last play time per category for throttling */
+	TArray<float> LastPlayTimes;
+
+	/* Sounds played this frame for merging duplicates */
+	TArray<FFrameSound> FrameSounds;
+	uint64 FrameSoundsFrame;
+
+	uint64 NumRequested;
+	uint64 NumPlayed;
+};
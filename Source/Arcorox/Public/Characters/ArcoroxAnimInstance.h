@@ -18,6 +18,24 @@ enum class EOffsetState : uint8
 	EOS_MAX UMETA(DisplayName = "DefaultMAX")
 };
 
+/* Character state the animation update reads, copied from the character on the game thread once per update */
+struct FArcoroxAnimSnapshot
+{
+	FVector Velocity = FVector::ZeroVector;
+	FVector Acceleration = FVector::ZeroVector;
+	FRotator AimRotation = FRotator::ZeroRotator;
+	FRotator ActorRotation = FRotator::ZeroRotator;
+	EWeaponType EquippedWeaponType = EWeaponType::EWT_SubmachineGun;
+	bool bHasWeapon = false;
+	bool bFalling = false;
+	bool bCrouching = false;
+	bool bAiming = false;
+	bool bReloading = false;
+	bool bEquipping = false;
+	bool bShouldUseFABRIK = true;
+	bool bValid = false;
+};
+
 UCLASS()
 class ARCOROX_API UArcoroxAnimInstance : public UAnimInstance
 {
@@ -27,6 +45,10 @@ public:
 	UArcoroxAnimInstance();
 	virtual void NativeInitializeAnimation() override;
 	virtual void NativeUpdateAnimation(float DeltaTime) override;
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaTime) override;
+
+	/* Are animation properties derived on worker threads, off compares the game thread cost */
+	static bool IsThreadSafeUpdateEnabled();
 
 protected:
 	/* Handle turning in place calculations and properties */
@@ -38,6 +60,12 @@ protected:
 private:
 	void SetRecoilScale();
 
+	/* Derives every animation property from Snapshot, safe to run on a worker thread */
+	void UpdateFromSnapshot(float DeltaTime);
+
+	/* Curve value from the last evaluation, readable from a worker thread unlike GetCurveValue */
+	float GetCurveValueAnyThread(const FName& CurveName) const;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	class AArcoroxCharacter* ArcoroxCharacter;
 
@@ -124,4 +152,10 @@ private:
 	/* Character rotation last frame */
 	FRotator CharacterRotationLastFrame;
 
+	/* Character state captured for this update */
+	FArcoroxAnimSnapshot Snapshot;
+
+	/* Was this update already done on the game thread */
+	bool bUpdatedOnGameThread;
+
 };
@@ -19,6 +19,8 @@ class UAnimMontage;
 class AItem;
 class AWeapon;
 class AAmmo;
+struct FArcoroxAnimSnapshot;
+struct FHitZoneMultipliers;
 
 UENUM(BlueprintType)
 enum class ECombatState : uint8
@@ -46,6 +48,38 @@ struct FInterpLocation
 	int32 ItemCount;
 };
 
+USTRUCT(BlueprintType)
+struct FCrosshairQuery
+{
+	GENERATED_BODY()
+
+	/* Did the crosshairs deproject into the world */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	bool bValid = false;
+
+	/* World space start of the crosshair ray */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FVector Start = FVector::ZeroVector;
+
+	/* World space direction of the crosshair ray */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FVector Direction = FVector::ForwardVector;
+
+	/* Blocking hit location, or the end of the ray if nothing was hit */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FVector HitLocation = FVector::ZeroVector;
+
+	/* Result of the crosshair line trace */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	FHitResult HitResult;
+
+	/* Frame the query was computed on */
+	uint64 FrameNumber = 0;
+
+	/* Was the query computed after the camera update at the end of its frame */
+	bool bAfterCameraUpdate = false;
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FEquipItemDelegate, int32, CurrentSlotIndex, int32, NewSlotIndex);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHighlightIconDelegate, int32, InventorySlotIndex, bool, bStartAnimation);
 
@@ -62,8 +96,6 @@ public:
 	virtual void Hit_Implementation(FHitResult HitResult) override;
 	virtual float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, AActor* DamageCauser) override;
 
-	void IncrementOverlappedItemCount(int8 Amount);
-
 	void GetPickupItem(AItem* Item);
 
 	FInterpLocation GetInterpLocation(int32 Index);
@@ -77,9 +109,8 @@ public:
 	/* Decrement item count of specified element of interp locations array */
 	void DecrementInterpLocationItemCount(int32 Index);
 
-	/* Start sound timers */
-	void StartPickupSoundTimer();
-	void StartEquipSoundTimer();
+	/* Copies the state read by the animation update, called once per update on the game thread */
+	void FillAnimSnapshot(FArcoroxAnimSnapshot& OutSnapshot) const;
 
 	/* Broadcasts inventory slot info using delegate to play the highlight icon animation */
 	void HighlightInventorySlot();
@@ -95,17 +126,32 @@ public:
 
 	void Stun(const FHitResult& HitResult);
 
+	/* Crosshair trace shared by item focus, firing and aim features, computed at most once per frame */
+	const FCrosshairQuery& GetCrosshairQuery();
+
+	/* Refreshes the crosshair query, called by the player controller once the camera has updated */
+	void UpdateCrosshairQuery(bool bAfterCameraUpdate);
+
+	/* Does the character need a fresh crosshair query next frame */
+	bool NeedsCrosshairQuery() const;
+
+	/* Applies damage, effects and hit callbacks for a resolved bullet trace */
+	void ApplyBulletHit(const FTransform& SocketTransform, const FHitResult& BeamHitResult, float Damage, const FHitZoneMultipliers& ZoneMultipliers);
+
 	void PlayHitReactMontage(const FHitResult& HitResult);
 
+#if !UE_BUILD_SHIPPING
+	/* Fills the empty inventory slots with default weapons, used to measure a full inventory */
+	void FillInventory();
+#endif
+
 	FORCEINLINE USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	FORCEINLINE UCameraComponent* GetCamera() const { return Camera; }
 	FORCEINLINE bool IsAiming() const { return bAiming; }
-	FORCEINLINE int8 GetOverlappedItemCount() const { return OverlappedItemCount; }
 	FORCEINLINE ECombatState GetCombatState() const { return CombatState; }
 	FORCEINLINE bool IsCrouching() const { return bCrouching; }
-	FORCEINLINE bool ShouldPlayPickupSound() const { return bShouldPlayPickupSound; }
-	FORCEINLINE bool ShouldPlayEquipSound() const { return bShouldPlayEquipSound; }
 	FORCEINLINE AWeapon* GetEquippedWeapon() const { return EquippedWeapon; }
+	FORCEINLINE const TArray<AItem*>& GetInventory() const { return Inventory; }
 	FORCEINLINE float GetStunChance() const { return StunChance; }
 
 protected:
@@ -132,16 +178,16 @@ protected:
 	void FireWeapon();
 	void ReloadWeapon();
 
-	bool GetBeamEndLocation(const FVector& BarrelSocketLocation, FHitResult& OutHit);
+	/* Queues a shot from the equipped weapon barrel with the hitscan subsystem */
 	void SendBullet();
 
 	void ExchangeInventoryItems(int32 CurrentSlotIndex, int32 TargetSlotIndex);
 
-	/* Line trace for items behind the crosshairs*/
-	bool CrosshairLineTrace(FHitResult& OutHit, FVector& OutHitLocation);
+	/* World space ray through the crosshairs, returns false if deprojection fails */
+	bool GetCrosshairRay(FVector& OutStart, FVector& OutDirection);
 	void CalculateCrosshairSpread(float DeltaTime);
 
-	/* Trace for Items if OverlappedItemCount > 0 */
+	/* Focus the nearby pickup closest to the crosshairs using the loot index */
 	void ItemTrace();
 
 	/* Weapon fire timers */
@@ -276,8 +322,6 @@ private:
 	void CameraZoomInterpolation(float DeltaTime);
 	void SetupEnhancedInput();
 	void SetLookScale();
-	void ResetPickupSoundTimer();
-	void ResetEquipSoundTimer();
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	USpringArmComponent* CameraBoom;
@@ -342,6 +386,10 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Crosshairs, meta = (AllowPrivateAccess = "true"))
 	float CrosshairShootingFactor;
 
+	/* Cached crosshair trace for the current frame */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Crosshairs, meta = (AllowPrivateAccess = "true"))
+	FCrosshairQuery CrosshairQuery;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 	AItem* TraceHitItemLastFrame;
 
@@ -357,6 +405,14 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 	AItem* TraceHitItem;
 
+	/* Distance from character within which pickups can be focused */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
+	float ItemFocusRadius;
+
+	/* Half angle in degrees of the cone around the crosshairs in which pickups can be focused */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
+	float ItemFocusConeAngle;
+
 	/* Distance outward from camera for item to interpolate to */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
 	float CameraInterpDistance;
@@ -450,14 +506,6 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	float CameraZoomedFOV;
 
-	/* Time to wait between playing pickup sounds */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
-	float PickupSoundTime;
-
-	/* Time to wait between playing equip sounds */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
-	float EquipSoundTime;
-
 	/* TArray of items for character inventory */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
 	TArray<AItem*> Inventory;
@@ -512,13 +560,4 @@ private:
 	bool bFireButtonPressed;
 	bool bShouldFire;
 	FTimerHandle AutoFireTimer;
-
-	bool bShouldTraceForItems;
-	int8 OverlappedItemCount;
-
-	/* Sound timer properties */
-	FTimerHandle PickupSoundTimer;
-	FTimerHandle EquipSoundTimer;
-	bool bShouldPlayPickupSound;
-	bool bShouldPlayEquipSound;
 };
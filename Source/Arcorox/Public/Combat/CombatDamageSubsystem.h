@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatDamageSubsystem.generated.h"
+
+class AEnemy;
+
+/* A hit on a health slot waiting for the end of frame damage pass */
+struct FQueuedDamage
+{
+	int32 Slot = INDEX_NONE;
+
+	/* Generation of the slot when queued, hits on a slot reused since are dropped */
+	uint32 Generation = 0;
+
+	float Amount = 0.f;
+	TWeakObjectPtr<AActor> Instigator;
+	FVector HitLocation = FVector::ZeroVector;
+	bool bHasHitLocation = false;
+};
+
+/* Collects enemy damage during the frame and resolves it in one pass over a structure-of-arrays health table, then notifies damaged and killed enemies once each */
+UCLASS()
+class ARCOROX_API UCombatDamageSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/* Adds an enemy to the health table with its current health, returns its slot */
+	int32 RegisterEnemy(AEnemy* Enemy);
+
+	/* Frees a slot, hits still queued for it are dropped */
+	void UnregisterEnemy(int32 Slot);
+
+	/* Queues damage without a hit location, returns false when the caller should apply the damage itself */
+	bool QueueDamage(int32 Slot, float Amount, AActor* Instigator);
+
+	/* Queues damage from a hit at HitLocation, which can stun and orients the death montage */
+	bool QueuePointDamage(int32 Slot, float Amount, AActor* Instigator, const FVector& HitLocation);
+
+	/* Overwrites the health of a slot, used when health changes outside the damage pass */
+	void SetHealth(int32 Slot, float InHealth);
+
+	/* Times NumHits through ApplyDamage and through the queue on the registered enemies, restoring their health and targets after, returns false when there is nothing to hit */
+	bool RunBenchmark(int32 NumHits, double& OutUnbatchedUs, double& OutBatchedUs);
+
+	/* Logs slot and hit counts and the average resolve cost */
+	void LogDamageReport() const;
+
+	/* Is enemy damage batched through the health table, checked by callers before queueing */
+	static bool IsBatchEnabled();
+
+	FORCEINLINE int32 GetNumQueued() const { return Queue.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/* Applies every queued hit in order, then notifies survivors in first-hit order and the killed in kill order */
+	void ResolveDamage();
+
+	bool QueueDamageInternal(int32 Slot, float Amount, AActor* Instigator, const FVector& HitLocation, bool bHasHitLocation);
+
+	/* Health table, one entry per slot */
+	TArray<float> Health;
+	TArray<float> MaxHealth;
+	TBitArray<> Dead;
+	TArray<TWeakObjectPtr<AActor>> LastInstigators;
+	TArray<TWeakObjectPtr<AEnemy>> Enemies;
+	TArray<uint32> Generations;
+	TArray<int32> FreeSlots;
+
+	/* Per-slot scratch of the damage pass */
+	TBitArray<> Touched;
+	TArray<uint16> PointHits;
+	TArray<FVector> LastHitLocations;
+
+	TArray<FQueuedDamage> Queue;
+
+	/* Set while benchmarking the unbatched path so TakeDamage applies immediately */
+	bool bBypassQueue = false;
+
+	uint64 NumHits = 0;
+	uint64 NumResolves = 0;
+	double TotalResolveMs = 0.0;
+};
@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Items/Item.h"
+#include "Items/Weapon.h"
+#include "Combat/HitZone.h"
+#include "UObject/ObjectKey.h"
+#include "CombatDataRegistry.generated.h"
+
+class UDataTable;
+struct FReferenceSkeleton;
+
+/* Loads the weapon type, item rarity and hit zone tables once and hands out shared, immutable archetypes indexed by enum and hit zone lookups per mesh */
+UCLASS(Config = Game)
+class ARCOROX_API UCombatDataRegistry : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UCombatDataRegistry();
+
+	virtual void Deinitialize() override;
+
+	/* Registry instance, available in the editor as well as in game worlds */
+	static UCombatDataRegistry* Get();
+
+	/* Shared row for a weapon type, nullptr if the table has no row for it */
+	const FWeaponTypeTable* GetWeaponArchetype(EWeaponType Type);
+
+	/* Shared row for an item rarity, nullptr if the table has no row for it */
+	const FItemRarityTable* GetItemRarityArchetype(EItemRarity Rarity);
+
+	/* Hit zones of a mesh and fallback head bone compiled on first use, FallbackHeadBone is the head zone if its skeleton has no row. The pointer stays valid for the registry lifetime */
+	const FCompiledHitZones* GetHitZones(USkeletalMesh* Mesh, const FName& FallbackHeadBone);
+
+	/* Fills the bone lookup of HitZones from a skeleton's row in one parent-first pass, without a row only the fallback head bone itself is head */
+	static void CompileBoneZones(FCompiledHitZones& HitZones, const FReferenceSkeleton& RefSkeleton, const FHitZoneTable* Row);
+
+	/* Logs the zones, bone counts and per weapon combined multipliers of every compiled mesh */
+	void LogHitZoneReport();
+
+private:
+	/* Loads both tables and builds the enum indexed archetype arrays on first use */
+	void LoadTables();
+
+	/* Copies rows into the archetype arrays in place so handed out pointers stay valid */
+	void IndexWeaponTypeTable();
+	void IndexItemRarityTable();
+
+	/* Builds the bone lookup of a mesh from its skeleton's row, in place */
+	void CompileHitZones(FCompiledHitZones& HitZones);
+
+	/* Recompiles every mesh in place when the hit zone table changes */
+	void RecompileHitZones();
+
+	/* Asset paths of the data tables */
+	UPROPERTY(Config)
+	FSoftObjectPath WeaponTypeDataTablePath;
+
+	UPROPERTY(Config)
+	FSoftObjectPath ItemRarityDataTablePath;
+
+	UPROPERTY(Config)
+	FSoftObjectPath HitZoneDataTablePath;
+
+	UPROPERTY()
+	UDataTable* WeaponTypeDataTable;
+
+	UPROPERTY()
+	UDataTable* ItemRarityDataTable;
+
+	UPROPERTY()
+	UDataTable* HitZoneDataTable;
+
+	/* One archetype per enum value, sized once and never reallocated */
+	UPROPERTY()
+	TArray<FWeaponTypeTable> WeaponArchetypes;
+
+	UPROPERTY()
+	TArray<FItemRarityTable> ItemRarityArchetypes;
+
+	/* Does the table have a row for the enum value at each index */
+	TArray<bool> ValidWeaponArchetypes;
+	TArray<bool> ValidItemRarityArchetypes;
+
+	/* Compiled hit zones per mesh and fallback head bone, enemies sharing a mesh can name different heads. Heap allocated so enemies can hold on to them */
+	TMap<TPair<TObjectKey<USkeletalMesh>, FName>, TUniquePtr<FCompiledHitZones>> CompiledHitZones;
+
+	bool bTablesLoaded;
+};
@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ExplosionSubsystem.generated.h"
+
+class AExplosive;
+
+/* An explosive waiting to go off */
+struct FQueuedDetonation
+{
+	TWeakObjectPtr<AExplosive> Explosive;
+
+	/* Blast center, the hit location for shot explosives */
+	FVector Location = FVector::ZeroVector;
+
+	/* Pawn credited with the damage, carried along the chain */
+	TWeakObjectPtr<APawn> Instigator;
+
+	/* World time the explosive goes off */
+	float DetonateTime = 0.f;
+};
+
+/* Accumulated effect of one wave of explosions on a single actor */
+struct FBlastTarget
+{
+	float Damage = 0.f;
+	FVector Impulse = FVector::ZeroVector;
+	TWeakObjectPtr<APawn> Instigator;
+};
+
+/* Detonates queued explosives in waves, one overlap query per wave, spreading chain reactions across frames */
+UCLASS(Config = Game)
+class ARCOROX_API UExplosionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UExplosionSubsystem();
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterExplosive(AExplosive* Explosive);
+	void UnregisterExplosive(AExplosive* Explosive);
+
+	/* Queues an explosive to go off at Location after Delay seconds, ignored if it is already queued */
+	void QueueDetonation(AExplosive* Explosive, const FVector& Location, APawn* Instigator, float Delay);
+
+	/* Spawns Count copies of an explosive from the level in a grid in front of the player and sets off the first one */
+	void SpawnChainTest(int32 Count, float Spacing);
+
+	/* Logs queue size, wave counts and wave cost */
+	void LogExplosionReport() const;
+
+	FORCEINLINE int32 GetNumQueued() const { return Queue.Num(); }
+	FORCEINLINE uint64 GetNumDetonations() const { return NumDetonations; }
+	FORCEINLINE double GetMaxWaveMs() const { return MaxWaveMs; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/* Detonates up to MaxDetonationsPerFrame due explosives, damages everything in range and queues caught explosives */
+	void ProcessWave();
+
+	/* Gathers damage and impulses of every detonation in the wave from one overlap around all of its blasts */
+	void GatherBlastTargets(const TArray<FQueuedDetonation>& Wave, TMap<AActor*, FBlastTarget>& OutTargets);
+
+	/* Queues registered explosives within Radius of a detonation that the blast reaches */
+	void QueueCaughtExplosives(const FQueuedDetonation& Detonation, float Radius);
+
+	/* Is TargetLocation visible from the blast center without level geometry in between, true without a trace once the wave's trace budget is spent */
+	bool HasLineOfSight(const FQueuedDetonation& Detonation, const FVector& TargetLocation, const AActor* Target);
+
+	/* Applies the accumulated damage and impulses of a wave, one damage event per actor */
+	static void ApplyBlastTargets(const TMap<AActor*, FBlastTarget>& Targets);
+
+	/* Explosives going off per frame, the rest of a chain waits for the next frames */
+	UPROPERTY(Config)
+	int32 MaxDetonationsPerFrame;
+
+	/* Seconds between an explosive being caught in a blast and going off */
+	UPROPERTY(Config)
+	float ChainDelay;
+
+	/* Upward part added to impulse directions so actors lift off the ground */
+	UPROPERTY(Config)
+	float ImpulseUpBias;
+
+	/* Line of sight traces per wave, later blast targets and caught explosives are reached without a trace */
+	UPROPERTY(Config)
+	int32 MaxLineOfSightTracesPerWave;
+
+	/* Traces left in the current wave */
+	int32 LineOfSightTracesLeft;
+
+	TArray<FQueuedDetonation> Queue;
+
+	/* Explosives in the world, tested against each blast for chain reactions */
+	TArray<TWeakObjectPtr<AExplosive>> Explosives;
+
+	uint64 NumWaves;
+	uint64 NumDetonations;
+	double TotalWaveMs;
+	double MaxWaveMs;
+};
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+#include "HitZone.generated.h"
+
+class USkeleton;
+class USkeletalMesh;
+
+UENUM(BlueprintType)
+enum class EHitZone : uint8
+{
+	EHZ_Head UMETA(DisplayName = "Head"),
+	EHZ_Torso UMETA(DisplayName = "Torso"),
+	EHZ_Arms UMETA(DisplayName = "Arms"),
+	EHZ_Legs UMETA(DisplayName = "Legs"),
+
+	EHZ_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/* Hit zones of one skeleton, each listed bone starts a zone its child bones inherit, unlisted bones are torso */
+USTRUCT(BlueprintType)
+struct FHitZoneTable : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSoftObjectPtr<USkeleton> Skeleton;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FName> HeadBones;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FName> ArmBones;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FName> LegBones;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float HeadMultiplier = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float TorsoMultiplier = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ArmMultiplier = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float LegMultiplier = 1.f;
+};
+
+/* Damage multiplier per hit zone, used for the weapon side of a hit */
+struct FHitZoneMultipliers
+{
+	float Multipliers[static_cast<int32>(EHitZone::EHZ_MAX)] = { 1.f, 1.f, 1.f, 1.f };
+
+	FORCEINLINE float Get(EHitZone Zone) const { return Multipliers[static_cast<int32>(Zone)]; }
+	FORCEINLINE void Set(EHitZone Zone, float Multiplier) { Multipliers[static_cast<int32>(Zone)] = Multiplier; }
+};
+
+/* Zone and skeleton multiplier of one bone */
+struct FHitZoneBone
+{
+	EHitZone Zone = EHitZone::EHZ_Torso;
+	float Multiplier = 1.f;
+};
+
+/* Hit zones of a skeletal mesh compiled into a lookup indexed by bone index */
+struct FCompiledHitZones
+{
+	TWeakObjectPtr<USkeletalMesh> Mesh;
+
+	/* Head bone used when the skeleton has no hit zone row */
+	FName FallbackHeadBone;
+
+	/* Skeleton multiplier of each zone */
+	FHitZoneMultipliers ZoneMultipliers;
+
+	/* One entry per bone of the mesh reference skeleton */
+	TArray<FHitZoneBone> Bones;
+
+	/* Does the skeleton have a row in the hit zone table */
+	bool bFromTable = false;
+
+	/* Combined skeleton and weapon multiplier of a bone, bones outside the mesh count as torso */
+	FORCEINLINE float GetMultiplier(int32 BoneIndex, const FHitZoneMultipliers& WeaponMultipliers, EHitZone& OutZone) const
+	{
+		if (!Bones.IsValidIndex(BoneIndex))
+		{
+			OutZone = EHitZone::EHZ_Torso;
+			return ZoneMultipliers.Get(OutZone) * WeaponMultipliers.Get(OutZone);
+		}
+		const FHitZoneBone& Bone = Bones[BoneIndex];
+		OutZone = Bone.Zone;
+		return Bone.Multiplier * WeaponMultipliers.Get(Bone.Zone);
+	}
+};
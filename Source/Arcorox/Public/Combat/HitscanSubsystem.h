@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "Combat/HitZone.h"
+#include "HitscanSubsystem.generated.h"
+
+class AArcoroxCharacter;
+
+/* A single fired bullet waiting on its barrel trace */
+struct FHitscanShot
+{
+	/* Character that fired the shot */
+	TWeakObjectPtr<AArcoroxCharacter> Shooter;
+
+	/* Barrel socket transform of the weapon when the shot was fired */
+	FTransform SocketTransform;
+
+	/* Point the barrel trace aims at, taken from the shooter's crosshair query */
+	FVector BeamEnd = FVector::ZeroVector;
+
+	/* Weapon values captured at fire time in case the weapon changes before the traces resolve */
+	float Damage = 0.f;
+	FHitZoneMultipliers ZoneMultipliers;
+};
+
+/* Queues hitscan shots from every shooter and resolves them together through async scene queries */
+UCLASS()
+class ARCOROX_API UHitscanSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/* Queue a shot to be traced; resolves immediately when async traces are disabled */
+	void QueueShot(const FHitscanShot& Shot);
+
+	/* Synchronous barrel trace toward the shot's beam end */
+	static void TraceBarrel(UWorld* World, const FHitscanShot& Shot, FHitResult& OutHit);
+
+	/* Same barrel trace submitted as an async scene query, Delegate receives UserData with the result */
+	static FTraceHandle SubmitBarrelTrace(UWorld* World, const FHitscanShot& Shot, FTraceDelegate* Delegate, uint32 UserData);
+
+	/* Are shots resolved through async scene queries */
+	static bool IsAsyncEnabled();
+
+	FORCEINLINE int32 GetNumPendingShots() const { return PendingShots.Num() + InFlightShots.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/* Submits all shots queued this frame as one batch of barrel traces */
+	void SubmitPendingShots();
+
+	/* Async trace callback */
+	void OnBarrelTraceComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/* End point of the barrel trace for a shot with a resolved beam end */
+	static FVector GetBarrelTraceEnd(const FHitscanShot& Shot);
+
+	/* Resolves a finished shot by handing the barrel hit back to its shooter */
+	static void ApplyShot(const FHitscanShot& Shot, const FHitResult& BeamHitResult, bool bBlockingHit);
+
+	/* Shots queued this frame, submitted on the next subsystem tick */
+	TArray<FHitscanShot> PendingShots;
+
+	/* Shots waiting on a trace result, keyed by the trace user data */
+	TMap<uint32, FHitscanShot> InFlightShots;
+
+	FTraceDelegate BarrelTraceDelegate;
+
+	/* Id handed to the next in flight shot */
+	uint32 NextShotId = 1;
+};
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "MeleeSweepSubsystem.generated.h"
+
+class AEnemy;
+
+/* One open attack window of an enemy weapon */
+struct FMeleeSwing
+{
+	TWeakObjectPtr<AEnemy> Attacker;
+
+	/* Mesh sockets at the grip and tip of the weapon, the swept capsule spans them */
+	FName BaseSocket;
+	FName TipSocket;
+	float Radius = 0.f;
+
+	/* Socket locations at the previous sweep */
+	FVector PreviousBase = FVector::ZeroVector;
+	FVector PreviousTip = FVector::ZeroVector;
+
+	/* Actors already hit during this swing */
+	TArray<TWeakObjectPtr<AActor>, TInlineAllocator<2>> HitActors;
+
+	/* Sweeps submitted and not yet resolved */
+	int32 NumInFlight = 0;
+
+	/* Is the attack window still open */
+	bool bOpen = true;
+};
+
+/* Sweeps the weapons of every attacking enemy between frames as one batch of scene queries, hitting each target once per swing */
+UCLASS()
+class ARCOROX_API UMeleeSweepSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/* Opens an attack window sweeping a capsule of Radius between BaseSocket and TipSocket, returns the swing id */
+	uint32 BeginSwing(AEnemy* Attacker, const FName& BaseSocket, const FName& TipSocket, float Radius);
+
+	/* Closes an attack window, sweeps already in flight still resolve */
+	void EndSwing(uint32 SwingId);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/* Submits sweeps per open swing from the previous to the current socket locations, one per angular step of the blade */
+	void SubmitSweeps();
+
+	/* Async sweep callback */
+	void OnSweepComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/* Hands the first hit on each new player to the attacker */
+	void ApplyHits(uint32 SwingId, const TArray<FHitResult>& Hits);
+
+	/* Capsule placement for a weapon spanning Base to Tip */
+	static void GetWeaponCapsule(const FVector& Base, const FVector& Tip, float Radius, FVector& OutCenter, FQuat& OutRotation, FCollisionShape& OutShape);
+
+	TMap<uint32, FMeleeSwing> Swings;
+
+	FTraceDelegate SweepDelegate;
+
+	/* Id handed to the next swing */
+	uint32 NextSwingId = 1;
+};
@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "Combat/HitZone.h"
+#include "ProjectileSubsystem.generated.h"
+
+class AArcoroxCharacter;
+class UStaticMesh;
+class UInstancedStaticMeshComponent;
+struct FWeaponTypeTable;
+
+/* Per-projectile data only read on impact, kept apart from the integrated arrays */
+struct FProjectileInfo
+{
+	TWeakObjectPtr<AArcoroxCharacter> Shooter;
+	float Damage = 0.f;
+	FHitZoneMultipliers ZoneMultipliers;
+};
+
+/* Simulates bullets of projectile weapons in contiguous structure-of-arrays storage, integrating four at a time and tracing their paths as one async batch per frame */
+UCLASS(Config = Game)
+class ARCOROX_API UProjectileSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UProjectileSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/* Fires a projectile of a weapon from the barrel toward Target, returns false when the projectile limit is reached */
+	bool FireProjectile(AArcoroxCharacter* Shooter, const FTransform& SocketTransform, const FVector& Target, float Damage, const FHitZoneMultipliers& ZoneMultipliers, const FWeaponTypeTable& Weapon);
+
+	/* Adds Count projectiles without a shooter flying in random upward directions from Origin, for load testing, Mesh is drawn in flight when set */
+	void SpawnTestProjectiles(int32 Count, const FVector& Origin, float Speed, UStaticMesh* Mesh = nullptr);
+
+	/* Logs live projectiles and the average and worst frame cost */
+	void LogProjectileReport() const;
+
+	FORCEINLINE int32 GetNumProjectiles() const { return PositionX.Num(); }
+	FORCEINLINE double GetAverageFrameMs() const { return NumFrames > 0 ? TotalFrameMs / NumFrames : 0.0; }
+	FORCEINLINE double GetMaxFrameMs() const { return MaxFrameMs; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/* Appends a projectile to every array */
+	void AddProjectile(const FVector& Location, const FVector& Velocity, float GravityZ, float Drag, float Lifetime, UStaticMesh* Mesh, FProjectileInfo&& Info);
+
+	/* Applies the impacts found by the previous traces and marks those projectiles dead */
+	void ResolveImpacts();
+
+	/* Swap-removes dead projectiles and expired ones whose last segment was traced from every array */
+	void RemoveDeadProjectiles();
+
+	/* Advances every projectile by fixed substeps, four lanes at a time, the last step of each ends at its lifetime */
+	void Integrate(float DeltaTime);
+
+	/* Traces each projectile from where it was last traced to where it is now, within the frame budget */
+	void SubmitTraces();
+
+	/* Async trace callback */
+	void OnTraceComplete(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/* Instanced mesh drawing every projectile of Mesh in flight, created on first use, INDEX_NONE when nothing is drawn */
+	int32 GetVisualGroup(UStaticMesh* Mesh);
+
+	/* Moves one mesh instance to each live projectile, facing along its velocity */
+	void UpdateVisuals();
+
+	/* Projectiles alive at once, further shots fall back to hitscan */
+	UPROPERTY(Config)
+	int32 MaxProjectiles;
+
+	/* Seconds per integration substep */
+	UPROPERTY(Config)
+	float SubstepTime;
+
+	/* Substeps per frame at most, slower frames take longer substeps */
+	UPROPERTY(Config)
+	int32 MaxSubsteps;
+
+	/* Game thread milliseconds per frame for trace submission, untraced projectiles trace their longer path next frame */
+	UPROPERTY(Config)
+	float TraceBudgetMs;
+
+	/* Integrated state, one entry per live projectile in every array */
+	TArray<float> PositionX;
+	TArray<float> PositionY;
+	TArray<float> PositionZ;
+	TArray<float> VelocityX;
+	TArray<float> VelocityY;
+	TArray<float> VelocityZ;
+	TArray<float> GravityZ;
+	TArray<float> Drag;
+	TArray<float> Age;
+	TArray<float> Lifetime;
+
+	/* Instanced mesh of each projectile, INDEX_NONE for none */
+	TArray<int32> VisualGroups;
+
+	/* End of the last traced segment of each projectile */
+	TArray<FVector> TraceStarts;
+
+	TArray<FProjectileInfo> Infos;
+	TArray<bool> Dead;
+
+	/* Blocking hits of the last traces by projectile index, indices stay valid until RemoveDeadProjectiles */
+	TMap<int32, FHitResult> PendingImpacts;
+
+	FTraceDelegate TraceDelegate;
+
+	/* One instanced mesh per projectile mesh, with the instance transforms of this frame */
+	UPROPERTY()
+	TArray<UInstancedStaticMeshComponent*> VisualComponents;
+	TArray<TArray<FTransform>> VisualTransforms;
+
+	/* Unspent frame time carried into the next frame's substeps */
+	float SubstepRemainder;
+
+	/* Next projectile to trace, carried across frames when the budget runs out */
+	int32 TraceCursor;
+
+	uint64 NumFrames;
+	uint64 NumTraces;
+	double TotalFrameMs;
+	double MaxFrameMs;
+};
@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatFXSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+UENUM(BlueprintType)
+enum class ECombatFXType : uint8
+{
+	ECFX_MuzzleFlash UMETA(DisplayName = "MuzzleFlash"),
+	ECFX_Beam UMETA(DisplayName = "Beam"),
+	ECFX_Impact UMETA(DisplayName = "Impact"),
+	ECFX_Blood UMETA(DisplayName = "Blood"),
+	ECFX_Explosion UMETA(DisplayName = "Explosion"),
+
+	ECFX_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/* Pool size and budget of one effect type */
+USTRUCT(BlueprintType)
+struct FCombatFXBudget
+{
+	GENERATED_BODY()
+
+	/* Components created when the world begins play */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 PrewarmCount = 0;
+
+	/* Effects of this type playing at once, the oldest and farthest is recycled beyond it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxActive = 8;
+
+	/* Effects farther than this from the view are not played, 0 never culls */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float CullDistance = 0.f;
+};
+
+/* Plays combat particle effects from pre-warmed component pools per effect type under per-type and global budgets */
+UCLASS(Config = Game)
+class ARCOROX_API UCombatFXSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UCombatFXSubsystem();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/* Plays Template at Transform from the pool of Type, returns null when culled */
+	UParticleSystemComponent* SpawnEffect(ECombatFXType Type, UParticleSystem* Template, const FTransform& Transform);
+
+	/* Plays through the world's combat FX subsystem, falling back to a plain emitter spawn without one */
+	static UParticleSystemComponent* SpawnEffectAt(const UObject* WorldContextObject, ECombatFXType Type, UParticleSystem* Template, const FTransform& Transform);
+
+	/* Logs pooled and active components per type */
+	void LogFXReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FCombatFXSlot
+	{
+		UParticleSystemComponent* Component;
+		float StartTime;
+		bool bActive;
+	};
+
+	struct FCombatFXPool
+	{
+		TArray<FCombatFXSlot> Slots;
+		int32 NumActive = 0;
+	};
+
+	/* Creates and registers an inactive pooled component */
+	int32 AddSlot(int32 TypeIndex);
+
+	/* Active slot in Type with the highest age and distance score, INDEX_NONE if nothing is active */
+	int32 FindCullVictim(int32 TypeIndex, const FVector& ViewLocation, float Now, float& OutScore) const;
+
+	/* Stops a slot and returns it to its pool */
+	void DeactivateSlot(int32 TypeIndex, int32 SlotIndex);
+
+	UFUNCTION()
+	void OnEffectFinished(UParticleSystemComponent* Component);
+
+	/* Budgets indexed by ECombatFXType */
+	UPROPERTY(Config)
+	TArray<FCombatFXBudget> Budgets;
+
+	/* Effects of all types playing at once */
+	UPROPERTY(Config)
+	int32 MaxActiveTotal;
+
+	/* Weight of one unit of distance from the view against one second of age when picking an effect to recycle */
+	UPROPERTY(Config)
+	float CullDistanceWeight;
+
+	/* Keeps every pooled component referenced */
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> Components;
+
+	TArray<FCombatFXPool> Pools;
+
+	/* Pool type and slot of each component for the finished callback */
+	TMap<UParticleSystemComponent*, FIntPoint> ComponentSlots;
+
+	int32 NumActiveTotal;
+};
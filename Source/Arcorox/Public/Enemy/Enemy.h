@@ -9,11 +9,15 @@
 
 class UParticleSystem;
 class UAnimMontage;
-class USphereComponent;
-class UBoxComponent;
 class AEnemyController;
 class UBehaviorTree;
 class AArcoroxCharacter;
+class UUserWidget;
+struct FEnemySignificanceTier;
+struct FEnemyAnimSnapshot;
+struct FCompiledHitZones;
+struct FHitZoneMultipliers;
+enum class EHitZone : uint8;
 
 UCLASS()
 class ARCOROX_API AEnemy : public ACharacter, public IHitInterface
@@ -21,37 +25,105 @@ class ARCOROX_API AEnemy : public ACharacter, public IHitInterface
 	GENERATED_BODY()
 
 public:
-	AEnemy();
+	AEnemy(const FObjectInitializer& ObjectInitializer);
 
-	virtual void Tick(float DeltaTime) override;
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	virtual void Hit_Implementation(FHitResult HitResult) override;
 	virtual float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, class AController* EventInstigator, AActor* DamageCauser) override;
 
+	/* Called instead of the HUD damage numbers while the HUD has no damage number class, the Blueprint creates the widget and passes it to StoreHitDamage */
 	UFUNCTION(BlueprintImplementableEvent)
 	void ShowHitDamage(int32 Damage, FVector HitLocation, bool bHeadshot);
 
-	FORCEINLINE FString GetHeadBone() const { return HeadBone; }
+	FORCEINLINE FName GetHeadBone() const { return HeadBone; }
+	FORCEINLINE float GetHealthFraction() const { return MaxHealth > 0.f ? Health / MaxHealth : 0.f; }
+	FORCEINLINE float GetHealth() const { return Health; }
+	FORCEINLINE float GetMaxHealth() const { return MaxHealth; }
+	FORCEINLINE bool IsDead() const { return bDead; }
+	FORCEINLINE bool IsInPool() const { return bInPool; }
 	FORCEINLINE UBehaviorTree* GetBehaviorTree() const { return BehaviorTree; }
+	FORCEINLINE float GetAggroRadius() const { return AggroRadius; }
+	FORCEINLINE float GetAttackRangeRadius() const { return AttackRangeRadius; }
+	FORCEINLINE bool ShouldUpdateProximity() const { return bUpdateProximity; }
+	FORCEINLINE bool IsInAttackRange() const { return bInAttackRange; }
+	FORCEINLINE void SetAnimationBudgeted(bool bBudgeted) { bAnimationBudgeted = bBudgeted; }
+	FORCEINLINE void SetBehaviorTree(UBehaviorTree* Tree) { BehaviorTree = Tree; }
+	FORCEINLINE int32 GetHealthSlot() const { return HealthSlot; }
+
+	/* Does damage to this enemy go through the health table of the combat damage subsystem */
+	bool UsesBatchedDamage() const;
+
+	/* Sets health outside of damage, keeping the health table in sync */
+	void SetHealth(float InHealth);
+
+	/* Called once per frame by the combat damage subsystem for a damaged enemy that survived, NumPointHits hits can stun */
+	void ApplyResolvedDamage(float NewHealth, AActor* DamageInstigator, int32 NumPointHits, const FVector& HitLocation);
+
+	/* Called by the combat damage subsystem, in kill order, for an enemy whose health reached 0 this frame */
+	void ApplyResolvedDeath(AActor* DamageInstigator, bool bHasHitLocation, const FVector& HitLocation);
+
+	/* Damage multiplier of the hit zone containing BoneName combined with the weapon's multiplier for that zone */
+	float GetHitZoneMultiplier(const FName& BoneName, const FHitZoneMultipliers& WeaponMultipliers, EHitZone& OutZone) const;
+
+	/* Is the attack montage playing */
+	bool IsAttacking() const;
+
+	/* Copies the state read by the animation update, called once per update on the game thread */
+	void FillAnimSnapshot(FEnemyAnimSnapshot& OutSnapshot) const;
+
+	/* Applies the tick rates and proximity settings of a significance tier */
+	void ApplySignificanceTier(const FEnemySignificanceTier& Tier);
+
+	/* Does the enemy have a target on its blackboard */
+	bool HasTarget() const;
+
+	/* Plays a random attack section and starts the attack delay, called by the behavior tree or the native brain */
+	UFUNCTION(BlueprintCallable)
+	void PlayAttackMontage(float PlayRate = 1.f);
+
+	/* Called by the melee sweep subsystem the first time a swing of the weapon at WeaponSocket hits a character */
+	void ApplyMeleeHit(AArcoroxCharacter* ArcoroxCharacter, const FName& WeaponSocket, const FHitResult& HitResult);
+
+	/* Called by the proximity subsystem when a player enters or leaves AttackRangeRadius */
+	void SetInAttackRange(bool InRange);
+
+	/* Writes the blackboard target, used by the proximity subsystem on aggro and to carry aggro over when promoted from the horde */
+	void SetTarget(AActor* Target);
+	AActor* GetTarget() const;
+
+	/* Carries horde agent state into a deferred spawn, must be called before FinishSpawning */
+	void SetHordeState(float InHealth, const FVector& WorldPatrolPoint, const FVector& WorldPatrolPoint2);
+
+	/* Patrol points in world space */
+	void GetWorldPatrolPoints(FVector& OutPatrolPoint, FVector& OutPatrolPoint2) const;
+
+	/* Hides the enemy and stops its timers, montages, movement, collision and behavior tree while it waits in the enemy pool */
+	void DeactivateForPool();
+
+	/* Resets a pooled enemy to a freshly spawned state at Transform, patrol points are in world space */
+	void ActivateFromPool(const FTransform& Transform, float InHealth, const FVector& WorldPatrolPoint, const FVector& WorldPatrolPoint2);
 
 protected:
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/* Shows the health bar in the HUD health bar layer for HealthBarDisplayTime, Blueprint overrides should call the parent instead of creating a widget */
 	UFUNCTION(BlueprintNativeEvent)
 	void ShowHealthBar();
+	void ShowHealthBar_Implementation();
 
-	UFUNCTION(BlueprintImplementableEvent)
+	UFUNCTION(BlueprintNativeEvent)
 	void HideHealthBar();
+	void HideHealthBar_Implementation();
 
+	/* Hands a widget created in ShowHitDamage to the HUD, which positions it with the damage numbers and removes it when it expires */
 	UFUNCTION(BlueprintCallable)
 	void StoreHitDamage(UUserWidget* Widget, FVector Location);
 
 	UFUNCTION(BlueprintCallable)
 	void SetStunned(bool Stunned);
 
-	UFUNCTION(BlueprintCallable)
-	void PlayAttackMontage(float PlayRate = 1.f);
-
 	UFUNCTION(BlueprintCallable)
 	void ActivateLeftWeapon();
 
@@ -67,49 +139,23 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	void FinishDeath();
 
-	UFUNCTION()
-	void DestroyHitDamage(UUserWidget* HitDamage);
-
-	/* Called when an actor overlaps with AggroSphere */
-	UFUNCTION()
-	void AggroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
-	/* Called when an actor overlaps with AttackRangeSphere */
-	UFUNCTION()
-	void AttackRangeSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
-	/* Called when actor stops overlapping with AttackRangeSphere */
-	UFUNCTION()
-	void AttackRangeSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
-
-	/* Called when actor overlaps with LeftWeaponBox */
-	UFUNCTION()
-	void LeftWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
-	/* Called when actor overlaps with RightWeaponBox */
-	UFUNCTION()
-	void RightWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
 	UFUNCTION()
 	void DestroyEnemy();
 
-	void ShowHealthBar_Implementation();
-
-	void SetInAttackRange(bool InRange);
-
 	/* Called when Health reaches 0 */
 	void Die(const FHitResult& HitResult);
 	void Die();
 
 	void ResetHitReactTimer();
 
-	void UpdateHitDamages();
-
 	/* Attempt to stun character on hit */
 	void StunCharacter(AArcoroxCharacter* Character, const FHitResult& HitResult);
 
 	void ResetAttackTimer();
 
+	/* Writes the initial blackboard values and runs the behavior tree */
+	void StartBehavior();
+
 private:	
 	void PlayImpactSound();
 	void SpawnImpactParticles(FHitResult& HitResult);
@@ -135,9 +181,9 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	USoundBase* ImpactSound;
 
-	/* Name of head bone on skeleton for headshot damage functionality */
+	/* Name of head bone on skeleton, used as the head zone when the skeleton has no row in the hit zone table */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	FString HeadBone;
+	FName HeadBone;
 
 	/* Hit React animation montage */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -167,21 +213,13 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float MaxHitReactTime;
 
-	/* Map of Hit Damage widgets and their locations */
-	UPROPERTY(VisibleAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	TMap<UUserWidget*, FVector> HitDamages;
-
-	/* How long Hit Damage widgets will persist on screen */
-	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	float HitDamageDestroyTime;
-
-	/* Overlap sphere for Enemy to become hostile toward player */
+	/* Distance at which Enemy becomes hostile toward player */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	USphereComponent* AggroSphere;
+	float AggroRadius;
 
-	/* Overlap sphere for Enemy to attack player */
+	/* Distance at which Enemy attacks player */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	USphereComponent* AttackRangeSphere;
+	float AttackRangeRadius;
 
 	/* Is Enemy playing hit react animation */
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -195,13 +233,17 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	bool bInAttackRange;
 
-	/* Collision volume for left weapon */
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	UBoxComponent* LeftWeaponBox;
+	/* Radius of the capsule swept along each weapon during an attack window */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float WeaponSweepRadius;
 
-	/* Collision volume for right weapon */
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	UBoxComponent* RightWeaponBox;
+	/* Name of left weapon grip socket, the swept capsule spans it and LeftWeaponSocket */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	FName LeftWeaponBaseSocket;
+
+	/* Name of right weapon grip socket, the swept capsule spans it and RightWeaponSocket */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	FName RightWeaponBaseSocket;
 
 	/* How much damage the Enemy inflicts per weapon hit */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -231,6 +273,10 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Behavior Tree", meta = (AllowPrivateAccess = "true"))
 	UBehaviorTree* BehaviorTree;
 
+	/* Drive the enemy with the native state machine of the brain subsystem instead of BehaviorTree */
+	UPROPERTY(EditAnywhere, Category = "Behavior Tree", meta = (AllowPrivateAccess = "true"))
+	bool bUseNativeBrain;
+
 	/* Location for Enemy to patrol to */
 	UPROPERTY(EditAnywhere, Category = "Behavior Tree", meta = (AllowPrivateAccess = "true", MakeEditWidget = "true"))
 	FVector PatrolPoint;
@@ -242,9 +288,6 @@ private:
 	/* Pointer to Enemy AI Controller instance */
 	AEnemyController* EnemyController;
 
-	/* FTimerHandle for displaying the Health Bar */
-	FTimerHandle HealthBarDisplayTimer;
-
 	/* FTimerHandle for hit react delay */
 	FTimerHandle HitReactTimer;
 
@@ -254,9 +297,28 @@ private:
 	/* FTimerHandle for death destroy delay */
 	FTimerHandle DestroyTimer;
 
+	/* Open melee sweep swings of each weapon, 0 when the weapon is inactive */
+	uint32 LeftSwingId;
+	uint32 RightSwingId;
+
 	/* Can the Hit React montage be played */
 	bool bCanHitReact;
 
 	/* Is Enemy dead */
 	bool bDead;
+
+	/* Is Enemy deactivated in the enemy pool */
+	bool bInPool;
+
+	/* Does the proximity subsystem evaluate aggro and attack range, set by the significance tier */
+	bool bUpdateProximity;
+
+	/* Is the mesh update rate driven by the animation budget allocator instead of the significance tier */
+	bool bAnimationBudgeted;
+
+	/* Slot in the health table of the combat damage subsystem, INDEX_NONE when not registered */
+	int32 HealthSlot;
+
+	/* Bone index to hit zone lookup of the mesh, shared by every enemy using it */
+	const FCompiledHitZones* HitZones;
 };
@@ -9,6 +9,13 @@
 class AEnemy;
 class UCharacterMovementComponent;
 
+/* Enemy state the animation update reads, copied from the enemy on the game thread once per update */
+struct FEnemyAnimSnapshot
+{
+	FVector Velocity = FVector::ZeroVector;
+	bool bValid = false;
+};
+
 UCLASS()
 class ARCOROX_API UEnemyAnimInstance : public UAnimInstance
 {
@@ -19,11 +26,15 @@ public:
 
 	virtual void NativeInitializeAnimation() override;
 	virtual void NativeUpdateAnimation(float DeltaTime) override;
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaTime) override;
 
 protected:
 
 
 private:
+	/* Derives the animation properties from Snapshot, safe to run on a worker thread */
+	void UpdateFromSnapshot();
+
 	/* Enemy instance reference */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	AEnemy* Enemy;
@@ -36,4 +47,9 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	float Speed;
 
+	/* Enemy state captured for this update */
+	FEnemyAnimSnapshot Snapshot;
+
+	/* Was this update already done on the game thread */
+	bool bUpdatedOnGameThread;
 };
@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyBrainSubsystem.generated.h"
+
+class AEnemyController;
+
+UENUM(BlueprintType)
+enum class EEnemyBrainState : uint8
+{
+	EEBS_Patrol UMETA(DisplayName = "Patrol"),
+	EEBS_Chase UMETA(DisplayName = "Chase"),
+	EEBS_Attack UMETA(DisplayName = "Attack"),
+	EEBS_Stunned UMETA(DisplayName = "Stunned"),
+	EEBS_Dead UMETA(DisplayName = "Dead"),
+
+	EEBS_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/* Native replacement for the enemy blackboard and the state of its behavior tree */
+struct FEnemyBrain
+{
+	TWeakObjectPtr<AActor> Target;
+	FVector PatrolPoints[2] = { FVector::ZeroVector, FVector::ZeroVector };
+	float StateStartTime = 0.f;
+	float LastUpdateTime = 0.f;
+	float UpdateInterval = 0.f;
+	EEnemyBrainState State = EEnemyBrainState::EEBS_Patrol;
+	uint8 PatrolIndex = 0;
+	uint8 bRunning : 1;
+	uint8 bMoveRequested : 1;
+	uint8 bCanAttack : 1;
+	uint8 bInAttackRange : 1;
+	uint8 bStunned : 1;
+	uint8 bDead : 1;
+	uint8 bPlayerDead : 1;
+
+	FEnemyBrain() : bRunning(false), bMoveRequested(false), bCanAttack(true), bInAttackRange(false), bStunned(false), bDead(false), bPlayerDead(false) {}
+};
+
+/* Runs the native patrol, chase, attack, stunned and dead state machine of enemies round robin within a per-frame time budget */
+UCLASS(Config = Game)
+class ARCOROX_API UEnemyBrainSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyBrainSubsystem();
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterController(AEnemyController* Controller);
+	void UnregisterController(AEnemyController* Controller);
+
+	/* Logs native and behavior tree enemy counts and the native update cost */
+	void LogBrainReport() const;
+
+	FORCEINLINE float GetAcceptanceRadius() const { return AcceptanceRadius; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/* Advances the state machine of one enemy */
+	void UpdateBrain(AEnemyController* Controller, float Now);
+
+	/* Microseconds of game thread time spent on native brains per frame, at least one brain updates every frame */
+	UPROPERTY(Config)
+	float BudgetMicroseconds;
+
+	/* Distance at which a patrol point or target is reached */
+	UPROPERTY(Config)
+	float AcceptanceRadius;
+
+	/* Stunned enemies recover after this many seconds if nothing cleared the flag */
+	UPROPERTY(Config)
+	float MaxStunnedTime;
+
+	TArray<TWeakObjectPtr<AEnemyController>> Controllers;
+
+	/* Next controller to update, carried across frames */
+	int32 Cursor;
+
+	uint64 NumUpdates;
+	uint64 NumFrames;
+	double TotalUpdateMs;
+	int32 LastFrameUpdates;
+};
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+#include "Enemy/EnemyBrainSubsystem.h"
 #include "EnemyController.generated.h"
 
 class UBlackboardComponent;
@@ -19,13 +21,43 @@ public:
 
 	virtual void OnPossess(APawn* InPawn) override;
 
+	/* Switches between the behavior tree and the native brain, must be called before the state setters */
+	void SetUseNativeBrain(bool bNative);
+
+	/* Registers the native brain with the brain subsystem */
+	void StartNativeBrain();
+	void StopNativeBrain();
+
+	/* Minimum seconds between native brain updates */
+	void SetBrainUpdateInterval(float Interval);
+
+	/* Typed blackboard access through key IDs resolved on possess, writes of unchanged values are skipped, with the native brain the state lives in Brain instead */
+	void SetTarget(AActor* Target);
+	AActor* GetTarget() const;
+	void SetStunned(bool bStunned);
+	void SetInAttackRange(bool bInAttackRange);
+	void SetCanAttack(bool bCanAttack);
+	void SetDead(bool bDead);
+	void SetPlayerDead(bool bPlayerDead);
+	void SetPatrolPoints(const FVector& PatrolPoint, const FVector& PatrolPoint2);
+	bool GetPatrolPoints(FVector& OutPatrolPoint, FVector& OutPatrolPoint2) const;
+
 	FORCEINLINE UBlackboardComponent* GetBlackboardComponent() const { return BlackboardComponent; }
 	FORCEINLINE UBehaviorTreeComponent* GetBehaviorTreeComponent() const { return BehaviorTreeComponent; }
+	FORCEINLINE bool UsesNativeBrain() const { return bUseNativeBrain; }
+	FORCEINLINE FEnemyBrain& GetBrain() { return Brain; }
+	FORCEINLINE uint32 GetNumBlackboardWrites() const { return NumBlackboardWrites; }
+	FORCEINLINE uint32 GetNumBlackboardWritesSkipped() const { return NumBlackboardWritesSkipped; }
 
 protected:
 
 
 private:
+	/* Resolves the key IDs of the enemy blackboard once it is initialized */
+	void CacheBlackboardKeys();
+
+	void SetBoolValue(FBlackboard::FKey Key, bool bValue);
+
 	/* Enemy AI Blackboard component */
 	UPROPERTY(BlueprintReadWrite, Category = "AI Behavior", meta = (AllowPrivateAccess = "true"))
 	UBlackboardComponent* BlackboardComponent;
@@ -34,4 +66,23 @@ private:
 	UPROPERTY(BlueprintReadWrite, Category = "AI Behavior", meta = (AllowPrivateAccess = "true"))
 	UBehaviorTreeComponent* BehaviorTreeComponent;
 
+	/* Blackboard key IDs */
+	FBlackboard::FKey TargetKey;
+	FBlackboard::FKey PatrolPointKey;
+	FBlackboard::FKey PatrolPoint2Key;
+	FBlackboard::FKey CanAttackKey;
+	FBlackboard::FKey InAttackRangeKey;
+	FBlackboard::FKey StunnedKey;
+	FBlackboard::FKey DeadKey;
+	FBlackboard::FKey PlayerDeadKey;
+
+	/* SetValue calls made and skipped through the typed setters */
+	uint32 NumBlackboardWrites;
+	uint32 NumBlackboardWritesSkipped;
+
+	/* Is the enemy driven by the native brain instead of the behavior tree */
+	bool bUseNativeBrain;
+
+	/* Native brain state, updated by the brain subsystem */
+	FEnemyBrain Brain;
 };
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyHordeSubsystem.generated.h"
+
+class AEnemy;
+
+/* Lightweight enemy simulated without an actor until it is promoted near the player */
+struct FHordeAgent
+{
+	TSubclassOf<AEnemy> EnemyClass;
+	FVector Location = FVector::ZeroVector;
+	float Yaw = 0.f;
+	float Health = 0.f;
+	FVector PatrolPoints[2] = { FVector::ZeroVector, FVector::ZeroVector };
+	int32 PatrolIndex = 0;
+	bool bAggro = false;
+
+	/* Full actor standing in for the agent while promoted */
+	TWeakObjectPtr<AEnemy> Actor;
+	bool bPromoted = false;
+};
+
+/* Simulates distant or idle enemies as plain data with cheap steering and swaps them for full AEnemy actors near the player */
+UCLASS(Config = Game)
+class ARCOROX_API UEnemyHordeSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyHordeSubsystem();
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/* Adds an agent patrolling between two world locations */
+	void AddAgent(TSubclassOf<AEnemy> EnemyClass, const FVector& Location, float Health, const FVector& PatrolPoint, const FVector& PatrolPoint2);
+
+	/* Adds Count agents of EnemyClass, or DefaultEnemyClass when null, scattered within Radius of Center, patrolling short random routes */
+	void SpawnHorde(int32 Count, const FVector& Center, float Radius, TSubclassOf<AEnemy> EnemyClass = nullptr);
+
+	/* Logs agent and promoted actor counts */
+	void LogHordeReport() const;
+
+	FORCEINLINE int32 GetNumAgents() const { return Agents.Num(); }
+	FORCEINLINE int32 GetNumPromoted() const { return NumPromoted; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/* Moves unpromoted agents toward their patrol point, or toward the player when aggroed */
+	void SteerAgents(float DeltaTime, const FVector& PlayerLocation);
+
+	/* Moves an agent onto the navmesh, or onto the floor below it where there is no nav data, keeping its capsule above the ground */
+	void GroundAgent(FHordeAgent& Agent) const;
+
+	/* Swaps agents for actors and back based on distance to the player */
+	void UpdatePromotions(const FVector& PlayerLocation);
+
+	/* Acquires the full actor for an agent from the enemy pool, carrying its state over */
+	bool PromoteAgent(FHordeAgent& Agent);
+
+	/* Copies the actor state back into the agent and returns the actor to the enemy pool */
+	void DemoteAgent(FHordeAgent& Agent);
+
+	/* Enemy class used by SpawnHorde */
+	UPROPERTY(Config)
+	TSoftClassPtr<AEnemy> DefaultEnemyClass;
+
+	/* Agents closer than this to the player become actors */
+	UPROPERTY(Config)
+	float PromoteDistance;
+
+	/* Promoted actors farther than this from the player become agents again */
+	UPROPERTY(Config)
+	float DemoteDistance;
+
+	/* Limits actor spawns per frame to avoid hitches when many agents arrive at once */
+	UPROPERTY(Config)
+	int32 MaxPromotionsPerFrame;
+
+	/* Agent steering speeds in units per second */
+	UPROPERTY(Config)
+	float PatrolSpeed;
+
+	UPROPERTY(Config)
+	float ChaseSpeed;
+
+	/* Agents re-grounded per frame, round robin so the query cost stays flat as the horde grows */
+	UPROPERTY(Config)
+	int32 MaxGroundQueriesPerFrame;
+
+	/* Half height of the vertical range searched for ground around an agent */
+	UPROPERTY(Config)
+	float GroundQueryHeight;
+
+	TArray<FHordeAgent> Agents;
+
+	/* Agent the next ground query starts from */
+	int32 NextGroundAgent;
+
+	int32 NumPromoted;
+};
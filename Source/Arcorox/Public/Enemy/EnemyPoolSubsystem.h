@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyPoolSubsystem.generated.h"
+
+class AEnemy;
+
+/* Deactivated enemies of one class waiting to be reused */
+USTRUCT()
+struct FEnemyPoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AEnemy*> Enemies;
+};
+
+/* Keeps dead enemies deactivated and hands them out again instead of destroying and spawning new actors */
+UCLASS(Config = Game)
+class ARCOROX_API UEnemyPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyPoolSubsystem();
+
+	virtual void Deinitialize() override;
+
+	/* Reuses a pooled enemy of EnemyClass or spawns one if the pool is empty, patrol points are in world space */
+	AEnemy* AcquireEnemy(TSubclassOf<AEnemy> EnemyClass, const FTransform& Transform, float Health, const FVector& PatrolPoint, const FVector& PatrolPoint2);
+
+	/* Deactivates an enemy and keeps it for reuse, destroys it when the pool for its class is full */
+	void ReleaseEnemy(AEnemy* Enemy);
+
+	/* Releases or destroys the last test wave and spawns Count enemies of ClassPath around Center, logging spawn latency */
+	void SpawnTestWave(int32 Count, const FVector& Center, float Radius, bool bPooled, const FString& ClassPath = FString());
+
+	/* Logs pooled enemy counts per class */
+	void LogPoolReport() const;
+
+	FORCEINLINE bool IsPoolingEnabled() const { return bPoolingEnabled; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/* Spawns a new enemy with its state applied before BeginPlay */
+	AEnemy* SpawnEnemy(TSubclassOf<AEnemy> EnemyClass, const FTransform& Transform, float Health, const FVector& PatrolPoint, const FVector& PatrolPoint2);
+
+	/* ClassPath when given, else DefaultEnemyClass, else the class of the first enemy Blueprint placed in the level */
+	TSubclassOf<AEnemy> ResolveTestWaveClass(const FString& ClassPath) const;
+
+	/* Enemy class used by test waves */
+	UPROPERTY(Config)
+	TSoftClassPtr<AEnemy> DefaultEnemyClass;
+
+	/* Released enemies beyond this count per class are destroyed */
+	UPROPERTY(Config)
+	int32 MaxPooledPerClass;
+
+	/* Enemies destroy themselves after death when disabled */
+	UPROPERTY(Config)
+	bool bPoolingEnabled;
+
+	UPROPERTY()
+	TMap<TSubclassOf<AEnemy>, FEnemyPoolBucket> Pools;
+
+	/* Enemies spawned by the last test wave */
+	TArray<TWeakObjectPtr<AEnemy>> TestWave;
+};
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyProximitySubsystem.generated.h"
+
+class AEnemy;
+
+/* Hashes enemies into a 2D grid once per frame and computes aggro and attack range against players in one batched pass */
+UCLASS(Config = Game)
+class ARCOROX_API UEnemyProximitySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemyProximitySubsystem();
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	/* Logs registered and evaluated enemies, grid cells and the last pass time */
+	void LogProximityReport() const;
+
+	/* Calls Func for every live enemy hashed this frame within Radius of Center */
+	template<typename FuncType>
+	void ForEachEnemyInRadius(const FVector& Center, float Radius, FuncType Func) const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	FORCEINLINE FIntPoint GetCell(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+	}
+
+	/* Hashes the player pawns and the registered enemies and fills the per-enemy query inputs */
+	void BuildGrids();
+
+	/* Nearest player overlapping the aggro radius and whether any player overlaps the attack radius of one enemy */
+	void EvaluateEnemy(int32 Index);
+
+	/* Width of one grid cell */
+	UPROPERTY(Config)
+	float CellSize;
+
+	/* Below this many enemies the pass runs on the game thread */
+	UPROPERTY(Config)
+	int32 MinEnemiesForParallel;
+
+	struct FProximityEntry
+	{
+		TWeakObjectPtr<AEnemy> Enemy;
+		bool bInAggroRange;
+		bool bInAttackRange;
+	};
+
+	TArray<FProximityEntry> Entries;
+
+	/* Query inputs and results for this frame, indexed like Entries */
+	TArray<FVector> EnemyLocations;
+	TArray<float> AggroRadii;
+	TArray<float> AttackRadii;
+	TArray<bool> EnemyEvaluated;
+	TArray<int32> AggroPlayers;
+	TArray<bool> AttackResults;
+
+	/* Living player pawns this frame with their collision radius */
+	TArray<AActor*> Players;
+	TArray<FVector> PlayerLocations;
+	TArray<float> PlayerRadii;
+	float MaxPlayerRadius;
+
+	/* Entry indices per cell */
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	/* Player indices per cell */
+	TMap<FIntPoint, TArray<int32>> PlayerCells;
+
+	int32 NumEvaluated;
+	double LastPassMs;
+};
+
+template<typename FuncType>
+void UEnemyProximitySubsystem::ForEachEnemyInRadius(const FVector& Center, float Radius, FuncType Func) const
+{
+	const FIntPoint Min{ GetCell(Center - FVector(Radius)) };
+	const FIntPoint Max{ GetCell(Center + FVector(Radius)) };
+	const float RadiusSquared = Radius * Radius;
+	for (int32 X = Min.X; X <= Max.X; X++)
+	{
+		for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+		{
+			const TArray<int32>* Cell = Cells.Find(FIntPoint(X, Y));
+			if (Cell == nullptr) continue;
+			for (const int32 Index : *Cell)
+			{
+				if (!EnemyLocations.IsValidIndex(Index) || FVector::DistSquared(EnemyLocations[Index], Center) > RadiusSquared) continue;
+				if (AEnemy* Enemy = Entries[Index].Enemy.Get()) Func(Enemy);
+			}
+		}
+	}
+}
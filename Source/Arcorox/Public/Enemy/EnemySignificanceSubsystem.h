@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemySignificanceSubsystem.generated.h"
+
+class AEnemy;
+
+/* Update rates applied to every enemy within a distance band */
+USTRUCT(BlueprintType)
+struct FEnemySignificanceTier
+{
+	GENERATED_BODY()
+
+	/* Enemies closer to the player than this fall in the tier, the last tier catches everything beyond */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MaxDistance = 0.f;
+
+	/* Tick intervals in seconds, 0 ticks every frame */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ActorTickInterval = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float MovementTickInterval = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float BehaviorTreeTickInterval = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float AnimationTickInterval = 0.f;
+
+	/* Should the proximity subsystem evaluate aggro and attack range */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bUpdateProximity = true;
+};
+
+/* Scores enemies by distance, visibility and aggro state and throttles their ticking in discrete tiers */
+UCLASS(Config = Game)
+class ARCOROX_API UEnemySignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UEnemySignificanceSubsystem();
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	/* Logs enemy count and effective animation rate per tier, the animation budget and the current game thread time */
+	void LogTierReport() const;
+
+	FORCEINLINE const TArray<FEnemySignificanceTier>& GetTiers() const { return Tiers; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/* Tier for an enemy at Distance from the player */
+	int32 ScoreEnemy(const AEnemy* Enemy, float Distance) const;
+
+	/* bUseAnimationBudget unless arcorox.Enemy.AnimationBudget overrides it */
+	bool UsesAnimationBudget() const;
+
+	/* Hands the animation budget allocator the significance of an enemy mesh, attacking enemies never skip frames */
+	void UpdateAnimationSignificance(AEnemy* Enemy, float Distance) const;
+
+	/* Tiers ordered from most to least significant */
+	UPROPERTY(Config)
+	TArray<FEnemySignificanceTier> Tiers;
+
+	/* Seconds between significance passes */
+	UPROPERTY(Config)
+	float UpdateInterval;
+
+	/* Drive enemy mesh update rates from the animation budget allocator instead of the tier animation intervals */
+	UPROPERTY(Config)
+	bool bUseAnimationBudget;
+
+	/* Game thread milliseconds per frame the allocator spreads across enemy meshes */
+	UPROPERTY(Config)
+	float AnimationBudgetMs;
+
+	struct FEnemySignificance
+	{
+		TWeakObjectPtr<AEnemy> Enemy;
+		int32 Tier;
+	};
+
+	TArray<FEnemySignificance> Enemies;
+
+	float TimeSinceUpdate;
+};
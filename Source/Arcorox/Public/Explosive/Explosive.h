@@ -17,14 +17,25 @@ class ARCOROX_API AExplosive : public AActor, public IHitInterface
 public:	
 	AExplosive();
 
-	virtual void Tick(float DeltaTime) override;
 	virtual void Hit_Implementation(FHitResult HitResult) override;
 
+	/* Plays the explosion effects and removes the explosive, damage is dealt by the explosion subsystem */
+	void Detonate(const FVector& Location);
+
+	/* Damage at Distance from the blast, full inside DamageInnerRadius and falling off to MinimumDamage at DamageOuterRadius */
+	float GetDamageAtDistance(float Distance) const;
+
+	FORCEINLINE float GetDamageOuterRadius() const { return DamageOuterRadius; }
+	FORCEINLINE float GetImpulseStrength() const { return ImpulseStrength; }
+	FORCEINLINE bool IsDetonationQueued() const { return bDetonationQueued; }
+	FORCEINLINE void SetDetonationQueued(bool bQueued) { bDetonationQueued = bQueued; }
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:	
-	void SpawnExplosionParticles(FHitResult& HitResult);
+	void SpawnExplosionParticles(const FVector& Location);
 	void PlayExplosionSound();
 
 	/* Particles for explosion */
@@ -34,4 +45,30 @@ private:
 	/* Sound for explosion */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	USoundBase* ExplosionSound;
+
+	/* Damage dealt inside DamageInnerRadius */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float BaseDamage;
+
+	/* Damage dealt at DamageOuterRadius */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float MinimumDamage;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float DamageInnerRadius;
+
+	/* Actors and explosives beyond this distance are unaffected */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float DamageOuterRadius;
+
+	/* Exponent of the falloff between the inner and outer radius, 1 is linear */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float DamageFalloff;
+
+	/* Velocity change at the blast center in cm/s, falling off linearly to zero at DamageOuterRadius */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float ImpulseStrength;
+
+	/* Is the explosive waiting in the explosion queue */
+	bool bDetonationQueued;
 };
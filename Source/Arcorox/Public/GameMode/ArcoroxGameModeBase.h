@@ -13,5 +13,7 @@ UCLASS()
 class ARCOROX_API AArcoroxGameModeBase : public AGameModeBase
 {
 	GENERATED_BODY()
-	
+
+public:
+	AArcoroxGameModeBase();
 };
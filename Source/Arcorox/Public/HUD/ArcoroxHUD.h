@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/HUD.h"
+#include "CanvasTypes.h"
+#include "HUD/HealthBarSubsystem.h"
+#include "ArcoroxHUD.generated.h"
+
+class UDamageNumberWidget;
+class UUserWidget;
+
+/* A damage number in the ring buffer, slot i always uses pooled widget i */
+struct FDamageNumberEntry
+{
+	FVector WorldLocation = FVector::ZeroVector;
+	float ExpireTime = 0.f;
+	bool bActive = false;
+};
+
+UCLASS(Config = Game)
+class ARCOROX_API AArcoroxHUD : public AHUD
+{
+	GENERATED_BODY()
+
+public:
+	AArcoroxHUD();
+
+	virtual void DrawHUD() override;
+
+	/* Shows a damage number at a world location, reusing the oldest entry when the pool is full, false when there is no damage number class */
+	bool AddDamageNumber(int32 Damage, const FVector& WorldLocation, bool bHeadshot);
+
+	/* Positions a widget created by an enemy Blueprint with the pooled damage numbers and removes it from its parent after DamageNumberLifetime */
+	void AddDamageNumberWidget(UUserWidget* Widget, const FVector& WorldLocation);
+
+	FORCEINLINE int32 GetNumActiveDamageNumbers() const { return NumActiveDamageNumbers; }
+
+protected:
+	virtual void BeginPlay() override;
+
+	/* Caches the view projection matrix of the owning player for every projection this frame */
+	void UpdateViewProjection();
+
+	/* Positions every active damage number with the cached view projection */
+	void UpdateDamageNumbers();
+
+	/* Draws the health bars of all recently damaged, visible enemies as one batch of triangles */
+	void DrawHealthBars();
+
+	/* Appends the two triangles of a screen space rectangle */
+	void AddHealthBarRect(const FVector2D& Position, const FVector2D& Size, const FLinearColor& Color);
+
+	/* Hides the widget of an entry and frees the slot */
+	void ReleaseDamageNumber(int32 Index);
+
+	/* Moves a damage number widget to its projected world location, collapsing it when off screen */
+	void PositionDamageNumberWidget(UUserWidget* Widget, const FVector& WorldLocation) const;
+
+private:
+	/* Widget Blueprint class for damage numbers */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damage Numbers", meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<UDamageNumberWidget> DamageNumberClass;
+
+	/* Loaded when DamageNumberClass is not set on the HUD, so the native HUD class shows damage numbers too */
+	UPROPERTY(Config)
+	TSoftClassPtr<UDamageNumberWidget> DefaultDamageNumberClass;
+
+	/* Number of damage number widgets created up front */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Damage Numbers", meta = (AllowPrivateAccess = "true"))
+	int32 DamageNumberPoolSize;
+
+	/* How long damage numbers persist on screen */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damage Numbers", meta = (AllowPrivateAccess = "true"))
+	float DamageNumberLifetime;
+
+	/* Preallocated widgets, added to the viewport once and collapsed while unused */
+	UPROPERTY(VisibleAnywhere, Category = "Damage Numbers", meta = (AllowPrivateAccess = "true"))
+	TArray<UDamageNumberWidget*> DamageNumberWidgets;
+
+	/* Ring buffer of entries parallel to DamageNumberWidgets */
+	TArray<FDamageNumberEntry> DamageNumbers;
+
+	/* Slot the next damage number is written to */
+	int32 NextDamageNumber;
+
+	int32 NumActiveDamageNumbers;
+
+	/* Widgets from enemy Blueprints that still create their own damage numbers, expired ones are removed from their parent */
+	UPROPERTY(Transient)
+	TArray<UUserWidget*> BlueprintDamageNumberWidgets;
+
+	/* Entries parallel to BlueprintDamageNumberWidgets */
+	TArray<FDamageNumberEntry> BlueprintDamageNumbers;
+
+	/* Screen size of enemy health bars */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health Bars", meta = (AllowPrivateAccess = "true"))
+	FVector2D HealthBarSize;
+
+	/* Height above the enemy's actor location to draw its health bar */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health Bars", meta = (AllowPrivateAccess = "true"))
+	float HealthBarHeightOffset;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health Bars", meta = (AllowPrivateAccess = "true"))
+	FLinearColor HealthBarColor;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Health Bars", meta = (AllowPrivateAccess = "true"))
+	FLinearColor HealthBarBackgroundColor;
+
+	/* Health bars gathered this frame, reused between frames */
+	TArray<FHealthBarDrawData> HealthBarDrawData;
+
+	/* Triangles for every health bar drawn this frame, reused between frames */
+	TArray<FCanvasUVTri> HealthBarTriangles;
+
+	/* View projection of the owning player cached in DrawHUD */
+	FMatrix ViewProjectionMatrix;
+	FIntRect ViewRect;
+	bool bHasViewProjection;
+};
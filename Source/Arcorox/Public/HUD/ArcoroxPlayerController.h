@@ -17,6 +17,9 @@ public:
 protected:
 	virtual void BeginPlay() override;
 
+	/* Refreshes the pawn's crosshair query once the camera has its final view for the frame */
+	virtual void UpdateCameraManager(float DeltaSeconds) override;
+
 private:
 	/* HUD Overlay Widget Blueprint class */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Widgets, meta = (AllowPrivateAccess = "true"))
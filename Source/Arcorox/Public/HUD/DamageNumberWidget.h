@@ -0,0 +1,19 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "DamageNumberWidget.generated.h"
+
+/* Pooled floating damage number, reused by the HUD for every hit instead of being created per hit */
+UCLASS()
+class ARCOROX_API UDamageNumberWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	/* Called each time the widget is taken from the pool for a new hit */
+	UFUNCTION(BlueprintImplementableEvent)
+	void ShowDamage(int32 Damage, bool bHeadshot);
+};
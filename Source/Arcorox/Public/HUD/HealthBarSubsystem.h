@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HealthBarSubsystem.generated.h"
+
+class AEnemy;
+
+/* World position and health of one bar to draw this frame */
+struct FHealthBarDrawData
+{
+	FVector WorldLocation;
+	float HealthFraction;
+};
+
+/* Tracks recently damaged enemies so the HUD can draw all of their health bars in one pass */
+UCLASS()
+class ARCOROX_API UHealthBarSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/* Shows or extends the health bar of an enemy for DisplayTime seconds */
+	void ShowHealthBar(AEnemy* Enemy, float DisplayTime);
+
+	/* Stops drawing the health bar of an enemy */
+	void HideHealthBar(AEnemy* Enemy);
+
+	/* Drops expired entries and fills OutBars with the bars of enemies rendered recently */
+	void GatherHealthBars(float HeightOffset, TArray<FHealthBarDrawData>& OutBars);
+
+	FORCEINLINE int32 GetNumHealthBars() const { return HealthBars.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FHealthBarEntry
+	{
+		TWeakObjectPtr<AEnemy> Enemy;
+		float HideTime;
+	};
+
+	TArray<FHealthBarEntry> HealthBars;
+};
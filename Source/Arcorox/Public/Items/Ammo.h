@@ -17,10 +17,10 @@ class ARCOROX_API AAmmo : public AItem
 	
 public:
 	AAmmo();
-	virtual void Tick(float DeltaTime);
 
 	virtual void EnableCustomDepth() override;
 	virtual void DisableCustomDepth() override;
+	virtual void ActivateFromPool(const FTransform& Transform) override;
 
 	void DisableAmmoMeshCollision();
 
@@ -9,11 +9,10 @@
 
 class UBoxComponent;
 class UWidgetComponent;
-class USphereComponent;
 class UCurveFloat;
 class UCurveVector;
+class UMaterialInstanceDynamic;
 class AArcoroxCharacter;
-class UDataTable;
 
 UENUM(BlueprintType)
 enum class EItemState : uint8
@@ -48,28 +47,52 @@ enum class EItemType : uint8
 	EIT_MAX UMETA(DisplayName = "DefaultMAX")
 };
 
+/* Pulse played by the item material, stored in custom primitive data */
+UENUM(BlueprintType)
+enum class EItemMaterialPulse : uint8
+{
+	EIMP_None UMETA(DisplayName = "None"),
+	EIMP_Pickup UMETA(DisplayName = "Pickup"),
+	EIMP_EquipInterpolating UMETA(DisplayName = "EquipInterpolating"),
+
+	EIMP_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/* Custom primitive data slots read by the item material in place of dynamic material parameters */
+namespace ItemPrimitiveData
+{
+	constexpr int32 GlowColor = 0; //RGB in slots 0-2
+	constexpr int32 GlowBlendAlpha = 3;
+	constexpr int32 GlowAmount = 4;
+	constexpr int32 FresnelExponent = 5;
+	constexpr int32 FresnelReflectFraction = 6;
+	constexpr int32 PulseType = 7;
+	constexpr int32 PulseStartTime = 8; //World time in seconds, the material pulses from Time - PulseStartTime
+	constexpr int32 PulseDuration = 9;
+}
+
 USTRUCT(BlueprintType)
 struct FItemRarityTable : public FTableRowBase
 {
 	GENERATED_BODY()
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	FLinearColor GlowColor;
+	FLinearColor GlowColor = FLinearColor::White;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	FLinearColor LightColor;
+	FLinearColor LightColor = FLinearColor::White;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	FLinearColor DarkColor;
+	FLinearColor DarkColor = FLinearColor::Black;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	int32 NumStars;
+	int32 NumStars = 0;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* IconBackground;
+	UTexture2D* IconBackground = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	int32 CustomDepthStencil;
+	int32 CustomDepthStencil = 0;
 };
 
 UCLASS()
@@ -79,7 +102,6 @@ class ARCOROX_API AItem : public AActor
 	
 public:	
 	AItem();
-	virtual void Tick(float DeltaTime) override;
 
 	virtual void EnableCustomDepth();
 	virtual void DisableCustomDepth();
@@ -87,7 +109,6 @@ public:
 
 	void ShowPickupWidget();
 	void HidePickupWidget();
-	void DisableSphereCollision();
 	void DisableBoxCollision();
 	void DisableMeshCollision();
 	void SetItemState(EItemState State);
@@ -96,14 +117,52 @@ public:
 	void PlayEquipSound();
 	void ForcePlayEquipSound();
 
-	void InitializeDynamicMaterialInstance();
+	/* Does the item have per-frame work for the item update subsystem */
+	virtual bool NeedsItemUpdate() const;
+
+	/* Per-frame update driven by the item update subsystem */
+	virtual void UpdateItem(float DeltaTime);
+
+	/* Registers with the item update subsystem if the item has per-frame work */
+	void RefreshItemUpdate();
+
+	/* Hides the item and stops its timers, updates and collision while it waits in the pickup pool */
+	virtual void DeactivateForPool();
+
+	/* Places a pooled item at Transform as a fresh pickup, only resetting per-instance state */
+	virtual void ActivateFromPool(const FTransform& Transform);
+
+	/* Suspends component ticking, mesh animation and physics state while the item sits unused in an inventory or the pool */
+	virtual void EnterDormancy();
+
+	/* Restores what EnterDormancy suspended, components stay registered so this is cheap enough to run on equip */
+	virtual void ExitDormancy();
+
+	/* Knocks a dropped item away with a velocity change, it falls and settles back into a pickup */
+	virtual void ApplyBlastImpulse(const FVector& Impulse);
+
+	void InitializeItemMaterial();
 	void EnableGlowMaterial();
 	void DisableGlowMaterial();
 
+	/* Shared rarity data, falls back to row defaults when the table has no row for ItemRarity */
+	const FItemRarityTable& GetRarityArchetype() const;
+
+	/* Rarity values of the item for the pickup widget and inventory */
+	UFUNCTION(BlueprintPure, Category = "Item Rarity")
+	FLinearColor GetGlowColor() const { return GetRarityArchetype().GlowColor; }
+	UFUNCTION(BlueprintPure, Category = "Item Rarity")
+	FLinearColor GetLightColor() const { return GetRarityArchetype().LightColor; }
+	UFUNCTION(BlueprintPure, Category = "Item Rarity")
+	FLinearColor GetDarkColor() const { return GetRarityArchetype().DarkColor; }
+	UFUNCTION(BlueprintPure, Category = "Item Rarity")
+	int32 GetNumStars() const { return GetRarityArchetype().NumStars; }
+	UFUNCTION(BlueprintPure, Category = "Item Rarity")
+	UTexture2D* GetBackgroundIcon() const { return GetRarityArchetype().IconBackground; }
+
 	FORCEINLINE EItemState GetItemState() const { return ItemState; }
 	FORCEINLINE USkeletalMeshComponent* GetItemMesh() const { return ItemMesh; }
 	FORCEINLINE UBoxComponent* GetCollisionBox() const { return CollisionBox; }
-	FORCEINLINE USphereComponent* GetOverlapSphere() const { return OverlapSphere; }
 	FORCEINLINE UWidgetComponent* GetPickupWidget() const { return PickupWidget; }
 	FORCEINLINE USoundBase* GetPickupSound() const { return PickupSound; }
 	FORCEINLINE USoundBase* GetEquipSound() const { return EquipSound; }
@@ -112,6 +171,9 @@ public:
 	FORCEINLINE int32 GetInventorySlotIndex() const { return InventorySlotIndex; }
 	FORCEINLINE UMaterialInstance* GetMaterialInstance() const { return MaterialInstance; }
 	FORCEINLINE int32 GetMaterialIndex() const { return MaterialIndex; }
+	FORCEINLINE int32 GetItemUpdateIndex() const { return ItemUpdateIndex; }
+	FORCEINLINE bool IsInPool() const { return bInPool; }
+	FORCEINLINE bool IsDormant() const { return bDormant; }
 	FORCEINLINE void SetItemType(EItemType Type) { ItemType = Type; }
 	FORCEINLINE void SetInventorySlotIndex(int32 Index) { InventorySlotIndex = Index; }
 	FORCEINLINE void SetArcoroxCharacter(AArcoroxCharacter* Character) { ArcoroxCharacter = Character; }
@@ -123,10 +185,13 @@ public:
 	FORCEINLINE void SetAmmoIcon(UTexture2D* Icon) { AmmoIcon = Icon; }
 	FORCEINLINE void SetMaterialInstance(UMaterialInstance* MatInst) { MaterialInstance = MatInst; }
 	FORCEINLINE void SetMaterialIndex(int32 Index) { MaterialIndex = Index; }
+	FORCEINLINE void SetItemUpdateIndex(int32 Index) { ItemUpdateIndex = Index; }
 
 protected:
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void OnConstruction(const FTransform& Transform) override;
 
 	void GetItemRarityDataTableInfo();
@@ -143,25 +208,26 @@ protected:
 	/* Callback for end of ItemInterpolationTimer */
 	void FinishInterpolating();
 
+	/* Callback for end of BlastSettleTimer, a blasted item becomes a pickup where it landed */
+	void FinishBlastFall();
+
 	/* Get interpolation location based on item type and interp location index */
 	FVector GetInterpLocation();
 
-	/* Updates dynamic material instance parameters based on pulse vector curve */
-	void UpdateMaterialPulse();
+	/* Starts the looping pickup pulse in the material */
+	void StartMaterialPulse();
 
-	/* Starts the Material Pulse Timer */
-	void StartMaterialPulseTimer();
+	/* Writes the pulse mode and start time read by the material to animate the pulse from world time */
+	void SetMaterialPulse(EItemMaterialPulse Pulse, float Duration);
 
-	/* Callback for Material Pulse Timer */
-	void ResetMaterialPulseTimer();
+	/* Does the dynamic material instance have a pulse to animate this frame */
+	bool NeedsDynamicMaterialPulse() const;
 
-	/* Callback for Sphere Component OnComponentBeginOverlap */
-	UFUNCTION()
-	void OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+	/* Writes the pulse curve values to the dynamic material instance of items whose material reads named parameters */
+	void UpdateDynamicMaterialPulse();
 
-	/* Callback for Sphere Component OnComponentEndOverlap */
-	UFUNCTION()
-	void OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+	/* Adds or removes the item from the world's loot index based on ItemState */
+	void UpdateLootIndex(EItemState State);
 
 private:
 	/* Item Skeletal Mesh */
@@ -176,10 +242,6 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	UWidgetComponent* PickupWidget;
 
-	/* Sphere component for overlap events */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
-	USphereComponent* OverlapSphere;
-
 	/* Item Name on pickup widget */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	FString ItemName;
@@ -244,14 +306,18 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	int32 MaterialIndex;
 
-	/* Dynamic material instance to change at runtime */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
-	UMaterialInstanceDynamic* DynamicMaterialInstance;
-
-	/* Material instance to be used with dynamic material instance */
+	/* Material instance shared by every item using it, per-item values go through custom primitive data */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	UMaterialInstance* MaterialInstance;
 
+	/* Does MaterialInstance read glow and pulse from custom primitive data, otherwise a dynamic material instance gets the named parameters. Off for every item until the item material reads the ItemPrimitiveData slots */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	bool bMaterialUsesPrimitiveData;
+
+	/* Per-item material instance, only created while MaterialInstance reads named parameters */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
+	UMaterialInstanceDynamic* DynamicMaterialInstance;
+
 	/* Vector curve to manipulate dynamic material parameters */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	UCurveVector* MaterialPulseCurve;
@@ -260,7 +326,7 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	UCurveVector* MaterialPulseInterpCurve;
 
-	/* Duration of material pulse timer */
+	/* Duration of one loop of the pickup pulse */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item Properties", meta = (AllowPrivateAccess = "true"))
 	float MaterialPulseCurveTime;
 
@@ -292,33 +358,25 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
 	bool bCharacterInventoryFull;
 
-	/* Item Rarity Data Table */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
-	UDataTable* ItemRarityDataTable;
+	/* Shared row of the item rarity data table, owned by the combat data registry */
+	const FItemRarityTable* RarityArchetype;
 
-	/* Color of material glow */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Rarity", meta = (AllowPrivateAccess = "true"))
+	/* Rarity values under the names pickup and inventory widgets bind to, Blueprints read them through the registry getters, never set natively */
+	UPROPERTY(Transient, BlueprintGetter = GetGlowColor, Category = "Item Rarity", meta = (AllowPrivateAccess = "true"))
 	FLinearColor GlowColor;
 
-	/* Light color of pickup widget */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Rarity", meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(Transient, BlueprintGetter = GetLightColor, Category = "Item Rarity", meta = (AllowPrivateAccess = "true"))
 	FLinearColor LightColor;
 
-	/* Dark color of pickup widget */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Rarity", meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(Transient, BlueprintGetter = GetDarkColor, Category = "Item Rarity", meta = (AllowPrivateAccess = "true"))
 	FLinearColor DarkColor;
 
-	/* Amount of stars on pickup widget */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Rarity", meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(Transient, BlueprintGetter = GetNumStars, Category = "Item Rarity", meta = (AllowPrivateAccess = "true"))
 	int32 NumStars;
 
-	/* Background icon image in the inventory and pickup widget */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Rarity", meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(Transient, BlueprintGetter = GetBackgroundIcon, Category = "Item Rarity", meta = (AllowPrivateAccess = "true"))
 	UTexture2D* BackgroundIcon;
 
-	/* Timer for dynamic material pulse curve */
-	FTimerHandle MaterialPulseTimer;
-
 	/* For interpolating item in X and Y directions */
 	float ItemInterpX;
 	float ItemInterpY;
@@ -326,10 +384,33 @@ private:
 	/* Timer for item interpolation */
 	FTimerHandle ItemInterpolationTimer;
 
+	/* Timer for a blasted item falling before it settles */
+	FTimerHandle BlastSettleTimer;
+
+	/* Seconds a blasted item falls before it settles */
+	float BlastSettleTime;
+
 	/* Initial offset of Yaw between Item and Camera */
 	float InterpInitialYawOffset;
 
 	/* To enable and disable outline effect while interpolating */
 	bool bCanChangeCustomDepth;
 
+	/* Index in the item update subsystem's active array, INDEX_NONE when idle */
+	int32 ItemUpdateIndex;
+
+	/* Is the item deactivated in the pickup pool */
+	bool bInPool;
+
+	/* Are ticking, animation and physics state suspended */
+	bool bDormant;
+
+	/* Pulse, world time it started and its duration, the dynamic material instance evaluates its curves from these */
+	EItemMaterialPulse MaterialPulse;
+	float MaterialPulseStartTime;
+	float MaterialPulseDuration;
+
+	/* Components whose tick EnterDormancy disabled, only these are re-enabled */
+	TArray<TWeakObjectPtr<UActorComponent>, TInlineAllocator<4>> DormantTickComponents;
+
 };
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemUpdateSubsystem.generated.h"
+
+class AItem;
+
+/* Updates every item with per-frame work in one pass so items never need their own actor tick */
+UCLASS()
+class ARCOROX_API UItemUpdateSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/* Adds an item to the active array if it is not already in it */
+	void RegisterItem(AItem* Item);
+
+	/* Removes an item from the active array if it is in it */
+	void UnregisterItem(AItem* Item);
+
+	FORCEINLINE int32 GetNumActiveItems() const { return ActiveItems.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/* Swap removes the item at Index and keeps stored indices in sync */
+	void RemoveActiveItemAt(int32 Index);
+
+	/* Items currently animating, each item stores its own index into this array */
+	UPROPERTY()
+	TArray<AItem*> ActiveItems;
+};
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LootIndexSubsystem.generated.h"
+
+class AItem;
+
+/* Uniform grid of items lying in the world in the Pickup state, used for proximity and focus queries */
+UCLASS()
+class ARCOROX_API ULootIndexSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/* Adds an item at its current location, or moves it if already indexed */
+	void AddItem(AItem* Item);
+
+	/* Removes an item from the index if present */
+	void RemoveItem(AItem* Item);
+
+	/* Visible item within Radius of Center closest to the view ray, inside a cone of ConeHalfAngle degrees. Viewer is ignored by the visibility trace */
+	AItem* FindFocusItem(const FVector& Center, float Radius, const FVector& ViewOrigin, const FVector& ViewDirection, float ConeHalfAngle, const AActor* Viewer = nullptr) const;
+
+	FORCEINLINE int32 GetNumItems() const { return ItemCells.Num(); }
+
+private:
+	struct FLootEntry
+	{
+		AItem* Item;
+		FVector Location;
+	};
+
+	/* Grid cell containing Location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/* Calls Func for every indexed entry within Radius of Center */
+	template<typename FuncType>
+	void ForEachEntryInRadius(const FVector& Center, float Radius, FuncType Func) const;
+
+	/* Entries bucketed by grid cell */
+	TMap<FIntPoint, TArray<FLootEntry>> Cells;
+
+	/* Cell each indexed item was added to */
+	TMap<AItem*, FIntPoint> ItemCells;
+
+	/* Edge length of a grid cell */
+	float CellSize = 500.f;
+
+	/* Candidates closest to the view ray checked for line of sight before giving up on focus */
+	int32 MaxFocusVisibilityTraces = 3;
+};
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PickupPoolSubsystem.generated.h"
+
+class AItem;
+
+/* Deactivated pickups of one item class waiting to be reused */
+USTRUCT()
+struct FPickupPoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AItem*> Items;
+};
+
+/* Recycles ammo and weapon pickups by class and caps the number of dropped pickups lying in the world */
+UCLASS(Config = Game)
+class ARCOROX_API UPickupPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPickupPoolSubsystem();
+
+	virtual void Deinitialize() override;
+
+	/* Reuses a pooled pickup of ItemClass or spawns one, the pickup is tracked against the live cap */
+	AItem* AcquirePickup(TSubclassOf<AItem> ItemClass, const FTransform& Transform);
+
+	/* Deactivates a pickup and keeps it for reuse, destroys it only when the pool of its class is full */
+	void ReleasePickup(AItem* Item);
+
+	/* Counts a dropped pickup against the live cap, releasing the oldest untouched pickups when over it */
+	void TrackLivePickup(AItem* Item);
+
+	/* Logs live and pooled pickup counts */
+	void LogPoolReport() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/* Drops tracked pickups that were picked up or destroyed, then releases the oldest until under the cap */
+	void EnforceLiveCap();
+
+	/* Dropped pickups lying in the world beyond this count are returned to the pool, oldest first */
+	UPROPERTY(Config)
+	int32 MaxLivePickups;
+
+	/* Released pickups beyond this count per class are destroyed */
+	UPROPERTY(Config)
+	int32 MaxPooledPerClass;
+
+	UPROPERTY()
+	TMap<TSubclassOf<AItem>, FPickupPoolBucket> Pools;
+
+	/* Dropped and spawned pickups in the order they entered the world */
+	TArray<TWeakObjectPtr<AItem>> LivePickups;
+};
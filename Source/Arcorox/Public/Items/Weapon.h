@@ -6,10 +6,12 @@
 #include "Items/Item.h"
 #include "Items/AmmoType.h"
 #include "Items/WeaponType.h"
+#include "Combat/HitZone.h"
 #include "Engine/DataTable.h"
 #include "Weapon.generated.h"
 
 class UParticleSystem;
+class UStaticMesh;
 
 USTRUCT(BlueprintType)
 struct FWeaponTypeTable : public FTableRowBase
@@ -17,82 +19,120 @@ struct FWeaponTypeTable : public FTableRowBase
 	GENERATED_BODY()
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	EAmmoType AmmoType;
+	EAmmoType AmmoType = EAmmoType::EAT_9mm;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	int32 AmmoCount;
+	int32 AmmoCount = 30;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	int32 MagazineCapacity;
+	int32 MagazineCapacity = 30;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USoundBase* PickupSound;
+	USoundBase* PickupSound = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USoundBase* EquipSound;
+	USoundBase* EquipSound = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USkeletalMesh* WeaponMesh;
+	USkeletalMesh* WeaponMesh = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FString WeaponName;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* InventoryIcon;
+	UTexture2D* InventoryIcon = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* AmmoIcon;
+	UTexture2D* AmmoIcon = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UMaterialInstance* MaterialInstance;
+	UMaterialInstance* MaterialInstance = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	int32 MaterialIndex;
+	int32 MaterialIndex = 0;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	FName ClipBoneName;
+	FName ClipBoneName = FName(TEXT("smg_clip"));
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	FName ReloadMontageSection;
+	FName ReloadMontageSection = FName(TEXT("Reload SMG"));
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	TSubclassOf<UAnimInstance> AnimationBlueprint;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* TopCrosshair;
+	UTexture2D* TopCrosshair = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* BottomCrosshair;
+	UTexture2D* BottomCrosshair = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* MidCrosshair;
+	UTexture2D* MidCrosshair = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* LeftCrosshair;
+	UTexture2D* LeftCrosshair = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UTexture2D* RightCrosshair;
+	UTexture2D* RightCrosshair = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	float FireRate;
+	float FireRate = 0.1f;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	UParticleSystem* MuzzleFlash;
+	UParticleSystem* MuzzleFlash = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	USoundBase* FireSound;
+	USoundBase* FireSound = nullptr;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	FName BoneToHide;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	bool bAutomaticWeapon;
+	bool bAutomaticWeapon = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Damage = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float HeadshotMultiplier = 1.f;
+
+	/* Weapon multiplier for arm and leg hits */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float LimbMultiplier = 1.f;
 
+	/* Fire simulated projectiles with travel time, gravity and drag instead of instant hitscan traces */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	float Damage;
+	bool bProjectile = false;
 
+	/* Muzzle speed of projectiles in cm/s */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	float HeadshotMultiplier;
+	float ProjectileSpeed = 40000.f;
+
+	/* Multiplier of world gravity on projectiles */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ProjectileGravityScale = 1.f;
+
+	/* Quadratic drag of projectiles, deceleration is ProjectileDrag times speed squared */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ProjectileDrag = 0.f;
+
+	/* Seconds before a projectile that hit nothing is removed */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float ProjectileLifetime = 3.f;
+
+	/* Mesh drawn at each projectile in flight, facing along its velocity, none draws nothing until impact */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UStaticMesh* ProjectileMesh = nullptr;
+
+	/* Weapon multipliers of every hit zone, torso hits deal base damage */
+	FHitZoneMultipliers GetHitZoneMultipliers() const
+	{
+		FHitZoneMultipliers ZoneMultipliers;
+		ZoneMultipliers.Set(EHitZone::EHZ_Head, HeadshotMultiplier);
+		ZoneMultipliers.Set(EHitZone::EHZ_Arms, LimbMultiplier);
+		ZoneMultipliers.Set(EHitZone::EHZ_Legs, LimbMultiplier);
+		return ZoneMultipliers;
+	}
 };
 
 UCLASS()
@@ -102,11 +142,21 @@ class ARCOROX_API AWeapon : public AItem
 	
 public:
 	AWeapon();
-	virtual void Tick(float DeltaTime) override;
+
+	/* Overrides of AItem per-frame update for falling rotation and pistol slide */
+	virtual bool NeedsItemUpdate() const override;
+	virtual void UpdateItem(float DeltaTime) override;
+
+	/* Overrides of AItem pool hooks resetting ammo and firing state */
+	virtual void DeactivateForPool() override;
+	virtual void ActivateFromPool(const FTransform& Transform) override;
 
 	/* Adds impulse force to weapon */
 	void ThrowWeapon();
 
+	/* Override of AItem blast impulse, a blasted weapon settles back into a pickup like a thrown weapon */
+	virtual void ApplyBlastImpulse(const FVector& Impulse) override;
+
 	/* Decrements ammo for the weapon */
 	void DecrementAmmo();
 
@@ -119,18 +169,35 @@ public:
 	/* Starts the timer for displacing the pistol slide */
 	void StartPistolSlideTimer();
 
+	/* Shared weapon type data, falls back to row defaults when the table has no row for WeaponType */
+	const FWeaponTypeTable& GetWeaponArchetype() const;
+
+	/* Crosshair textures of the weapon type */
+	UFUNCTION(BlueprintPure, Category = "Weapon Properties")
+	UTexture2D* GetTopCrosshair() const { return GetWeaponArchetype().TopCrosshair; }
+	UFUNCTION(BlueprintPure, Category = "Weapon Properties")
+	UTexture2D* GetBottomCrosshair() const { return GetWeaponArchetype().BottomCrosshair; }
+	UFUNCTION(BlueprintPure, Category = "Weapon Properties")
+	UTexture2D* GetMidCrosshair() const { return GetWeaponArchetype().MidCrosshair; }
+	UFUNCTION(BlueprintPure, Category = "Weapon Properties")
+	UTexture2D* GetLeftCrosshair() const { return GetWeaponArchetype().LeftCrosshair; }
+	UFUNCTION(BlueprintPure, Category = "Weapon Properties")
+	UTexture2D* GetRightCrosshair() const { return GetWeaponArchetype().RightCrosshair; }
+
 	FORCEINLINE int32 GetAmmo() const { return Ammo; }
-	FORCEINLINE int32 GetMagazineCapacity() const { return MagazineCapacity; }
+	FORCEINLINE int32 GetMagazineCapacity() const { return GetWeaponArchetype().MagazineCapacity; }
 	FORCEINLINE EWeaponType GetWeaponType() const { return WeaponType; }
-	FORCEINLINE EAmmoType GetAmmoType() const { return AmmoType; }
-	FORCEINLINE FName GetReloadMontageSection() const { return ReloadMontageSection; }
-	FORCEINLINE FName GetClipBoneName() const { return ClipBoneName; }
-	FORCEINLINE float GetFireRate() const { return FireRate; }
-	FORCEINLINE UParticleSystem* GetMuzzleFlash() const { return MuzzleFlash; }
-	FORCEINLINE USoundBase* GetFireSound() const { return FireSound; }
-	FORCEINLINE bool IsWeaponAutomatic() const { return bAutomaticWeapon; }
-	FORCEINLINE float GetDamage() const { return Damage; }
-	FORCEINLINE float GetHeadshotMultiplier() const { return HeadshotMultiplier; }
+	FORCEINLINE EAmmoType GetAmmoType() const { return GetWeaponArchetype().AmmoType; }
+	FORCEINLINE FName GetReloadMontageSection() const { return GetWeaponArchetype().ReloadMontageSection; }
+	FORCEINLINE FName GetClipBoneName() const { return GetWeaponArchetype().ClipBoneName; }
+	FORCEINLINE float GetFireRate() const { return GetWeaponArchetype().FireRate; }
+	FORCEINLINE UParticleSystem* GetMuzzleFlash() const { return GetWeaponArchetype().MuzzleFlash; }
+	FORCEINLINE USoundBase* GetFireSound() const { return GetWeaponArchetype().FireSound; }
+	FORCEINLINE bool IsWeaponAutomatic() const { return GetWeaponArchetype().bAutomaticWeapon; }
+	FORCEINLINE float GetDamage() const { return GetWeaponArchetype().Damage; }
+	FORCEINLINE float GetHeadshotMultiplier() const { return GetWeaponArchetype().HeadshotMultiplier; }
+	FORCEINLINE FHitZoneMultipliers GetHitZoneMultipliers() const { return GetWeaponArchetype().GetHitZoneMultipliers(); }
+	FORCEINLINE bool FiresProjectiles() const { return GetWeaponArchetype().bProjectile; }
 	FORCEINLINE void SetMovingClip(bool Moving) { bMovingClip = Moving; }
 
 protected:
@@ -140,7 +207,8 @@ protected:
 
 	void GetWeaponTypeDataTableInfo();
 
-	void SetDataTableProperties(FWeaponTypeTable* WeaponTypeRow);
+	/* Applies the per-instance parts of the weapon type row, everything else is read from the archetype */
+	void SetDataTableProperties(const FWeaponTypeTable* WeaponTypeRow);
 
 	void StopFalling();
 
@@ -153,79 +221,33 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	int32 Ammo;
 
-	/* Weapon magazine size */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
-	int32 MagazineCapacity;
-
 	/* Specific type of weapon */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	EWeaponType WeaponType;
 	
-	/* Type of ammo corresponding to weapon type */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
-	EAmmoType AmmoType;
-
-	/* Damage value when actor is hit by bullet from this weapon */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
-	float Damage;
-
-	/* Value to scale damage by when weapon shoots an actor in the head */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
-	float HeadshotMultiplier;
-
-	/* Name of animation montage section to play for the character based on the specific weapon type */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
-	FName ReloadMontageSection;
-
-	/* Name of gun clip bone of the weapon mesh */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
-	FName ClipBoneName;
-
 	/* Is character moving the clip(magazine) (reloading) */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
 	bool bMovingClip;
 
-	/* Is the weapon automatic or semi-automatic/burst fire */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
-	bool bAutomaticWeapon;
-
-	/* Weapon type Data Table */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
-	UDataTable* WeaponTypeDataTable;
-
-	/* Textures for weapon crosshairs */
+	/* Shared row of the weapon type data table, owned by the combat data registry */
+	const FWeaponTypeTable* WeaponArchetype;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
+	/* Crosshair textures under the names the crosshair widgets bind to, Blueprints read them through the registry getters, never set natively */
+	UPROPERTY(Transient, BlueprintGetter = GetTopCrosshair, Category = DataTable, meta = (AllowPrivateAccess = "true"))
 	UTexture2D* TopCrosshair;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(Transient, BlueprintGetter = GetBottomCrosshair, Category = DataTable, meta = (AllowPrivateAccess = "true"))
 	UTexture2D* BottomCrosshair;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(Transient, BlueprintGetter = GetMidCrosshair, Category = DataTable, meta = (AllowPrivateAccess = "true"))
 	UTexture2D* MidCrosshair;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(Transient, BlueprintGetter = GetLeftCrosshair, Category = DataTable, meta = (AllowPrivateAccess = "true"))
 	UTexture2D* LeftCrosshair;
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
+	UPROPERTY(Transient, BlueprintGetter = GetRightCrosshair, Category = DataTable, meta = (AllowPrivateAccess = "true"))
 	UTexture2D* RightCrosshair;
 
-	/* Automatic fire rate for weapon */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
-	float FireRate;
-
-	/* Particle system for muzzle flash of weapon */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
-	UParticleSystem* MuzzleFlash;
-
-	/* Sound for weapon fire */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
-	USoundBase* FireSound;
-
-	/* Bone to hide on SMG weapon skeletal mesh (for SMG & pistol) */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = DataTable, meta = (AllowPrivateAccess = "true"))
-	FName BoneToHide;
-
 	/* Displacement of pistol slide while firing */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Pistol, meta = (AllowPrivateAccess = "true"))
 	float PistolSlideDisplacement;